@@ -0,0 +1,369 @@
+#include <Include/GlobalConfig.hpp>
+#include <Minecraft/Internet/MinecraftServer/MinecraftServer.hpp>
+#include <Minecraft/World/Chunk/ChunkPool.hpp>
+#include <Minecraft/World/Chunk/RenderableChunk.hpp>
+#include <Minecraft/World/Chunk/WorldChunk.hpp>
+#include <Minecraft/World/MinecraftWorld.hpp>
+#include <Utility/String/ParseNumber.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ *
+ * Micro benchmark of RenderableChunk::GenerateGreedyMesh against the per voxel mask sweeping mesher it replaced
+ *
+ * Terrain is generated headless, copied into standalone renderable chunks with neighbors linked,
+ * then every inner chunk is meshed by both and checked to be the same quad for quad
+ *
+ * */
+
+namespace
+{
+
+struct BenchmarkOption {
+    int32_t     regionSize = 8;
+    uint64_t    seed       = 20220523;
+    int32_t     iterations = 10;
+    std::string config     = "config.ini";
+};
+
+bool
+ParseOption( int argc, char** argv, BenchmarkOption& option )
+{
+    for ( int i = 1; i < argc; ++i )
+    {
+        const std::string argument = argv[ i ];
+        if ( i + 1 >= argc ) return false;
+
+        if ( argument == "--size" )
+        {
+            if ( !ParseNumber( argv[ ++i ], option.regionSize ) ) return false;
+        } else if ( argument == "--seed" )
+        {
+            if ( !ParseNumber( argv[ ++i ], option.seed ) ) return false;
+        } else if ( argument == "--iterations" )
+        {
+            if ( !ParseNumber( argv[ ++i ], option.iterations ) ) return false;
+        } else if ( argument == "--config" )
+            option.config = argv[ ++i ];
+        else
+            return false;
+    }
+
+    // Need at least one chunk with all neighbors
+    return option.regionSize >= 3 && option.iterations > 0;
+}
+
+/*
+ *
+ * Renderable chunk without block textures, texture id is derived from block id and face direction
+ *
+ * */
+class BenchmarkChunk : public RenderableChunk
+{
+    // Whole chunk, built once and shared by both meshers
+    std::unique_ptr<uint32_t[]>           m_NeighborTransparency;
+    std::unique_ptr<CubeVertexMetaData[]> m_VertexMetaData;
+
+public:
+    using RenderableChunk::RenderableChunk;
+
+    // Neighbors may be destroyed first, nothing to notify
+    ~BenchmarkChunk( ) { m_NearChunks.fill( nullptr ); }
+
+    void CopyBlocks( const Chunk& chunk )
+    {
+        auto blocks = std::make_unique<Block[]>( ChunkVolume );
+        for ( uint32_t i = 0; i < ChunkVolume; ++i )
+            blocks[ i ] = chunk.At( i );
+
+        SetCoordinate( chunk.GetChunkCoordinate( ) );
+        LoadBlocks( blocks.get( ) );
+    }
+
+    void LinkNeighbor( int direction, BenchmarkChunk* chunk )
+    {
+        m_NearChunks[ direction ] = chunk;
+        m_EmptySlot &= ~( 1 << direction );
+    }
+
+    // Same as FillSectionMeshData over every section, without the block texture lookup
+    void BuildMeshData( )
+    {
+        m_NeighborTransparency = std::make_unique<uint32_t[]>( ChunkVolume );
+        m_VertexMetaData       = std::make_unique<CubeVertexMetaData[]>( ChunkVolume );
+
+        for ( uint32_t i = 0; i < ChunkVolume; ++i )
+        {
+            m_NeighborTransparency[ i ] = ComputeNeighborTransparency( i );
+
+            UpdateAmbientOcclusion( m_VertexMetaData[ i ], m_NeighborTransparency[ i ] );
+            for ( int dir = 0; dir < CubeDirection::DirSize; ++dir )
+                m_VertexMetaData[ i ].faceVertexMetaData[ dir ].SetTextureID( static_cast<FaceVertexMetaData::TextureIDTy>( static_cast<BlockID>( At( i ) ) * CubeDirection::DirSize + dir ) );
+        }
+    }
+
+    std::vector<GreedyMeshFace> GenerateGreedyMesh( )
+    {
+        return RenderableChunk::GenerateGreedyMesh( m_NeighborTransparency.get( ), m_VertexMetaData.get( ) );
+    }
+
+    inline auto        GetNeighborTransparency( uint32_t index ) const { return m_NeighborTransparency[ index ]; }
+    inline const auto& GetCubeVertexMetaData( uint32_t index ) const { return m_VertexMetaData[ index ]; }
+};
+
+/*
+ *
+ * The mesher before the binary one, from https://github.com/roboleary/GreedyMesh/blob/master/src/mygame/Main.java
+ * emit to a flat list in the order faces are found instead of grouping them by meta data
+ *
+ * */
+std::vector<GreedyMeshFace>
+GenerateReferenceGreedyMesh( const BenchmarkChunk& chunk )
+{
+    static constexpr std::array<int, 3> dims { SectionUnitLength, ChunkMaxHeight, SectionUnitLength };
+
+    std::vector<GreedyMeshFace> faces;
+
+    int        i, j, k, l, w, h, u, v, n, side = 0;
+    glm::ivec3 x { 0, 0, 0 };
+    glm::ivec3 q { 0, 0, 0 };
+    glm::ivec3 du { 0, 0, 0 };
+    glm::ivec3 dv { 0, 0, 0 };
+
+    static constexpr auto                 EmptyTexture = FaceVertexMetaData::GetMaxTextureIDSupported( );
+    static constexpr FaceVertexMetaData   emptyFace { .textureID_quadFlipped = EmptyTexture };
+    std::unique_ptr<FaceVertexMetaData[]> mask = std::make_unique<FaceVertexMetaData[]>( SectionUnitLength * ChunkMaxHeight );
+
+    for ( bool backFace = true, b = false; b != backFace; backFace = backFace && b, b = !b )
+    {
+        for ( int d = 0; d < 3; d++ )
+        {
+            u = ( d + 1 ) % 3;
+            v = ( d + 2 ) % 3;
+
+            x      = { 0, 0, 0 };
+            q      = { 0, 0, 0 };
+            q[ d ] = 1;
+
+            if ( d == 0 )
+                side = backFace ? DirBack : DirFront;
+            else if ( d == 1 )
+                side = backFace ? DirDown : DirUp;
+            else
+                side = backFace ? DirLeft : DirRight;
+
+            for ( x[ d ] = -1; x[ d ] < dims[ d ]; )
+            {
+                n = 0;
+                for ( x[ v ] = 0; x[ v ] < dims[ v ]; x[ v ]++ )
+                    for ( x[ u ] = 0; x[ u ] < dims[ u ]; x[ u ]++ )
+                    {
+                        const auto block1 = Chunk::GetBlockIndex( MakeMinecraftCoordinate( x[ 0 ], x[ 1 ], x[ 2 ] ) );
+                        const auto block2 = Chunk::GetBlockIndex( MakeMinecraftCoordinate( x[ 0 ] + q[ 0 ], x[ 1 ] + q[ 1 ], x[ 2 ] + q[ 2 ] ) );
+
+                        const bool face1Visible = x[ d ] >= 0 && chunk.GetNeighborTransparency( block1 ) & ( 1 << side );
+                        const bool face2Visible = x[ d ] < dims[ d ] - 1 && chunk.GetNeighborTransparency( block2 ) & ( 1 << side );
+
+                        if ( !backFace && face1Visible )
+                            mask[ n++ ] = chunk.GetCubeVertexMetaData( block1 ).faceVertexMetaData[ side ];
+                        else if ( backFace && face2Visible )
+                            mask[ n++ ] = chunk.GetCubeVertexMetaData( block2 ).faceVertexMetaData[ side ];
+                        else
+                            mask[ n++ ] = emptyFace;
+                    }
+
+                x[ d ]++;
+
+                n = 0;
+                for ( j = 0; j < dims[ v ]; j++ )
+                    for ( i = 0; i < dims[ u ]; )
+                    {
+                        if ( mask[ n ].GetTextureID( ) == emptyFace.GetTextureID( ) )
+                        {
+                            i++;
+                            n++;
+                            continue;
+                        }
+
+                        for ( w = 1; i + w < dims[ u ] && mask[ n + w ].GetTextureID( ) != EmptyTexture && mask[ n + w ] == mask[ n ]; w++ ) { }
+
+                        for ( h = 1; j + h < dims[ v ]; h++ )
+                        {
+                            for ( k = 0; k < w; k++ )
+                                if ( mask[ n + k + h * dims[ u ] ].GetTextureID( ) == EmptyTexture || mask[ n + k + h * dims[ u ] ] != mask[ n ] ) break;
+                            if ( k < w ) break;
+                        }
+
+                        x[ u ] = i;
+                        x[ v ] = j;
+
+                        du      = { 0, 0, 0 };
+                        du[ u ] = w;
+                        dv      = { 0, 0, 0 };
+                        dv[ v ] = h;
+
+                        glm::ivec3 offset = x;
+                        if ( !backFace ) offset[ d ] -= 1;
+
+                        glm::ivec3 scale = du + dv;
+                        scale[ d ]       = 1;
+
+                        glm::ivec2 textureScale { w, h };
+                        if ( d == 0 ) std::swap( textureScale[ 0 ], textureScale[ 1 ] );
+
+                        faces.emplace_back( offset, scale, textureScale, mask[ n ], static_cast<CubeDirection>( side ) );
+
+                        for ( l = 0; l < h; ++l )
+                            for ( k = 0; k < w; ++k )
+                                mask[ n + k + l * dims[ u ] ].SetTextureID( EmptyTexture );
+
+                        i += w;
+                        n += w;
+                    }
+            }
+        }
+    }
+
+    return faces;
+}
+
+template <typename Fn>
+double
+MeasureSeconds( Fn&& function )
+{
+    const auto startTime = std::chrono::steady_clock::now( );
+    function( );
+    return std::chrono::duration<double>( std::chrono::steady_clock::now( ) - startTime ).count( );
+}
+
+}   // namespace
+
+int
+main( int argc, char** argv )
+{
+    BenchmarkOption option;
+    if ( !ParseOption( argc, argv, option ) )
+    {
+        std::cerr << "Usage: " << argv[ 0 ] << " [--size N (>= 3)] [--seed S] [--iterations I] [--config PATH]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if ( !GlobalConfig::LoadFromFile( option.config ) )
+        std::cerr << "Unable to load " << option.config << ", using default settings" << std::endl;
+
+    auto& chunkConfig = GlobalConfig::getMinecraftConfigData( )[ "chunk" ];
+
+    // Every chunk in region must be inside the loading range of the origin
+    chunkConfig[ "chunk_loading_range" ] = option.regionSize / 2;
+    if ( !chunkConfig.contains( "loading_thread" ) )
+        chunkConfig[ "loading_thread" ] = std::max( std::thread::hardware_concurrency( ), 1U );
+
+    GlobalConfig::getMinecraftConfigData( )[ "seed" ] = option.seed;
+
+    MinecraftServer server;
+    server.InitWorld( );
+
+    auto& world = server.GetWorld( );
+    world.GetChunkPool( ).SetRenderBufferEnabled( false );
+
+    /*
+     *
+     * Generate terrain
+     *
+     * */
+    const int32_t regionBegin = -option.regionSize / 2;
+    const auto    regionIndex = [ & ]( int32_t x, int32_t z ) { return x * option.regionSize + z; };
+
+    world.GetChunkPool( ).SetCentre( MakeMinecraftChunkCoordinate( 0, 0 ) );
+    for ( int32_t x = 0; x < option.regionSize; ++x )
+        for ( int32_t z = 0; z < option.regionSize; ++z )
+            world.IntroduceChunk( MakeMinecraftChunkCoordinate( regionBegin + x, regionBegin + z ), ChunkStatus::eFull );
+
+    const uint64_t totalChunk = static_cast<uint64_t>( option.regionSize ) * option.regionSize;
+    while ( WorldChunk::Statistics.completed[ eFull ].load( ) < totalChunk )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+
+    world.StopChunkGeneration( );
+
+    std::vector<std::unique_ptr<BenchmarkChunk>> chunks( totalChunk );
+    for ( int32_t x = 0; x < option.regionSize; ++x )
+        for ( int32_t z = 0; z < option.regionSize; ++z )
+        {
+            const auto chunk = world.GetChunkCacheUnsafe( MakeMinecraftChunkCoordinate( regionBegin + x, regionBegin + z ) );
+            if ( chunk == nullptr )
+            {
+                std::cerr << "Chunk " << regionBegin + x << ", " << regionBegin + z << " not generated" << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            auto& benchmarkChunk = chunks[ regionIndex( x, z ) ] = std::make_unique<BenchmarkChunk>( &world );
+            benchmarkChunk->CopyBlocks( *chunk );
+        }
+
+    /*
+     *
+     * Link inner chunks and build neighbor transparency and ambient occlusion
+     *
+     * */
+    std::vector<BenchmarkChunk*> innerChunks;
+    for ( int32_t x = 1; x < option.regionSize - 1; ++x )
+        for ( int32_t z = 1; z < option.regionSize - 1; ++z )
+        {
+            auto* chunk = chunks[ regionIndex( x, z ) ].get( );
+            for ( int i = 0; i < EightWayDirectionSize; ++i )
+            {
+                const auto offset = ChunkPool::NearChunkDirection[ i ];
+                chunk->LinkNeighbor( i, chunks[ regionIndex( x + GetMinecraftX( offset ), z + GetMinecraftZ( offset ) ) ].get( ) );
+            }
+
+            chunk->BuildMeshData( );
+            innerChunks.push_back( chunk );
+        }
+
+    /*
+     *
+     * Mesh
+     *
+     * */
+    std::vector<std::vector<GreedyMeshFace>> referenceMeshes( innerChunks.size( ) ), meshes( innerChunks.size( ) );
+
+    const double referenceSeconds = MeasureSeconds( [ & ] {
+        for ( int iteration = 0; iteration < option.iterations; ++iteration )
+            for ( size_t i = 0; i < innerChunks.size( ); ++i )
+                referenceMeshes[ i ] = GenerateReferenceGreedyMesh( *innerChunks[ i ] );
+    } );
+
+    const double binarySeconds = MeasureSeconds( [ & ] {
+        for ( int iteration = 0; iteration < option.iterations; ++iteration )
+            for ( size_t i = 0; i < innerChunks.size( ); ++i )
+                meshes[ i ] = innerChunks[ i ]->GenerateGreedyMesh( );
+    } );
+
+    size_t quadCount = 0, mismatchedChunk = 0;
+    for ( size_t i = 0; i < innerChunks.size( ); ++i )
+    {
+        quadCount += meshes[ i ].size( );
+        if ( meshes[ i ] != referenceMeshes[ i ] )
+        {
+            ++mismatchedChunk;
+            const auto& coordinate = innerChunks[ i ]->GetChunkCoordinate( );
+            std::cerr << "Mesh mismatch at chunk " << GetMinecraftX( coordinate ) << ", " << GetMinecraftZ( coordinate ) << ": "
+                      << meshes[ i ].size( ) << " quads, expected " << referenceMeshes[ i ].size( ) << std::endl;
+        }
+    }
+
+    const double meshCount = static_cast<double>( innerChunks.size( ) ) * option.iterations;
+    std::printf( "\n%zu chunks x %d iterations, %zu quads per iteration\n", innerChunks.size( ), option.iterations, quadCount );
+    std::printf( "%-10s %14s %10s\n", "Mesher", "us/chunk", "Speedup" );
+    std::printf( "%-10s %14.2f %10.2f\n", "Reference", referenceSeconds / meshCount * 1e6, 1.0 );
+    std::printf( "%-10s %14.2f %10.2f\n", "Binary", binarySeconds / meshCount * 1e6, referenceSeconds / binarySeconds );
+    std::printf( "%-10s %14s\n", "Match", mismatchedChunk == 0 ? "yes" : "NO" );
+
+    return mismatchedChunk == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
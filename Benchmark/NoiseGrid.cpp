@@ -0,0 +1,128 @@
+#include <Minecraft/World/Generation/MinecraftNoise.hpp>
+#include <Minecraft/util/MinecraftConstants.hpp>
+#include <Utility/String/ParseNumber.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+ *
+ * Micro benchmark of MinecraftNoise::FillNoiseGrid against per point GetNoiseInt
+ *
+ * Fill full chunk columns with the terrain noise settings, and check every path is bit identical to the scalar one
+ *
+ * */
+
+namespace
+{
+
+struct BenchmarkOption {
+    int32_t  chunkCount = 64;
+    uint64_t seed       = 20220523;
+};
+
+bool
+ParseOption( int argc, char** argv, BenchmarkOption& option )
+{
+    for ( int i = 1; i < argc; ++i )
+    {
+        const std::string argument = argv[ i ];
+        if ( i + 1 >= argc ) return false;
+
+        if ( argument == "--chunks" )
+        {
+            if ( !ParseNumber( argv[ ++i ], option.chunkCount ) ) return false;
+        } else if ( argument == "--seed" )
+        {
+            if ( !ParseNumber( argv[ ++i ], option.seed ) ) return false;
+        } else
+            return false;
+    }
+
+    return option.chunkCount > 0;
+}
+
+// Same settings as MinecraftWorld::SetSeed
+MinecraftNoise
+MakeTerrainNoise( uint64_t seed )
+{
+    MinecraftNoise noise = MinecraftNoise::FromUint64( seed );
+    noise.SetNoiseType( Noise::FastNoiseLite::NoiseType_Perlin );
+    noise.SetFractalType( Noise::FastNoiseLite::FractalType_FBm );
+    noise.SetFractalLacunarity( 2.5f );
+    noise.SetFractalGain( 0.32f );
+    noise.SetFractalOctaves( 8 );
+
+    return noise;
+}
+
+template <typename Fn>
+double
+MeasureSeconds( Fn&& function )
+{
+    const auto startTime = std::chrono::steady_clock::now( );
+    function( );
+    return std::chrono::duration<double>( std::chrono::steady_clock::now( ) - startTime ).count( );
+}
+
+}   // namespace
+
+int
+main( int argc, char** argv )
+{
+    BenchmarkOption option;
+    if ( !ParseOption( argc, argv, option ) )
+    {
+        std::cerr << "Usage: " << argv[ 0 ] << " [--chunks N] [--seed S]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const auto noise = MakeTerrainNoise( option.seed );
+
+    // Chunks along a diagonal, including negative coordinates
+    const auto chunkOrigin = [ & ]( int32_t index ) { return ( index - option.chunkCount / 2 ) * SectionUnitLength; };
+
+    std::vector<float> reference( static_cast<size_t>( option.chunkCount ) * ChunkVolume );
+    std::vector<float> result( reference.size( ) );
+
+    const double scalarSeconds = MeasureSeconds( [ & ] {
+        auto* output = reference.data( );
+        for ( int32_t c = 0; c < option.chunkCount; ++c )
+            for ( int y = 0; y < ChunkMaxHeight; ++y )
+                for ( int z = 0; z < SectionUnitLength; ++z )
+                    for ( int x = 0; x < SectionUnitLength; ++x )
+                        *output++ = noise.GetNoiseInt( chunkOrigin( c ) + x, y, chunkOrigin( c ) + z );
+    } );
+
+    const double pointCount = static_cast<double>( reference.size( ) );
+    std::printf( "%-10s %12s %14s %10s %10s\n", "Path", "Time (ms)", "Mpoints/s", "Speedup", "Match" );
+    std::printf( "%-10s %12.2f %14.2f %10.2f %10s\n", "GetNoise", scalarSeconds * 1e3, pointCount / scalarSeconds / 1e6, 1.0, "-" );
+
+    const char* instructionSetName[] = { "Scalar", "SSE4.1", "AVX2" };
+
+    bool allMatched = true;
+    for ( int set = MinecraftNoise::eScalar; set <= MinecraftNoise::GetSupportedGridInstructionSet( ); ++set )
+    {
+        std::fill( result.begin( ), result.end( ), 0.0f );
+
+        const double seconds = MeasureSeconds( [ & ] {
+            for ( int32_t c = 0; c < option.chunkCount; ++c )
+                noise.FillNoiseGrid( result.data( ) + static_cast<size_t>( c ) * ChunkVolume,
+                                     chunkOrigin( c ), 0, chunkOrigin( c ),
+                                     SectionUnitLength, ChunkMaxHeight, SectionUnitLength,
+                                     static_cast<MinecraftNoise::GridInstructionSet>( set ) );
+        } );
+
+        // bit identical, not approximately equal
+        const bool matched = std::memcmp( reference.data( ), result.data( ), reference.size( ) * sizeof( float ) ) == 0;
+        allMatched &= matched;
+
+        std::printf( "%-10s %12.2f %14.2f %10.2f %10s\n", instructionSetName[ set ], seconds * 1e3, pointCount / seconds / 1e6, scalarSeconds / seconds, matched ? "yes" : "NO" );
+    }
+
+    return allMatched ? EXIT_SUCCESS : EXIT_FAILURE;
+}
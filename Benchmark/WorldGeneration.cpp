@@ -0,0 +1,246 @@
+#include <Include/GlobalConfig.hpp>
+#include <Minecraft/Internet/MinecraftServer/MinecraftServer.hpp>
+#include <Minecraft/World/Chunk/ChunkPool.hpp>
+#include <Minecraft/World/Chunk/WorldChunk.hpp>
+#include <Minecraft/World/MinecraftWorld.hpp>
+#include <Utility/Memory/SlabPool.hpp>
+#include <Utility/String/ParseNumber.hpp>
+
+#if _WIN32
+#    include <windows.h>
+#    include <psapi.h>
+#else
+#    include <sys/resource.h>
+#endif
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+
+/*
+ *
+ * Headless world generation benchmark, no window or Vulkan device is created
+ *
+ * Generate a N x N chunk region around the origin with a fixed seed, then report throughput per status
+ *
+ * */
+
+namespace
+{
+
+struct BenchmarkOption {
+    int32_t     regionSize = 16;
+    uint64_t    seed       = 20220523;
+    uint32_t    threads    = 0;     // 0 to use config value
+    int32_t     timeout    = 600;   // seconds without any progress before giving up
+    std::string config     = "config.ini";
+    std::string sampling;   // empty to use config value
+};
+
+size_t
+GetPeakRSS( )
+{
+#if _WIN32
+    PROCESS_MEMORY_COUNTERS counters { };
+    GetProcessMemoryInfo( GetCurrentProcess( ), &counters, sizeof( counters ) );
+    return counters.PeakWorkingSetSize;
+#else
+    rusage usage { };
+    getrusage( RUSAGE_SELF, &usage );
+#    if __APPLE__
+    return usage.ru_maxrss;
+#    else
+    return usage.ru_maxrss * 1024;
+#    endif
+#endif
+}
+
+// Same as ImGuiAddons::CurveEditor::Sample, without pulling in imgui
+float
+SampleGenerationCurve( const nlohmann::json& curve, float x )
+{
+    if ( curve.empty( ) ) return 0;
+
+    const auto pointX = [ & ]( size_t index ) { return curve[ index ][ 0 ].get<float>( ); };
+    const auto pointY = [ & ]( size_t index ) { return curve[ index ][ 1 ].get<float>( ); };
+
+    if ( x < pointX( 0 ) ) return pointY( 0 );
+    if ( x >= pointX( curve.size( ) - 1 ) ) return pointY( curve.size( ) - 1 );
+
+    size_t curr = 1;
+    for ( ; curr < curve.size( ); ++curr )
+        if ( pointX( curr ) >= x ) break;
+
+    return std::lerp( pointY( curr - 1 ), pointY( curr ), ( x - pointX( curr - 1 ) ) / ( pointX( curr ) - pointX( curr - 1 ) ) );
+}
+
+bool
+ParseOption( int argc, char** argv, BenchmarkOption& option )
+{
+    for ( int i = 1; i < argc; ++i )
+    {
+        const std::string argument = argv[ i ];
+        if ( i + 1 >= argc ) return false;
+
+        if ( argument == "--size" )
+        {
+            if ( !ParseNumber( argv[ ++i ], option.regionSize ) ) return false;
+        } else if ( argument == "--seed" )
+        {
+            if ( !ParseNumber( argv[ ++i ], option.seed ) ) return false;
+        } else if ( argument == "--threads" )
+        {
+            if ( !ParseNumber( argv[ ++i ], option.threads ) ) return false;
+        } else if ( argument == "--timeout" )
+        {
+            if ( !ParseNumber( argv[ ++i ], option.timeout ) ) return false;
+        } else if ( argument == "--config" )
+            option.config = argv[ ++i ];
+        else if ( argument == "--sampling" )
+            option.sampling = argv[ ++i ];
+        else
+            return false;
+    }
+
+    return option.regionSize > 0 && option.timeout > 0 && ( option.sampling.empty( ) || option.sampling == "full" || option.sampling == "sparse" );
+}
+
+}   // namespace
+
+int
+main( int argc, char** argv )
+{
+    BenchmarkOption option;
+    if ( !ParseOption( argc, argv, option ) )
+    {
+        std::cerr << "Usage: " << argv[ 0 ] << " [--size N] [--seed S] [--threads T] [--timeout SECONDS] [--config PATH] [--sampling full|sparse]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if ( !GlobalConfig::LoadFromFile( option.config ) )
+        std::cerr << "Unable to load " << option.config << ", using default settings" << std::endl;
+
+    auto& chunkConfig = GlobalConfig::getMinecraftConfigData( )[ "chunk" ];
+
+    // Every chunk in region must be inside the loading range of the origin
+    chunkConfig[ "chunk_loading_range" ] = option.regionSize / 2;
+    if ( option.threads > 0 )
+        chunkConfig[ "loading_thread" ] = option.threads;
+    else if ( !chunkConfig.contains( "loading_thread" ) )
+        chunkConfig[ "loading_thread" ] = std::max( std::thread::hardware_concurrency( ), 1U );
+    if ( !option.sampling.empty( ) )
+        chunkConfig[ "terrain_sampling" ] = option.sampling;
+
+    GlobalConfig::getMinecraftConfigData( )[ "seed" ] = option.seed;
+
+    MinecraftServer server;
+    server.InitWorld( );
+
+    auto& world = server.GetWorld( );
+    world.GetChunkPool( ).SetRenderBufferEnabled( false );
+
+    if ( chunkConfig.contains( "generation_curve" ) )
+    {
+        auto offsets = std::make_unique<float[]>( ChunkMaxHeight );
+        for ( int i = 0; i < ChunkMaxHeight; ++i )
+            offsets[ i ] = SampleGenerationCurve( chunkConfig[ "generation_curve" ], (float) i / ChunkMaxHeight );
+        world.SetTerrainNoiseOffset( std::move( offsets ) );
+    }
+
+    const uint64_t totalChunk  = static_cast<uint64_t>( option.regionSize ) * option.regionSize;
+    const int32_t  regionBegin = -option.regionSize / 2;
+
+    std::cout << "Generating " << option.regionSize << 'x' << option.regionSize << " chunks with seed " << option.seed
+              << " on " << world.GetChunkPool( ).GetMaxThread( ) << " threads, "
+              << ( world.GetTerrainSampling( ) == MinecraftWorld::eSparseTerrainSampling ? "sparse" : "full" ) << " terrain sampling" << std::endl;
+
+    const auto startTime = std::chrono::steady_clock::now( );
+
+    world.GetChunkPool( ).SetCentre( MakeMinecraftChunkCoordinate( 0, 0 ) );
+    for ( int32_t x = 0; x < option.regionSize; ++x )
+        for ( int32_t z = 0; z < option.regionSize; ++z )
+            world.IntroduceChunk( MakeMinecraftChunkCoordinate( regionBegin + x, regionBegin + z ), ChunkStatus::eFull );
+
+    uint64_t previousCompleted = 0;
+    auto     lastProgressTime  = startTime;
+    while ( true )
+    {
+        const uint64_t completed = WorldChunk::Statistics.completed[ eFull ].load( );
+        if ( completed >= totalChunk ) break;
+
+        const auto now = std::chrono::steady_clock::now( );
+        if ( completed != previousCompleted )
+        {
+            previousCompleted = completed;
+            lastProgressTime  = now;
+        } else if ( now - lastProgressTime > std::chrono::seconds( option.timeout ) )
+        {
+            std::cerr << "No progress for " << option.timeout << "s, " << completed << '/' << totalChunk << " chunks completed" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+    }
+
+    const auto wallSeconds = std::chrono::duration<double>( std::chrono::steady_clock::now( ) - startTime ).count( );
+    world.StopChunkGeneration( );
+
+    /*
+     *
+     * Report
+     *
+     * */
+    const char* statusName[] = { "Empty", "StructureStart", "StructureReference", "Noise (FillTerrain)", "Feature" };
+    static_assert( std::size( statusName ) == ChunkStatusSize );
+
+    std::printf( "\n%-22s %10s %14s %16s\n", "Stage", "Chunks", "Chunks/s", "CPU ms/chunk" );
+    for ( int i = eStructureStart; i < ChunkStatusSize; ++i )
+    {
+        const auto completed   = WorldChunk::Statistics.completed[ i ].load( );
+        const auto nanoseconds = WorldChunk::Statistics.nanoseconds[ i ].load( );
+
+        std::printf( "%-22s %10llu %14.1f %16.3f\n",
+                     statusName[ i ],
+                     (unsigned long long) completed,
+                     completed / wallSeconds,
+                     completed ? nanoseconds / 1e6 / completed : 0.0 );
+    }
+
+    // order independent of generation, identical for every run with same seed and settings
+    uint64_t regionChecksum = 0;
+    size_t   blockStorage = 0, blockStorageSaving = 0;
+    for ( int32_t x = 0; x < option.regionSize; ++x )
+        for ( int32_t z = 0; z < option.regionSize; ++z )
+        {
+            const auto chunk = world.GetChunkCacheUnsafe( MakeMinecraftChunkCoordinate( regionBegin + x, regionBegin + z ) );
+            regionChecksum   = ( regionChecksum ^ ( chunk ? chunk->GetChecksum( ) : 0 ) ) * 1099511628211ULL;
+
+            if ( chunk == nullptr ) continue;
+            blockStorage += chunk->GetBlockStorageSize( );
+            blockStorageSaving += chunk->GetBlockStorageSaving( );
+        }
+
+    std::printf( "\n%-22s %.3f s\n", "Wall time", wallSeconds );
+    std::printf( "%-22s %.1f\n", "Full chunks/s", totalChunk / wallSeconds );
+    std::printf( "%-22s %llu / %llu\n", "Wasted attempts", (unsigned long long) world.GetChunkPool( ).GetWastedAttemptCount( ), (unsigned long long) world.GetChunkPool( ).GetAttemptCount( ) );
+    std::printf( "%-22s %.1f MiB\n", "Peak RSS", GetPeakRSS( ) / ( 1024.0 * 1024.0 ) );
+    std::printf( "%-22s %.1f MiB (%.1f MiB saved)\n", "Block storage", blockStorage / ( 1024.0 * 1024.0 ), blockStorageSaving / ( 1024.0 * 1024.0 ) );
+    std::printf( "%-22s %016llx\n", "Region checksum", (unsigned long long) regionChecksum );
+
+    // every other allocation of chunk storage is served from a free list
+    std::printf( "\n%-22s %12s %12s %12s %12s\n", "Pool", "Allocations", "Frees", "Slabs", "Peak blocks" );
+    for ( auto* pool : SlabPool::GetPools( ) )
+    {
+        const auto statistics = pool->GetStatistics( );
+        std::printf( "%-22s %12llu %12llu %12llu %12u\n",
+                     pool->GetName( ).c_str( ),
+                     (unsigned long long) statistics.allocations,
+                     (unsigned long long) statistics.frees,
+                     (unsigned long long) statistics.slabAllocations,
+                     statistics.peakBlocksInUse );
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -17,6 +17,7 @@ class BufferMeta
     VmaAllocator  allocator { };
     vk::Buffer    buffer { };
     VmaAllocation allocation { };
+    void*         mappedData { };   // only with VMA_ALLOCATION_CREATE_MAPPED_BIT
 
 public:
     BufferMeta( ) = default;
@@ -29,7 +30,8 @@ public:
     void DestroyBuffer( )
     {
         if ( buffer ) vmaDestroyBuffer( allocator, buffer, allocation );
-        buffer = nullptr;
+        buffer     = nullptr;
+        mappedData = nullptr;
     }
 
     inline auto& GetBuffer( ) const
@@ -37,12 +39,15 @@ public:
         return buffer;
     }
 
+    inline auto GetMappedData( ) const
+    {
+        return mappedData;
+    }
+
     void Create( const vk::DeviceSize size, const vk::BufferUsageFlags usage, const VmaMemoryUsage& memoryUsage = VMA_MEMORY_USAGE_CPU_ONLY,
                  const vk::SharingMode sharingMode = vk::SharingMode::eExclusive, const VmaAllocationCreateFlags& memoryFlag = 0 )
     {
-        static std::mutex           create_buffer_lock;
-        std::lock_guard<std::mutex> guard( create_buffer_lock );
-
+        // allocator is internally synchronized
         DestroyBuffer( );
 
         vk::BufferCreateInfo    bufferInfo { { }, size, usage, sharingMode };
@@ -51,29 +56,44 @@ public:
         allocInfo.flags                   = memoryFlag;
         // allocInfo.requiredFlags           = static_cast<uint32_t>( memoryProperties );
 
-        vmaCreateBuffer( allocator, reinterpret_cast<const VkBufferCreateInfo*>( &bufferInfo ), &allocInfo, reinterpret_cast<VkBuffer*>( &buffer ), &allocation, nullptr );
+        VmaAllocationInfo allocationInfo { };
+        vmaCreateBuffer( allocator, reinterpret_cast<const VkBufferCreateInfo*>( &bufferInfo ), &allocInfo, reinterpret_cast<VkBuffer*>( &buffer ), &allocation, &allocationInfo );
+        mappedData = allocationInfo.pMappedData;
         // vmaBindBufferMemory( allocator, allocation, buffer );
     }
 
     void writeBuffer( const void* writingData, size_t dataSize )
     {
-        static std::mutex           map_buffer_lock;
-        std::lock_guard<std::mutex> guard( map_buffer_lock );
-
-        void* mappedData = nullptr;
-        vmaMapMemory( allocator, allocation, &mappedData );
-        memcpy( mappedData, writingData, dataSize );
-        vmaUnmapMemory( allocator, allocation );
+        writeBufferOffseted( writingData, dataSize, 0 );
     }
 
     void writeBufferOffseted( const void* writingData, size_t dataSize, size_t offset )
     {
+        if ( this->mappedData != nullptr )
+        {
+            memcpy( (char*) this->mappedData + offset, writingData, dataSize );
+            Flush( offset, dataSize );
+            return;
+        }
+
         void* mappedData = nullptr;
         vmaMapMemory( allocator, allocation, &mappedData );
         memcpy( (char*) mappedData + offset, writingData, dataSize );
         vmaUnmapMemory( allocator, allocation );
     }
 
+    // Make host writes visible on non-coherent memory, no-op otherwise
+    void Flush( vk::DeviceSize offset, vk::DeviceSize size )
+    {
+        vmaFlushAllocation( allocator, allocation, offset, size );
+    }
+
+    // Make device writes visible to the host on non-coherent memory, no-op otherwise
+    void Invalidate( vk::DeviceSize offset, vk::DeviceSize size )
+    {
+        vmaInvalidateAllocation( allocator, allocation, offset, size );
+    }
+
     void CopyFromBuffer( const BufferMeta& bufferData, const vk::ArrayProxy<const vk::BufferCopy>& dataRegion, class VulkanAPI& api );
 
     void SetAllocator( VmaAllocator newAllocator = nullptr );
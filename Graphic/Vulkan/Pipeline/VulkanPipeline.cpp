@@ -82,9 +82,10 @@ VulkanPipeline::SetupDynamicStage( )
 void
 VulkanPipeline::SetupPipelineLayout( vk::Device& device )
 {
+    // per frame ubo lives in a ring, offset given at bind time
     vk::DescriptorSetLayoutBinding uboLayoutBinding;
     uboLayoutBinding.setBinding( 0 )
-        .setDescriptorType( vk::DescriptorType::eUniformBuffer )
+        .setDescriptorType( vk::DescriptorType::eUniformBufferDynamic )
         .setDescriptorCount( 1 )
         .setStageFlags( vk::ShaderStageFlagBits::eVertex )
         .setPImmutableSamplers( nullptr );
@@ -104,8 +105,10 @@ VulkanPipeline::SetupPipelineLayout( vk::Device& device )
 
     createInfo.vertexUniformDescriptorSetLayout = device.createDescriptorSetLayoutUnique( layoutInfo );
 
+    const vk::PushConstantRange pushConstantRange { PushConstantStages, 0, sizeof( PushConstants ) };
+
     vk::PipelineLayoutCreateInfo pipelineLayoutInfo;
-    pipelineLayoutInfo.setSetLayouts( *createInfo.vertexUniformDescriptorSetLayout );
+    pipelineLayoutInfo.setSetLayouts( *createInfo.vertexUniformDescriptorSetLayout ).setPushConstantRanges( pushConstantRange );
     m_vkPipelineLayout = device.createPipelineLayoutUnique( pipelineLayoutInfo );
 }
 
@@ -176,7 +179,7 @@ void
 VulkanPipeline::SetupDescriptorPool( vk::Device& device, uint32_t descriptorCount )
 {
     auto& ubo = createInfo.descriptorPoolSizes.emplace_back();
-    ubo.setType( vk::DescriptorType::eUniformBuffer );
+    ubo.setType( vk::DescriptorType::eUniformBufferDynamic );
     ubo.setDescriptorCount( descriptorCount );
 
     auto& tbo = createInfo.descriptorPoolSizes.emplace_back();
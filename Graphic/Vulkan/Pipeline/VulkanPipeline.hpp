@@ -91,6 +91,13 @@ protected:
     virtual void SetupDepthStencilStage( );
 
 public:
+    // Layout has to be kept in sync with the push_constant block in vertex_buffer.vert and vertex_buffer.frag
+    struct PushConstants {
+        float textureResolution;   // pixels per atlas cell
+    };
+
+    static constexpr vk::ShaderStageFlags PushConstantStages = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
+
     explicit VulkanPipeline( std::unique_ptr<VulkanShader>&& vkShader );
     virtual ~VulkanPipeline( ) = default; // why ???
 
@@ -74,6 +74,37 @@ VulkanShader::InitGLSLString( const vk::Device& device, const std::string& verte
     return true;
 }
 
+bool
+VulkanShader::InitComputeGLSLFile( const vk::Device& device, const std::string& compute_file_path )
+{
+    std::stringstream compute_sstr;
+    compute_sstr << std::ifstream( compute_file_path ).rdbuf( );
+
+    return InitComputeGLSLString( device, compute_sstr.str( ) );
+}
+
+bool
+VulkanShader::InitComputeGLSLString( const vk::Device& device, const std::string& computeShader )
+{
+    shaderc::Compiler       compiler;
+    shaderc::CompileOptions options;
+    options.SetOptimizationLevel( shaderc_optimization_level_performance );
+
+    Logger::getInstance( ).LogLine( Logger::LogType::eInfo, "Compiling compute shader" );
+
+    shaderc::SpvCompilationResult compShaderModule =
+        compiler.CompileGlslToSpv( computeShader, shaderc_glsl_compute_shader, "compute shader", options );
+    if ( compShaderModule.GetCompilationStatus( ) != shaderc_compilation_status_success )
+    {
+        Logger::getInstance( ).LogLine( Logger::LogType::eError, compShaderModule.GetErrorMessage( ) );
+        throw std::runtime_error( "compute shader compilation failed !" );
+    }
+
+    m_vkCompute_shader_module = InitGLSLCode( device, std::vector<uint32_t> { compShaderModule.cbegin( ), compShaderModule.cend( ) } );
+
+    return true;
+}
+
 vk::UniqueShaderModule
 VulkanShader::InitGLSLCode( const vk::Device& device, const std::vector<uint32_t>& code )
 {
@@ -14,6 +14,7 @@ class VulkanShader
 {
     vk::UniqueShaderModule m_vkVertex_shader_module;
     vk::UniqueShaderModule m_vkFragment_shader_module;
+    vk::UniqueShaderModule m_vkCompute_shader_module;
 
 public:
     VulkanShader( ) = default;
@@ -25,6 +26,15 @@ public:
     vk::UniqueShaderModule InitGLSLCode( const vk::Device& device, const std::vector<char>& vertex_code );
     vk::UniqueShaderModule InitGLSLCode( const vk::Device& device, const std::vector<uint32_t>& vertex_code );
 
+    /*
+     *
+     * Compute shader, kept apart from the vertex and fragment pair
+     *
+     * */
+    bool        InitComputeGLSLFile( const vk::Device& device, const std::string& compute_file_path );
+    bool        InitComputeGLSLString( const vk::Device& device, const std::string& computeShader );
+    inline auto GetComputeShaderModule( ) const { return m_vkCompute_shader_module.get( ); }
+
     friend class VulkanPipeline;
 };
 
@@ -0,0 +1,118 @@
+#include "StagingRing.hpp"
+
+#include <Graphic/Vulkan/VulkanAPI.hpp>
+
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+StagingRing::~StagingRing( )
+{
+    if ( m_Buffer.GetBuffer( ) ) Retire( true );
+}
+
+void
+StagingRing::Create( vk::DeviceSize size, vk::BufferUsageFlags usage, VmaMemoryUsage memoryUsage )
+{
+    if ( m_Buffer.GetBuffer( ) ) Retire( true );
+
+    m_Buffer.SetAllocator( );
+    m_Buffer.Create( size, usage, memoryUsage, vk::SharingMode::eExclusive, VMA_ALLOCATION_CREATE_MAPPED_BIT );
+
+    m_MappedData   = static_cast<char*>( m_Buffer.GetMappedData( ) );
+    m_Size         = size;
+    m_Head         = 0;
+    m_Tail         = 0;
+    m_ReleasedHead = 0;
+
+    assert( m_MappedData != nullptr );
+}
+
+StagingRing::Allocation
+StagingRing::Allocate( vk::DeviceSize size, vk::DeviceSize alignment )
+{
+    assert( ( alignment & ( alignment - 1 ) ) == 0 && m_Size % alignment == 0 );
+    if ( size > m_Size ) return { };
+
+    uint64_t head = m_Head.load( std::memory_order_relaxed );
+    uint64_t begin;
+    do
+    {
+        begin = ( head + alignment - 1 ) & ~( alignment - 1 );
+
+        // never split across the end, skip to the start of ring
+        if ( const auto offset = begin % m_Size; offset + size > m_Size )
+            begin += m_Size - offset;
+
+        if ( begin + size - m_Tail.load( std::memory_order_acquire ) > m_Size ) return { };
+    } while ( !m_Head.compare_exchange_weak( head, begin + size, std::memory_order_acq_rel, std::memory_order_relaxed ) );
+
+    const auto offset = begin % m_Size;
+    return { m_Buffer.GetBuffer( ), offset, m_MappedData + offset };
+}
+
+StagingRing::Allocation
+StagingRing::Write( const void* data, vk::DeviceSize size, vk::DeviceSize alignment )
+{
+    auto allocation = Allocate( size, alignment );
+    if ( allocation ) memcpy( allocation.data, data, size );
+
+    return allocation;
+}
+
+void
+StagingRing::Flush( uint64_t begin, uint64_t end )
+{
+    if ( begin == end ) return;
+
+    // no-op on coherent memory
+    if ( end - begin >= m_Size )
+    {
+        m_Buffer.Flush( 0, m_Size );
+        return;
+    }
+
+    const auto beginOffset = begin % m_Size, endOffset = end % m_Size;
+    if ( beginOffset < endOffset || endOffset == 0 )
+    {
+        m_Buffer.Flush( beginOffset, ( endOffset == 0 ? m_Size : endOffset ) - beginOffset );
+    } else
+    {
+        m_Buffer.Flush( beginOffset, m_Size - beginOffset );
+        m_Buffer.Flush( 0, endOffset );
+    }
+}
+
+void
+StagingRing::Release( vk::Fence fence )
+{
+    const auto head = m_Head.load( std::memory_order_acquire );
+    if ( head == m_ReleasedHead ) return;
+
+    Flush( m_ReleasedHead, head );
+    m_ReleasedHead = head;
+    m_FencedRegions.push_back( { fence, head } );
+}
+
+void
+StagingRing::Retire( bool wait )
+{
+    auto& device = VulkanAPI::GetInstance( ).getLogicalDevice( );
+
+    while ( !m_FencedRegions.empty( ) )
+    {
+        const auto& region = m_FencedRegions.front( );
+        if ( region.fence && wait )
+        {
+            const auto waitResult = device.waitForFences( region.fence, true, std::numeric_limits<uint64_t>::max( ) );
+            assert( waitResult == vk::Result::eSuccess );
+            (void) waitResult;
+        } else if ( region.fence && device.getFenceStatus( region.fence ) != vk::Result::eSuccess )
+        {
+            break;
+        }
+
+        m_Tail.store( region.end, std::memory_order_release );
+        m_FencedRegions.pop_front( );
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef MINECRAFT_VK_GRAPHIC_VULKAN_STAGINGRING_HPP
+#define MINECRAFT_VK_GRAPHIC_VULKAN_STAGINGRING_HPP
+
+#include <Graphic/Vulkan/BufferMeta.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+
+/*
+ *
+ * Persistently mapped buffer sub-allocated as a ring
+ *
+ * Allocate is lock free and can be called from any thread, an allocation is a pointer bump plus the caller's memcpy
+ * Release hands everything allocated so far to a fence, Retire reclaims the space in order once the fences signal
+ * Release and Retire belong to one thread, every write meant for a fence must be done before its Release
+ *
+ * */
+class StagingRing
+{
+    BufferMeta     m_Buffer;
+    char*          m_MappedData { };
+    vk::DeviceSize m_Size = 0;
+
+    // Monotonic byte positions, position % m_Size is the offset in buffer
+    std::atomic<uint64_t> m_Head { 0 };
+    std::atomic<uint64_t> m_Tail { 0 };
+
+    struct FencedRegion {
+        vk::Fence fence;
+        uint64_t  end;
+    };
+
+    uint64_t                 m_ReleasedHead = 0;
+    std::deque<FencedRegion> m_FencedRegions;
+
+    void Flush( uint64_t begin, uint64_t end );
+
+public:
+    struct Allocation {
+        vk::Buffer     buffer { };
+        vk::DeviceSize offset = 0;
+        void*          data { };
+
+        explicit operator bool( ) const { return data != nullptr; }
+    };
+
+    StagingRing( ) = default;
+    ~StagingRing( );
+
+    StagingRing( const StagingRing& )            = delete;
+    StagingRing& operator=( const StagingRing& ) = delete;
+
+    // Size have to be a multiple of every alignment requested later
+    void Create( vk::DeviceSize size, vk::BufferUsageFlags usage, VmaMemoryUsage memoryUsage = VMA_MEMORY_USAGE_CPU_TO_GPU );
+
+    // Empty allocation if the ring is full, never waits, alignment must be a power of two
+    [[nodiscard]] Allocation Allocate( vk::DeviceSize size, vk::DeviceSize alignment = 16 );
+    [[nodiscard]] Allocation Write( const void* data, vk::DeviceSize size, vk::DeviceSize alignment = 16 );
+
+    // Everything allocated until now is reused after fence signaled, null fence for space that was never submitted
+    void Release( vk::Fence fence = nullptr );
+    void Retire( bool wait = false );
+
+    inline const auto& GetBuffer( ) const { return m_Buffer.GetBuffer( ); }
+    inline auto        GetSize( ) const { return m_Size; }
+    inline auto        GetUsedSize( ) const { return m_Head.load( std::memory_order_relaxed ) - m_Tail.load( std::memory_order_relaxed ); }
+};
+
+
+#endif   // MINECRAFT_VK_GRAPHIC_VULKAN_STAGINGRING_HPP
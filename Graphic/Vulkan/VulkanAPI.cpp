@@ -7,7 +7,9 @@
 #include <Utility/Logger.hpp>
 #include <Utility/Vulkan/VulkanExtension.hpp>
 
+#include <algorithm>
 #include <filesystem>
+#include <string_view>
 #include <unordered_set>
 
 namespace
@@ -423,11 +425,28 @@ VulkanAPI::setupLogicalDevice( )
     createInfo.setQueueCreateInfos( queueCreateInfos );
     createInfo.setEnabledLayerCount( (uint32_t) m_vkValidationLayer->RequiredLayerCount( ) );
     createInfo.setPpEnabledLayerNames( m_vkValidationLayer->RequiredLayerStrPtr( ) );
-    createInfo.setEnabledExtensionCount( (uint32_t) m_vkExtension->DeviceExtensionCount( ) );
-    createInfo.setPpEnabledExtensionNames( m_vkExtension->DeviceExtensionStrPtr( ) );
+
+    // optional extensions go after the ones from config
+    std::vector<const char*> deviceExtensions( m_vkExtension->DeviceExtensionStrPtr( ), m_vkExtension->DeviceExtensionStrPtr( ) + m_vkExtension->DeviceExtensionCount( ) );
+
+    const auto isExtensionRequested = [ &deviceExtensions ]( std::string_view name ) { return std::ranges::any_of( deviceExtensions, [ name ]( const char* extension ) { return name == extension; } ); };
+    const auto isExtensionAvailable = [ availableExtensions = m_vkPhysicalDevice.enumerateDeviceExtensionProperties( ) ]( std::string_view name ) {
+        return std::ranges::any_of( availableExtensions, [ name ]( const auto& properties ) { return name == properties.extensionName.data( ); } );
+    };
+
+    m_drawIndirectCountSupported = isExtensionAvailable( VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME );
+    if ( m_drawIndirectCountSupported && !isExtensionRequested( VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME ) )
+        deviceExtensions.push_back( VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME );
+
+    Logger::getInstance( ).LogLine( Logger::LogType::eInfo, "Draw indirect count", m_drawIndirectCountSupported ? "supported" : "not supported" );
+
+    createInfo.setPEnabledExtensionNames( deviceExtensions );
 
     m_vkLogicalDevice = m_vkPhysicalDevice.createDeviceUnique( createInfo );
 
+    // device level functions of extensions
+    m_vkDynamicDispatch.init( m_vkLogicalDevice.get( ) );
+
     /**
      *
      *
@@ -568,12 +587,12 @@ VulkanAPI::setupPipeline( )
      *
      * */
     m_vkPipeline = std::make_unique<VulkanPipeline>( std::move( shader ) );
-    m_vkPipeline->Create<DataType::TexturedVertex>( (float) m_vkDisplayExtent.width,
-                                                    (float) m_vkDisplayExtent.height,
-                                                    static_cast<uint32_t>( getSwapChainImagesCount( ) ),
-                                                    m_vkLogicalDevice.get( ),
-                                                    m_vkSwap_chain_detail.formats[ 0 ],
-                                                    m_vkSwap_chain_depth_format );
+    m_vkPipeline->Create<DataType::PackedChunkVertex>( (float) m_vkDisplayExtent.width,
+                                                       (float) m_vkDisplayExtent.height,
+                                                       static_cast<uint32_t>( getSwapChainImagesCount( ) ),
+                                                       m_vkLogicalDevice.get( ),
+                                                       m_vkSwap_chain_detail.formats[ 0 ],
+                                                       m_vkSwap_chain_depth_format );
 
     /**
      *
@@ -679,6 +698,8 @@ VulkanAPI::cycleGraphicCommandBuffers( uint32_t index )
         // m_vkGraphicCommandBuffers[ it_index ].reset( );
         m_vkGraphicCommandBuffers[ it_index ].begin( { vk::CommandBufferUsageFlagBits::eOneTimeSubmit } );
 
+        if ( m_pre_renderer ) m_pre_renderer( m_vkGraphicCommandBuffers[ it_index ], (uint32_t) it_index );
+
         vk::RenderPassBeginInfo render_pass_begin_info;
         render_pass_begin_info.setRenderPass( m_vkPipeline->getRenderPass( ) );
         render_pass_begin_info.setFramebuffer( m_vkFrameBuffers[ it_index ].get( ) );
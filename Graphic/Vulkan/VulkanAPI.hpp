@@ -18,6 +18,7 @@
 #include "Utility/Singleton.hpp"
 
 #include <atomic>
+#include <cassert>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -91,8 +92,74 @@ struct TexturedVertex : VertexDetail {
         return bindingDescription;
     }
 };
+
+/*
+ *
+ * Chunk mesh vertex, 8 bytes instead of the 32 of TexturedVertex
+ *
+ * Position is relative to the chunk origin, which comes from the per instance binding 1, one entry per indirect draw
+ * Layout has to be kept in sync with the decoding in vertex_buffer.vert
+ *
+ * */
+struct PackedChunkVertex : VertexDetail {
+    using ChunkOriginTy = glm::ivec3;
+
+    // x:5 y:9 z:5 face:3 ambient occlusion:2 atlas x:8
+    uint32_t position_face_ao_atlasX = 0;
+
+    // atlas y:8 accumulated u:9 accumulated v:9, in blocks
+    uint32_t atlasY_accumulated = 0;
+
+    constexpr PackedChunkVertex( ) = default;
+    constexpr PackedChunkVertex( glm::ivec3 position, uint32_t face, uint32_t ambientOcclusion, glm::uvec2 atlasCell, glm::uvec2 accumulatedTextureCoordinate )
+        : position_face_ao_atlasX( position.x | ( position.y << 5 ) | ( position.z << 14 ) | ( face << 19 ) | ( ambientOcclusion << 22 ) | ( atlasCell.x << 24 ) )
+        , atlasY_accumulated( atlasCell.y | ( accumulatedTextureCoordinate.x << 8 ) | ( accumulatedTextureCoordinate.y << 17 ) )
+    {
+        assert( position.x >= 0 && position.x < ( 1 << 5 ) && position.y >= 0 && position.y < ( 1 << 9 ) && position.z >= 0 && position.z < ( 1 << 5 ) );
+        assert( face < ( 1 << 3 ) && ambientOcclusion < ( 1 << 2 ) );
+        assert( atlasCell.x < ( 1 << 8 ) && atlasCell.y < ( 1 << 8 ) );
+        assert( accumulatedTextureCoordinate.x < ( 1 << 9 ) && accumulatedTextureCoordinate.y < ( 1 << 9 ) );
+    }
+
+    static std::vector<vk::VertexInputAttributeDescription> getAttributeDescriptions( )
+    {
+        std::vector<vk::VertexInputAttributeDescription> attributeDescriptions( 2 );
+
+        attributeDescriptions[ 0 ].setBinding( 0 );
+        attributeDescriptions[ 0 ].setLocation( 0 );
+        attributeDescriptions[ 0 ].setFormat( vk::Format::eR32G32Uint );
+        attributeDescriptions[ 0 ].setOffset( offsetof( PackedChunkVertex, position_face_ao_atlasX ) );
+
+        attributeDescriptions[ 1 ].setBinding( 1 );
+        attributeDescriptions[ 1 ].setLocation( 1 );
+        attributeDescriptions[ 1 ].setFormat( vk::Format::eR32G32B32Sint );
+        attributeDescriptions[ 1 ].setOffset( 0 );
+
+        return attributeDescriptions;
+    }
+
+    static std::vector<vk::VertexInputBindingDescription> getBindingDescriptions( )
+    {
+        std::vector<vk::VertexInputBindingDescription> bindingDescription( 2 );
+
+        bindingDescription[ 0 ].setBinding( 0 );
+        bindingDescription[ 0 ].setStride( sizeof( PackedChunkVertex ) );
+        bindingDescription[ 0 ].setInputRate( vk::VertexInputRate::eVertex );
+
+        bindingDescription[ 1 ].setBinding( 1 );
+        bindingDescription[ 1 ].setStride( sizeof( ChunkOriginTy ) );
+        bindingDescription[ 1 ].setInputRate( vk::VertexInputRate::eInstance );
+
+        return bindingDescription;
+    }
+};
+
+static_assert( sizeof( PackedChunkVertex ) == 8 );
 }   // namespace DataType
 
+// Resources folder, searched upward from the working directory
+std::string FindResourcePath( );
+
 class VulkanAPI : public Singleton<VulkanAPI>
 {
 
@@ -157,6 +224,7 @@ public:
 
     [[nodiscard]] uint32_t acquireNextImage( );
     void                   setRenderer( std::function<void( const vk::CommandBuffer&, uint32_t index )>&& renderer ) { m_renderer = std::move( renderer ); };
+    void                   setPreRenderer( std::function<void( const vk::CommandBuffer&, uint32_t index )>&& preRenderer ) { m_pre_renderer = std::move( preRenderer ); };
     void                   setPipelineCreateCallback( std::function<void( )>&& callback ) { m_pipeline_create_callback = std::move( callback ); };
     void                   setClearColor( const std::array<float, 4>& clearColor ) { m_clearValues[ 0 ].setColor( clearColor ); }
 
@@ -204,6 +272,18 @@ public:
     inline vk::PhysicalDevice&           getPhysicalDevice( ) { return m_vkPhysicalDevice; }
     inline vk::PhysicalDeviceProperties& getPhysicalDeviceProperties( ) { return m_vkPhysicalDeviceProperties; }
 
+    /*
+     *
+     * VK_KHR_draw_indirect_count, enabled when the device has it
+     *
+     * */
+    inline bool isDrawIndirectCountSupported( ) const { return m_drawIndirectCountSupported; }
+    inline void drawIndexedIndirectCount( const vk::CommandBuffer& commandBuffer, vk::Buffer buffer, vk::DeviceSize offset, vk::Buffer countBuffer, vk::DeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride )
+    {
+        assert( m_drawIndirectCountSupported );
+        commandBuffer.drawIndexedIndirectCountKHR( buffer, offset, countBuffer, countBufferOffset, maxDrawCount, stride, m_vkDynamicDispatch );
+    }
+
     inline const std::pair<uint32_t, uint32_t>& getDesiredQueueIndices( const void* key ) const
     {
         return m_saved_queue_index.at( m_requested_queue.at( key ).first );
@@ -217,6 +297,9 @@ public:
 
     inline auto                   GetTransferFamilyIndices( ) { return MakeMutexResources( m_vkTransfer_family_indices_mutex, m_vkTransfer_family_indices ); }
     inline auto&                  GetTransferCommandPool( ) { return m_vkTransferCommandPool; }
+    inline auto&                  getGraphicQueue( ) { return m_vkGraphicQueue; }
+    inline auto                   getGraphicFamilyIndex( ) const { return m_vkQueue_family_indices.graphicsFamily.first; }
+    inline auto                   getCurrentRenderFence( ) const { return m_vkRender_fence_syncs[ m_sync_index ].get( ); }   // signaled by the next presentFrame
     inline auto&                  getMemoryAllocator( ) { return m_vkmAllocator; }
     inline auto&                  getDepthBufferImage( ) { return m_vkSwap_chain_depth_image.GetImage( ); }
     inline const auto&            getPipelineLayout( ) { return *m_vkPipeline->m_vkPipelineLayout; }
@@ -291,6 +374,7 @@ private:
     vk::PhysicalDevice           m_vkPhysicalDevice;
     vk::UniqueSurfaceKHR         m_vkSurface;
     vk::UniqueDevice             m_vkLogicalDevice;
+    bool                         m_drawIndirectCountSupported = false;
 
     /*
      *
@@ -362,6 +446,7 @@ private:
      * */
     std::unordered_map<const void*, std::pair<size_t, vk::QueueFlagBits>> m_requested_queue;
     std::function<void( const vk::CommandBuffer&, uint32_t index )>       m_renderer;
+    std::function<void( const vk::CommandBuffer&, uint32_t index )>       m_pre_renderer;   // before the render pass, for transfers
     std::function<void( )>                                                m_pipeline_create_callback;
     std::array<vk::ClearValue, 2>                                         m_clearValues { vk::ClearValue { vk::ClearColorValue { std::array<float, 4> { 0.0515186f, 0.504163f, 0.656863f, 1.0f } } }, vk::ClearValue { vk::ClearDepthStencilValue { 1.f, 0 } } };
 };
@@ -457,7 +457,8 @@ public:
         }
     }
 
-private:
+    // protected for batched evaluation in MinecraftNoise
+protected:
     template <typename T>
     struct Arguments_must_be_floating_point_values;
 
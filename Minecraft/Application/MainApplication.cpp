@@ -12,6 +12,8 @@
 #include "Utility/Timer.hpp"
 #include <Utility/ImguiAddons/CurveEditor.hpp>
 #include <Utility/Logger.hpp>
+#include <Utility/Memory/SlabPool.hpp>
+#include <Utility/Thread/EpochReclamation.hpp>
 #include <Utility/Singleton.hpp>
 #include <Utility/Vulkan/ValidationLayer.hpp>
 #include <Utility/Vulkan/VulkanExtension.hpp>
@@ -52,6 +54,17 @@ MainApplication::MainApplication( )
     InitImgui( );
 
     m_ChunkSolidBuffers = std::make_unique<ChunkSolidBuffer>( );
+    m_FrameStagingRing  = std::make_unique<StagingRing>( );
+    m_FrameStagingRing->Create( FrameStagingRingSize, vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eIndirectBuffer );
+
+    if ( m_graphics_api->isDrawIndirectCountSupported( ) )
+    {
+        m_ChunkCullPass = std::make_unique<ChunkCullPass>( );
+        m_ChunkCulling  = eGPUChunkCulling;
+    }
+
+    if ( const auto& renderDistance = GlobalConfig::getMinecraftConfigData( )[ "chunk" ][ "render_distance" ]; renderDistance.is_number( ) )
+        m_ChunkRenderDistance = renderDistance.get<float>( );
 
     m_MinecraftInstance = std::make_unique<Minecraft>( );
     m_MinecraftInstance->InitServer( );
@@ -82,7 +95,11 @@ MainApplication::~MainApplication( )
     m_imguiDescriptorPool.reset( );
 
     m_MinecraftInstance.reset( );
-    m_ChunkSolidBuffers->Clean( );
+
+    // shared quad index buffer, staging rings and readback buffers have to go before the allocator
+    m_ChunkCullPass.reset( );
+    m_ChunkSolidBuffers.reset( );
+    m_FrameStagingRing.reset( );
 
     m_graphics_api.reset( );
     cleanUp( );
@@ -91,13 +108,14 @@ MainApplication::~MainApplication( )
 void
 MainApplication::run( )
 {
-    const auto              swapChainImagesCount = m_graphics_api->getSwapChainImagesCount( );
-    std::vector<BufferMeta> uniformBuffers( swapChainImagesCount );
-    const auto              updateDescriptorSet = [ this, swapChainImagesCount, &uniformBuffers, &blockTextures = std::as_const( m_MinecraftInstance->GetBlockTextures( ) ) ]( ) {
+    const auto swapChainImagesCount = m_graphics_api->getSwapChainImagesCount( );
+    const auto uboAlignment         = m_graphics_api->getPhysicalDeviceProperties( ).limits.minUniformBufferOffsetAlignment;
+    const auto updateDescriptorSet  = [ this, swapChainImagesCount, &blockTextures = std::as_const( m_MinecraftInstance->GetBlockTextures( ) ) ]( ) {
         for ( size_t i = 0; i < swapChainImagesCount; i++ )
         {
+            // dynamic offset picks this frame's copy in the ring
             vk::DescriptorBufferInfo bufferInfo;
-            bufferInfo.setBuffer( uniformBuffers[ i ].GetBuffer( ) )
+            bufferInfo.setBuffer( m_FrameStagingRing->GetBuffer( ) )
                 .setOffset( 0 )
                 .setRange( sizeof( BlockTransformUBO ) );
 
@@ -106,7 +124,7 @@ MainApplication::run( )
 
             std::vector<vk::WriteDescriptorSet> writeDescriptorSets = { m_graphics_api->getWriteDescriptorSetSetup( i ), m_graphics_api->getWriteDescriptorSetSetup( i ) };
 
-            writeDescriptorSets[ 0 ].setDstBinding( 0 ).setDstArrayElement( 0 ).setDescriptorType( vk::DescriptorType::eUniformBuffer ).setDescriptorCount( 1 ).setBufferInfo( bufferInfo );
+            writeDescriptorSets[ 0 ].setDstBinding( 0 ).setDstArrayElement( 0 ).setDescriptorType( vk::DescriptorType::eUniformBufferDynamic ).setDescriptorCount( 1 ).setBufferInfo( bufferInfo );
             writeDescriptorSets[ 1 ].setDstBinding( 1 ).setDstArrayElement( 0 ).setDescriptorType( vk::DescriptorType::eCombinedImageSampler ).setDescriptorCount( 1 ).setImageInfo( imageInfo );
 
             m_graphics_api->getLogicalDevice( )
@@ -115,12 +133,6 @@ MainApplication::run( )
     };
 
     {
-        for ( auto& buffer : uniformBuffers )
-        {
-            buffer.SetAllocator( );
-            buffer.Create( sizeof( BlockTransformUBO ), vk::BufferUsageFlagBits::eUniformBuffer );
-        }
-
         renderUBOs         = std::make_unique<UBOData[]>( swapChainImagesCount );
         const auto& player = MinecraftServer::GetInstance( ).GetPlayer( 0 );
         for ( int i = 0; i < swapChainImagesCount; ++i )
@@ -134,7 +146,13 @@ MainApplication::run( )
         m_graphics_api->setPipelineCreateCallback( updateDescriptorSet );
     }
 
-    m_graphics_api->setRenderer( [ &uniformBuffers, this ]( const vk::CommandBuffer& command_buffer, uint32_t index ) {
+    const glm::vec3 chunkDrawExtent { SectionUnitLength, SectionUnitLength, SectionUnitLength };
+    m_graphics_api->setPreRenderer( [ uboAlignment, chunkDrawExtent, this ]( const vk::CommandBuffer& command_buffer, uint32_t index ) {
+        // changed draw commands are copied from the frame ring
+        m_ChunkSolidBuffers->UpdateAllIndirectDrawBuffers( *m_FrameStagingRing, command_buffer );
+
+        m_FrameUniformAllocation = { };
+        m_FrameChunkDraws.clear( );
         if ( m_screen_width * m_screen_height == 0 )
             return;   // window minimized, not render
 
@@ -155,25 +173,106 @@ MainApplication::run( )
         else
             renderUBOs[ index ].ubo.highlightCoordinate = { -1, -1, -1 };
 
-        uniformBuffers[ index ].writeBuffer( &renderUBOs[ index ].ubo, sizeof( BlockTransformUBO ) );
-        command_buffer.bindDescriptorSets( vk::PipelineBindPoint::eGraphics, m_graphics_api->getPipelineLayout( ), 0, m_graphics_api->getDescriptorSets( )[ index ], nullptr );
+        m_FrameUniformAllocation = m_FrameStagingRing->Write( &renderUBOs[ index ].ubo, sizeof( BlockTransformUBO ), uboAlignment );
+        if ( !m_FrameUniformAllocation ) return;
+
+        ChunkCullView cullView;
+        cullView.frustum        = Frustum( renderUBOs[ index ].ubo.proj * renderUBOs[ index ].ubo.view );
+        cullView.cameraPosition = glm::vec3( glm::inverse( renderUBOs[ index ].ubo.view )[ 3 ] );
+        cullView.maxDistance    = m_ChunkRenderDistance;
+        cullView.drawExtent     = chunkDrawExtent;
 
-        m_renderingChunkCount = 0;
+        std::vector<ChunkCullPass::DrawTable>       drawTables;
+        std::vector<vk::DrawIndexedIndirectCommand> visibleCommands;
+        uint32_t                                    totalDraws = 0, drawnDraws = 0;
 
+        // Buffer chunks snapshotted by UpdateAllIndirectDrawBuffers, m_Buffers can grow on remesh workers meanwhile
+        // frameDrawCount is only written by UpdateAllIndirectDrawBuffers on this thread
+        for ( auto* bufferChunk : m_ChunkSolidBuffers->m_FrameBuffers )
         {
-            // this is ok, I guess
-            // std::lock_guard renderBufferLock( chunkPool.GetRenderBufferLock( ) );
-            for ( auto& buffer : m_ChunkSolidBuffers->m_Buffers )
+            auto& buffer = *bufferChunk;
+
+            if ( buffer.frameDrawCount == 0 ) continue;
+            totalDraws += buffer.frameDrawCount;
+
+            // whole table unless culled
+            ChunkDraw draw { buffer.buffer, buffer.drawOriginBuffer->GetBuffer( ), buffer.indirectCommandBuffer->GetBuffer( ), 0, { }, buffer.frameDrawCount };
+
+            if ( m_ChunkCulling == eGPUChunkCulling )
             {
-                if ( buffer.m_DataSlots.empty( ) || !buffer.indirectDrawBuffers.GetBuffer( ) ) continue;
+                ChunkCullPass::DrawTable table { buffer.indirectCommandBuffer->GetBuffer( ), buffer.drawOriginBuffer->GetBuffer( ), buffer.culledCommandBuffer->GetBuffer( ), buffer.drawCountBuffer->GetBuffer( ), buffer.frameDrawCount };
+
+                if ( m_ChunkCullPass->IsValidating( ) )
+                {
+                    std::lock_guard<std::mutex> lock( buffer.indirectDrawBuffersMutex );
 
-                std::lock_guard<std::mutex> indirectDrawBufferLock( buffer.indirectDrawBuffersMutex );
-                command_buffer.bindVertexBuffers( 0, buffer.buffer, vk::DeviceSize( 0 ) );
+                    // changed since the upload above, the device table is not the same
+                    if ( buffer.dirtySlots.empty( ) && buffer.indirectCommands.size( ) == buffer.frameDrawCount )
+                        table.referenceVisibleCount = cullView.Cull( buffer.indirectCommands, buffer.drawOrigins );
+                }
 
-                static_assert( std::is_same<IndexBufferType, uint32_t>::value );
-                command_buffer.bindIndexBuffer( buffer.buffer, 0, vk::IndexType::eUint32 );
+                drawTables.push_back( table );
+                draw.commandBuffer = buffer.culledCommandBuffer->GetBuffer( );
+                draw.countBuffer   = buffer.drawCountBuffer->GetBuffer( );
+            } else if ( m_ChunkCulling == eCPUChunkCulling )
+            {
+                std::lock_guard<std::mutex> lock( buffer.indirectDrawBuffersMutex );
 
-                command_buffer.drawIndexedIndirect( buffer.indirectDrawBuffers.GetBuffer( ), 0, (uint32_t) buffer.indirectCommands.size( ), sizeof( vk::DrawIndexedIndirectCommand ) );
+                if ( buffer.dirtySlots.empty( ) && buffer.indirectCommands.size( ) == buffer.frameDrawCount )
+                {
+                    visibleCommands.clear( );
+                    if ( cullView.Cull( buffer.indirectCommands, buffer.drawOrigins, &visibleCommands ) == 0 ) continue;
+
+                    // ring full, draw the whole table
+                    if ( const auto stagedCommands = m_FrameStagingRing->Write( visibleCommands.data( ), visibleCommands.size( ) * sizeof( vk::DrawIndexedIndirectCommand ) ) )
+                    {
+                        draw.commandBuffer = stagedCommands.buffer;
+                        draw.commandOffset = stagedCommands.offset;
+                        draw.drawCount     = (uint32_t) visibleCommands.size( );
+                    }
+                }
+            }
+
+            drawnDraws += draw.drawCount;
+            m_FrameChunkDraws.push_back( draw );
+        }
+
+        if ( m_ChunkCulling == eGPUChunkCulling )
+        {
+            const vk::DescriptorBufferInfo uniform { m_FrameStagingRing->GetBuffer( ), 0, sizeof( BlockTransformUBO ) };
+            m_ChunkCullPass->Record( command_buffer, index, uniform, (uint32_t) m_FrameUniformAllocation.offset, drawTables, cullView );
+
+            // only known through validation, some frames late
+            if ( m_ChunkCullPass->IsValidating( ) ) drawnDraws = std::min( totalDraws, m_ChunkCullPass->GetStatistics( ).gpuVisibleDraws );
+        }
+
+        m_renderingChunkCount = drawnDraws;
+        m_culledChunkCount    = totalDraws - drawnDraws;
+    } );
+
+    m_graphics_api->setRenderer( [ this ]( const vk::CommandBuffer& command_buffer, uint32_t index ) {
+        if ( m_screen_width * m_screen_height == 0 )
+            return;   // window minimized, not render
+
+        if ( m_FrameUniformAllocation )
+        {
+            const auto uboOffset = (uint32_t) m_FrameUniformAllocation.offset;
+            command_buffer.bindDescriptorSets( vk::PipelineBindPoint::eGraphics, m_graphics_api->getPipelineLayout( ), 0, m_graphics_api->getDescriptorSets( )[ index ], uboOffset );
+
+            const VulkanPipeline::PushConstants pushConstants { (float) m_MinecraftInstance->GetBlockTextures( ).GetTextureResolution( ) };
+            command_buffer.pushConstants( m_graphics_api->getPipelineLayout( ), VulkanPipeline::PushConstantStages, 0, sizeof( pushConstants ), &pushConstants );
+
+            static_assert( std::is_same<IndexBufferType, uint32_t>::value );
+            command_buffer.bindIndexBuffer( m_ChunkSolidBuffers->GetQuadIndexBuffer( ).GetBuffer( ), 0, vk::IndexType::eUint32 );
+
+            for ( const auto& draw : m_FrameChunkDraws )
+            {
+                command_buffer.bindVertexBuffers( 0, { draw.vertexBuffer, draw.originBuffer }, { vk::DeviceSize( 0 ), vk::DeviceSize( 0 ) } );
+
+                if ( draw.countBuffer )
+                    m_graphics_api->drawIndexedIndirectCount( command_buffer, draw.commandBuffer, draw.commandOffset, draw.countBuffer, 0, draw.drawCount, sizeof( vk::DrawIndexedIndirectCommand ) );
+                else
+                    command_buffer.drawIndexedIndirect( draw.commandBuffer, draw.commandOffset, draw.drawCount, sizeof( vk::DrawIndexedIndirectCommand ) );
             }
 
             // Logger::getInstance( ).LogLine( renderBuffer.m_Buffers.size( ) );
@@ -435,7 +534,9 @@ MainApplication::renderThread( const std::stop_token& st )
 
         // just to delete outdated buffer
         m_ChunkSolidBuffers->Tick( 0 );
-        m_ChunkSolidBuffers->UpdateAllIndirectDrawBuffers( );
+        m_FrameStagingRing->Retire( );
+        m_ChunkSolidBuffers->FlushUploads( );
+        m_ChunkSolidBuffers->Compact( ChunkCompactionBytesPerFrame );
 
         /*
          *
@@ -452,11 +553,17 @@ MainApplication::renderThread( const std::stop_token& st )
          * */
 
         const uint32_t image_index = m_graphics_api->acquireNextImage( );
+        const auto     frameFence  = m_graphics_api->getCurrentRenderFence( );
         m_graphics_api->cycleGraphicCommandBuffers( image_index );
+
+        // flushed before the frame is submitted
+        m_FrameStagingRing->Release( frameFence );
         m_graphics_api->presentFrame<false>( image_index );
 
         if ( m_ShouldReset )
         {
+            // fences are recreated, ring can't keep them
+            m_FrameStagingRing->Retire( true );
             m_graphics_api->FlushFence( );
             // m_graphics_api->waitPresent( );
             MinecraftServer::GetInstance( ).GetWorld( ).StopChunkGeneration( );
@@ -757,8 +864,10 @@ MainApplication::renderImgui( uint32_t renderIndex )
                 static float            t         = 0;
                 static float            previousT = 0;
                 static float            history   = 10.0f;
-                static ImVector<ImVec2> chunkLoadingThreadCount, chunkCount, chunkRenderCount;
-                auto&                   chunkPool = MinecraftServer::GetInstance( ).GetWorld( ).GetChunkPool( );
+                static ImVector<ImVec2>                       chunkLoadingThreadCount, chunkCount, chunkRenderCount;
+                static TLSFAllocator::Statistics              meshMemory;
+                static ChunkSolidBuffer::CompactionStatistics compaction;
+                auto&                                         chunkPool = MinecraftServer::GetInstance( ).GetWorld( ).GetChunkPool( );
 
                 t += ImGui::GetIO( ).DeltaTime;
                 ImGui::SliderFloat( "History", &history, 1, 30, "%.1f s" );
@@ -776,6 +885,8 @@ MainApplication::renderImgui( uint32_t renderIndex )
                     chunkLoadingThreadCount.push_back( ImVec2( xmod, (float) chunkPool.GetLoadingCount( ) ) );
                     chunkCount.push_back( ImVec2( xmod, (float) chunkPool.GetTotalChunk( ) ) );
                     chunkRenderCount.push_back( ImVec2( xmod, (float) m_renderingChunkCount ) );
+                    meshMemory = m_ChunkSolidBuffers->GetAllocationStatistics( );
+                    compaction = m_ChunkSolidBuffers->GetCompactionStatistics( );
                 }
 
                 static ScrollingBuffer fps;
@@ -809,6 +920,89 @@ MainApplication::renderImgui( uint32_t renderIndex )
                     ImPlot::EndPlot( );
                 }
 
+                {
+                    const char* statusName[] = { "Empty", "StructureStart", "StructureReference", "Noise", "Feature" };
+                    static_assert( std::size( statusName ) == ChunkStatusSize );
+
+                    ImGui::Text( "Queue depth" );
+                    for ( int i = 0; i < ChunkStatusSize; ++i )
+                        ImGui::BulletText( "%-20s %u", statusName[ i ], chunkPool.GetQueueDepth( static_cast<ChunkStatus>( i ) ) );
+
+                    ImGui::Text( "Wasted attempts %llu / %llu", (unsigned long long) chunkPool.GetWastedAttemptCount( ), (unsigned long long) chunkPool.GetAttemptCount( ) );
+                }
+
+                {
+                    auto&      remeshQueue = chunkPool.GetRemeshQueue( );
+                    const auto remesh      = remeshQueue.GetStatistics( );
+
+                    ImGui::Text( "Remesh queue" );
+                    ImGui::BulletText( "%-20s %zu", "Pending", remeshQueue.GetPendingCount( ) );
+                    ImGui::BulletText( "%-20s %llu / %llu requests", "Coalesced", (unsigned long long) remesh.coalesced, (unsigned long long) remesh.requested );
+                    ImGui::BulletText( "%-20s %llu", "Remeshed", (unsigned long long) remesh.remeshed );
+                }
+
+                {
+                    constexpr double MiB = 1024.0 * 1024.0;
+
+                    auto&      meshCache = chunkPool.GetMeshCache( );
+                    const auto cache     = meshCache.GetStatistics( );
+
+                    ImGui::Text( "Mesh data cache" );
+                    ImGui::BulletText( "%-20s %zu / %u, %.1f MiB", "Sections", meshCache.GetSectionCount( ), meshCache.GetCapacity( ), meshCache.GetMemorySize( ) / MiB );
+                    ImGui::BulletText( "%-20s %llu / %llu lookups", "Hits", (unsigned long long) cache.hits, (unsigned long long) ( cache.hits + cache.misses ) );
+                    ImGui::BulletText( "%-20s %llu", "Evictions", (unsigned long long) cache.evictions );
+                }
+
+                {
+                    constexpr double MiB = 1024.0 * 1024.0;
+
+                    // system allocations only happen when a pool grows by a slab
+                    ImGui::Text( "Chunk allocations" );
+                    for ( auto* pool : SlabPool::GetPools( ) )
+                    {
+                        const auto statistics = pool->GetStatistics( );
+                        ImGui::BulletText( "%-20s %llu, %llu from system, %u / %u in use, %.1f MiB",
+                                           pool->GetName( ).c_str( ),
+                                           (unsigned long long) statistics.allocations,
+                                           (unsigned long long) statistics.slabAllocations,
+                                           statistics.blocksInUse,
+                                           statistics.blockCapacity,
+                                           statistics.blockCapacity * pool->GetBlockSize( ) / MiB );
+                    }
+                }
+
+                {
+                    constexpr double MiB = 1024.0 * 1024.0;
+
+                    ImGui::Text( "Chunk mesh memory" );
+                    ImGui::BulletText( "%-20s %.1f / %.1f MiB in %llu buffers", "Used", meshMemory.usedSize / MiB, meshMemory.capacity / MiB, (unsigned long long) ( meshMemory.capacity / MaxMemoryAllocation ) );
+                    ImGui::BulletText( "%-20s %u", "Allocations", meshMemory.allocationCount );
+                    ImGui::BulletText( "%-20s %u, largest %.1f MiB", "Free blocks", meshMemory.freeBlockCount, meshMemory.largestFreeBlock / MiB );
+                    ImGui::BulletText( "%-20s %.1f%%", "Fragmentation", meshMemory.GetFragmentation( ) * 100 );
+                    ImGui::BulletText( "%-20s %.1f MiB in %u regions, %u buffers released", "Compacted", compaction.bytesMoved / MiB, compaction.regionsMoved, compaction.buffersReleased );
+                }
+
+                {
+                    const char* cullingName[] = { "None", "CPU", "GPU" };
+                    int         culling       = m_ChunkCulling;
+
+                    ImGui::Text( "Chunk culling" );
+                    if ( ImGui::Combo( "Culling", &culling, cullingName, m_ChunkCullPass ? 3 : 2 ) ) m_ChunkCulling = static_cast<ChunkCulling>( culling );
+                    ImGui::SliderFloat( "Render distance", &m_ChunkRenderDistance, 0, 1024, m_ChunkRenderDistance > 0 ? "%.0f blocks" : "No limit" );
+                    ImGui::BulletText( "%-20s %u", "Drawn", m_renderingChunkCount );
+                    ImGui::BulletText( "%-20s %u", "Culled", m_culledChunkCount );
+
+                    if ( m_ChunkCullPass && m_ChunkCulling == eGPUChunkCulling )
+                    {
+                        bool validate = m_ChunkCullPass->IsValidating( );
+                        if ( ImGui::Checkbox( "Validate against CPU reference", &validate ) ) m_ChunkCullPass->SetValidation( validate );
+
+                        const auto& statistics = m_ChunkCullPass->GetStatistics( );
+                        ImGui::BulletText( "%-20s %u / %u, cpu %u", "GPU visible", statistics.gpuVisibleDraws, statistics.totalDraws, statistics.cpuVisibleDraws );
+                        ImGui::BulletText( "%-20s %llu / %llu", "Mismatched frames", (unsigned long long) statistics.mismatchedFrames, (unsigned long long) statistics.comparedFrames );
+                    }
+                }
+
                 // ImGui::TreePop();
             }
 
@@ -816,6 +1010,17 @@ MainApplication::renderImgui( uint32_t renderIndex )
             {
                 if ( m_TerrainNoiseOffset.Render( ) ) std::cout << m_TerrainNoiseOffset << std::endl;
 
+                {
+                    auto&       world              = MinecraftServer::GetInstance( ).GetWorld( );
+                    int         terrainSampling    = world.GetTerrainSampling( );
+                    const char* terrainSamplings[] = {
+                        "Full",
+                        "Sparse (4x8x4)" };
+
+                    if ( ImGui::Combo( "TerrainSampling", &terrainSampling, terrainSamplings, IM_ARRAYSIZE( terrainSamplings ) ) )
+                        world.SetTerrainSampling( static_cast<MinecraftWorld::TerrainSampling>( terrainSampling ) );
+                }
+
                 auto&      terrainNoise   = MinecraftServer::GetInstance( ).GetWorld( ).GetModifiableTerrainNoise( );
                 static int noiseTypeIndex = 0;
 
@@ -1053,7 +1258,7 @@ MainApplication::RenderThreadMouseHandle( )
     if ( m_is_mouse_locked && m_UserInput.GetFunctionKey( ).isPressed )
         if ( playerRaycastResult.hasSolidHit )
         {
-            if ( auto* block = MinecraftServer::GetInstance( ).GetWorld( ).GetBlock( playerRaycastResult.solidHit ) )
+            if ( auto block = MinecraftServer::GetInstance( ).GetWorld( ).GetBlock( playerRaycastResult.solidHit ) )
             {
                 player.SetBlockHolding( *block );
                 LOGL_VERB( "User picked block", toString( *block ).c_str( ) );
@@ -1065,23 +1270,25 @@ MainApplication::RenderThreadMouseHandle( )
 
     if ( playerRaycastResult.hasSolidHit )
     {
-
-        if ( auto chunkCache = MinecraftServer::GetInstance( ).GetWorld( ).GetChunkCacheSafe( ToChunkCoordinate( playerRaycastResult.solidHit ) >> IntLog<SectionUnitLength, 2>::value );
+        EpochGuard epochGuard;
+        if ( auto* chunkCache = MinecraftServer::GetInstance( ).GetWorld( ).GetChunkCacheSafe( ToChunkCoordinate( playerRaycastResult.solidHit ) >> IntLog<SectionUnitLength, 2>::value );
              chunkCache != nullptr )
         {
             const auto inChunkBlockCoordinate = MakeMinecraftCoordinate( GetMinecraftX( playerRaycastResult.solidHit ) & ( SectionUnitLength - 1 ), GetMinecraftY( playerRaycastResult.solidHit ), GetMinecraftZ( playerRaycastResult.solidHit ) & ( SectionUnitLength - 1 ) );
             const auto blockCoordinate        = Chunk::GetBlockIndex( inChunkBlockCoordinate );
-            const auto chunkComplete          = chunkCache->IsChunkStatusAtLeast( ChunkStatus::eFull ) && chunkCache->IsCacheReady( ) && chunkCache->initialized;
+            const auto chunkComplete          = chunkCache->IsChunkStatusAtLeast( ChunkStatus::eFull ) && chunkCache->initialized;
             if ( chunkComplete )
             {
                 std::lock_guard lock( m_BlockDetailLock );
                 m_BlockDetailMap.clear( );
 
                 m_BlockDetailMap.emplace_back( "Name", toString( chunkCache->At( blockCoordinate ) ) );
+                // near chunks are linked and unlinked under it
+                std::lock_guard chunkLock( chunkCache->m_SyncMutex );
                 if ( chunkCache->NeighborCompleted( ) )
                 {
-                    const auto  transparency = chunkCache->GetNeighborTransparency( blockCoordinate );
-                    const auto& vertexMeta   = chunkCache->GetCubeVertexMetaData( blockCoordinate );
+                    const auto transparency = chunkCache->ComputeNeighborTransparency( blockCoordinate );
+                    const auto vertexMeta   = chunkCache->ComputeCubeVertexMetaData( blockCoordinate, transparency );
 
 #define BoolToString( b ) b ? "True" : "false"
 
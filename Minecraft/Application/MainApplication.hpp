@@ -6,9 +6,11 @@
 #define MINECRAFT_VK_VULKAN_MAINAPPLICATION_HPP
 
 
+#include <Graphic/Vulkan/StagingRing.hpp>
 #include <Graphic/Vulkan/VulkanAPI.hpp>
 #include <Minecraft/Application/Input/UserInput.hpp>
 #include <Minecraft/Minecraft.hpp>
+#include <Minecraft/World/Chunk/ChunkCullPass.hpp>
 #include <Minecraft/World/Chunk/RenderableChunk.hpp>
 #include <Utility/ImguiAddons/CurveEditor.hpp>
 
@@ -66,6 +68,38 @@ class MainApplication : public Singleton<MainApplication>
 
     std::unique_ptr<ChunkSolidBuffer> m_ChunkSolidBuffers;
 
+    // Uniforms and draw commands of the frame being recorded, released with the frame's render fence
+    std::unique_ptr<StagingRing> m_FrameStagingRing;
+    StagingRing::Allocation      m_FrameUniformAllocation;   // written by the pre-renderer
+
+    /*
+     *
+     * Chunk culling
+     *
+     * The pre-renderer tests every draw against the frame's frustum and render distance and builds m_FrameChunkDraws
+     * CPU culling writes the visible commands to the frame ring, GPU culling needs draw indirect count
+     * A table changed after its upload is drawn whole on the CPU path, the origins on the device are the uploaded ones
+     *
+     * */
+    enum ChunkCulling : uint8_t {
+        eNoChunkCulling,
+        eCPUChunkCulling,
+        eGPUChunkCulling
+    };
+
+    struct ChunkDraw {
+        vk::Buffer     vertexBuffer, originBuffer;
+        vk::Buffer     commandBuffer;
+        vk::DeviceSize commandOffset = 0;
+        vk::Buffer     countBuffer { };   // draw count is read from it if set, drawCount is then the maximum
+        uint32_t       drawCount = 0;
+    };
+
+    std::unique_ptr<ChunkCullPass> m_ChunkCullPass;   // null without draw indirect count support
+    ChunkCulling                   m_ChunkCulling        = eCPUChunkCulling;
+    float                          m_ChunkRenderDistance = 0;   // blocks, 0 for no limit
+    std::vector<ChunkDraw>         m_FrameChunkDraws;
+
     /*
      *
      * Minecraft
@@ -88,6 +122,7 @@ class MainApplication : public Singleton<MainApplication>
      *
      * */
     uint32_t m_renderingChunkCount = 0;
+    uint32_t m_culledChunkCount    = 0;
 
     void InitWindow( );
     void InitImgui( );
@@ -129,7 +129,18 @@ BlockTexture::BlockTexture( const std::string& folder )
     const auto textureAtlasesWidth  = (uint32_t) std::floor( std::sqrt( totalTexture ) );
     const auto textureAtlasesHeight = (uint32_t) std::ceil( (float) totalTexture / (float) textureAtlasesWidth );
 
-    const auto textureResolution = textureSpec[ "resolution" ].get<uint32_t>( );
+    // given to the shaders as a push constant, see VulkanPipeline::PushConstants
+    const auto textureResolution = m_TextureResolution = textureSpec[ "resolution" ].get<uint32_t>( );
+    if ( textureResolution == 0 )
+    {
+        throw std::runtime_error( "texture resolution must not be 0" );
+    }
+
+    // DataType::PackedChunkVertex only has 8 bits for each atlas cell coordinate
+    if ( textureAtlasesWidth > 256 || textureAtlasesHeight > 256 )
+    {
+        throw std::runtime_error( "texture atlas larger than 256 x 256 textures" );
+    }
 
     textureImage.SetAllocator( );
     textureImage.Create( textureAtlasesWidth * textureResolution, textureAtlasesHeight * textureResolution, vk::Format::eR8G8B8A8Srgb, vk::ImageTiling::eOptimal, vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled, VMA_MEMORY_USAGE_GPU_ONLY, VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT );
@@ -191,6 +202,7 @@ BlockTexture::BlockTexture( const std::string& folder )
 
             m_BlockTextureIndices[ i ][ j ] = (uint32_t) m_TextureList.size( );
             m_TextureList.push_back( textureFace );
+            m_TextureAtlasCells.emplace_back( x, y );
 
             //            m_BlockTextures[ i ][ j ][ 0 ].textureCoor = {0, 0};
             //            m_BlockTextures[ i ][ j ][ 1 ].textureCoor = {1, 0};
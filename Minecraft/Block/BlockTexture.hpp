@@ -27,16 +27,21 @@ private:
     std::map<std::string, uint32_t> m_UniqueTexture;
 
     std::vector<std::array<DataType::TexturedVertex, FaceVerticesCount>> m_TextureList;
+    std::vector<glm::uvec2>                                              m_TextureAtlasCells;
 
     std::array<TextureIndices, BlockIDSize> m_BlockTextureIndices { };
 
+    uint32_t m_TextureResolution = 0;
+
 public:
     BlockTexture( const std::string& folder );
 
     inline const auto& GetTextureLocationByIndex( uint32_t id ) const { return m_TextureList.at( id ); }
+    inline const auto& GetTextureAtlasCellByIndex( uint32_t id ) const { return m_TextureAtlasCells.at( id ); }
     inline const auto& GetTextureIndices( BlockID id ) const { return m_BlockTextureIndices.at( id ); }
 
     inline auto        GetTotalUniqueTexture( ) const { return m_UniqueTexture.size( ); }
+    inline auto        GetTextureResolution( ) const { return m_TextureResolution; }
     inline const auto& GetTexture( ) const { return textureImage; }
 };
 
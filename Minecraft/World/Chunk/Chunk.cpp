@@ -3,30 +3,44 @@
 //
 
 #include "Chunk.hpp"
+#include "ChunkPayloadPool.hpp"
 #include <Minecraft/World/Generation/Structure/StructureTree.hpp>
 
 #include <Minecraft/Internet/MinecraftServer/MinecraftServer.hpp>
 
+#include <algorithm>
 #include <cmath>
 
-const Block*
+std::optional<Block>
 Chunk::CheckBlock( const BlockCoordinate& blockCoordinate ) const
 {
-    if ( GetMinecraftY( blockCoordinate ) >= ChunkMaxHeight || GetMinecraftY( blockCoordinate ) < 0 ) return nullptr;
-    return &At( GetBlockIndex( blockCoordinate ) );
+    if ( GetMinecraftY( blockCoordinate ) >= ChunkMaxHeight || GetMinecraftY( blockCoordinate ) < 0 ) return std::nullopt;
+    return At( GetBlockIndex( blockCoordinate ) );
 }
 
-Block*
-Chunk::GetBlock( const BlockCoordinate& blockCoordinate )
+std::optional<Block>
+Chunk::GetBlock( const BlockCoordinate& blockCoordinate ) const
 {
-    if ( GetMinecraftY( blockCoordinate ) >= ChunkMaxHeight || GetMinecraftY( blockCoordinate ) < 0 ) return nullptr;
-    return &At( GetBlockIndex( blockCoordinate ) );
+    return CheckBlock( blockCoordinate );
+}
+
+void
+Chunk::LoadBlocks( const Block* blocks )
+{
+    if ( m_Sections == nullptr ) m_Sections = MakeSlabPoolArray<PalettedBlockStorage>( ChunkPayloadPool::GetBlockSections( ), MaxSectionInChunk );
+
+    for ( int i = 0; i < MaxSectionInChunk; ++i )
+    {
+        const auto* sectionBlocks = blocks + ( i << SectionVolumeBinaryOffset );
+        m_Sections[ i ].Load( sectionBlocks );
+        m_SectionOpaqueCount[ i ] = static_cast<uint16_t>( std::count_if( sectionBlocks, sectionBlocks + SectionVolume, []( const Block& block ) { return !block.Transparent( ); } ) );
+    }
 }
 
 bool
 Chunk::SetBlock( const BlockCoordinate& blockCoordinate, const Block& block, bool replace )
 {
-    assert( m_Blocks != nullptr );
+    assert( m_Sections != nullptr );
     const auto& blockIndex = GetBlockIndex( blockCoordinate );
     return SetBlock( blockIndex, block, replace );
 }
@@ -34,10 +48,10 @@ Chunk::SetBlock( const BlockCoordinate& blockCoordinate, const Block& block, boo
 bool
 Chunk::SetBlock( const uint32_t& blockIndex, const Block& block, bool replace )
 {
-    assert( m_Blocks != nullptr && m_HeightMap != nullptr );
+    assert( m_Sections != nullptr && m_HeightMap != nullptr );
     assert( blockIndex >= 0 && blockIndex < ChunkVolume );
 
-    // Logger::getInstance( ).LogLine( Logger::LogType::eVerbose, "Setting block at chunk:", m_Position, "index:", blockIndex, "from:", toString( (BlockID) m_Blocks[ blockIndex ] ), "to:", toString( (BlockID) block ) );
+    // Logger::getInstance( ).LogLine( Logger::LogType::eVerbose, "Setting block at chunk:", m_Position, "index:", blockIndex, "from:", toString( (BlockID) At( blockIndex ) ), "to:", toString( (BlockID) block ) );
 
     if ( At( blockIndex ) == block ) return false;             // same block
     if ( !replace && At( blockIndex ) != Air ) return false;   // not replacing
@@ -63,7 +77,7 @@ Chunk::SetBlock( const uint32_t& blockIndex, const Block& block, bool replace )
         }
     }
 
-    At( blockIndex ) = block;
+    StoreBlock( blockIndex, block );
     return true;
 }
 
@@ -92,8 +106,53 @@ Chunk::SetBlockAtWorldCoordinate( const BlockCoordinate& blockCoordinate, const
     return SetBlock( GetBlockIndex( blockCoordinate - m_WorldCoordinate ), block, replace );
 }
 
+uint64_t
+Chunk::GetChecksum( ) const
+{
+    static constexpr uint64_t FNVOffsetBasis = 14695981039346656037ULL;
+    static constexpr uint64_t FNVPrime       = 1099511628211ULL;
+
+    uint64_t   checksum = FNVOffsetBasis;
+    const auto hashByte = [ &checksum ]( uint8_t byte ) {
+        checksum ^= byte;
+        checksum *= FNVPrime;
+    };
+
+    for ( const auto axis : { GetMinecraftX( m_Coordinate ), GetMinecraftZ( m_Coordinate ) } )
+        for ( int i = 0; i < 4; ++i )
+            hashByte( static_cast<uint8_t>( static_cast<uint32_t>( axis ) >> ( i * 8 ) ) );
+
+    if ( m_Sections == nullptr ) return checksum;
+
+    for ( uint32_t i = 0; i < ChunkVolume; ++i )
+        hashByte( static_cast<BlockID>( At( i ) ) );
+
+    return checksum;
+}
+
+size_t
+Chunk::GetBlockStorageSize( ) const
+{
+    if ( m_Sections == nullptr ) return 0;
+
+    size_t storageSize = sizeof( m_Sections[ 0 ] ) * MaxSectionInChunk;
+    for ( int i = 0; i < MaxSectionInChunk; ++i )
+        storageSize += m_Sections[ i ].GetAllocatedSize( );
+
+    return storageSize;
+}
+
+size_t
+Chunk::GetBlockStorageSaving( ) const
+{
+    if ( m_Sections == nullptr ) return 0;
+
+    const auto storageSize = GetBlockStorageSize( );
+    return storageSize < sizeof( Block ) * ChunkVolume ? sizeof( Block ) * ChunkVolume - storageSize : 0;
+}
+
 size_t
 Chunk::GetObjectSize( ) const
 {
-    return sizeof( Chunk ) + ( m_Blocks ? sizeof( m_Blocks[ 0 ] ) * ChunkVolume : 0 ) + ( m_HeightMap ? sizeof( m_HeightMap[ 0 ] ) * SectionSurfaceSize : 0 );
+    return sizeof( Chunk ) + GetBlockStorageSize( ) + ( m_HeightMap ? sizeof( m_HeightMap[ 0 ] ) * SectionSurfaceSize : 0 );
 }
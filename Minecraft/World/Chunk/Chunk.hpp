@@ -11,13 +11,16 @@
 #include <Minecraft/util/MinecraftConstants.hpp>
 #include <Minecraft/util/MinecraftType.h>
 
+#include <Utility/Memory/SlabPool.hpp>
 #include <Utility/Profiler/Profilable.hpp>
 
 #include "ChunkStatus.hpp"
+#include "PalettedBlockStorage.hpp"
 
 #include <array>
 #include <cmath>
 #include <memory>
+#include <optional>
 
 class Chunk : public AABB
     , public Profilable
@@ -28,10 +31,33 @@ protected:
     ChunkCoordinate m_Coordinate;
     BlockCoordinate m_WorldCoordinate;
 
-    std::unique_ptr<Block[]>   m_Blocks { };
-    std::unique_ptr<int32_t[]> m_HeightMap { };
+    // From ChunkPayloadPool
+    SlabPoolArray<PalettedBlockStorage> m_Sections { };
+    SlabPoolArray<int32_t>              m_HeightMap { };
+
+    // Non-transparent block count of each section, for occupancy
+    std::array<uint16_t, MaxSectionInChunk> m_SectionOpaqueCount { };
+
+    // Write without height map update
+    inline void StoreBlock( const uint32_t index, const Block& block )
+    {
+        assert( m_Sections != nullptr && index < ChunkVolume );
+
+        const auto sectionIndex   = index >> SectionVolumeBinaryOffset;
+        auto&      section        = m_Sections[ sectionIndex ];
+        const bool wasTransparent = section.Get( index & ( SectionVolume - 1 ) ).Transparent( );
+
+        section.Set( index & ( SectionVolume - 1 ), block );
+        if ( wasTransparent != block.Transparent( ) ) m_SectionOpaqueCount[ sectionIndex ] += wasTransparent ? 1 : -1;
+    }
 
 public:
+    enum SectionOccupancy : uint8_t {
+        eEmptySection,    // all transparent
+        eOpaqueSection,   // no transparent block
+        eMixedSection
+    };
+
     explicit Chunk( class MinecraftWorld* world )
         : m_World( world )
     { }
@@ -56,15 +82,34 @@ public:
      * Access tools
      *
      * */
-    [[nodiscard]] const Block* CheckBlock( const BlockCoordinate& blockCoordinate ) const;
-    [[nodiscard]] Block*       GetBlock( const BlockCoordinate& blockCoordinate );
+    [[nodiscard]] std::optional<Block> CheckBlock( const BlockCoordinate& blockCoordinate ) const;
+    [[nodiscard]] std::optional<Block> GetBlock( const BlockCoordinate& blockCoordinate ) const;
 
-    [[nodiscard]] inline Block& At( const uint32_t index ) const
+    // Blocks are palette compressed, write through SetBlock
+    [[nodiscard]] inline Block At( const uint32_t index ) const
     {
-        assert( m_Blocks != nullptr && index < ChunkVolume );
-        return m_Blocks[ index ];
+        assert( m_Sections != nullptr && index < ChunkVolume );
+        return m_Sections[ index >> SectionVolumeBinaryOffset ].Get( index & ( SectionVolume - 1 ) );
     }
 
+    [[nodiscard]] inline const PalettedBlockStorage& GetSection( const uint32_t sectionIndex ) const
+    {
+        assert( m_Sections != nullptr && sectionIndex < MaxSectionInChunk );
+        return m_Sections[ sectionIndex ];
+    }
+
+    [[nodiscard]] inline SectionOccupancy GetSectionOccupancy( const uint32_t sectionIndex ) const
+    {
+        assert( sectionIndex < MaxSectionInChunk );
+
+        if ( m_SectionOpaqueCount[ sectionIndex ] == 0 ) return eEmptySection;
+        if ( m_SectionOpaqueCount[ sectionIndex ] == SectionVolume ) return eOpaqueSection;
+        return eMixedSection;
+    }
+
+    // ChunkVolume blocks, compress into sections
+    void LoadBlocks( const Block* blocks );
+
     static inline auto indexToHeight( const auto& index ) { return index >> SectionSurfaceSizeBinaryOffset; }
     static inline int  GetBlockIndex( const BlockCoordinate& blockCoordinate )
     {
@@ -108,6 +153,17 @@ public:
         return ::MaxAxisDistance( m_Coordinate, other );
     }
 
+    /*
+     *
+     * FNV-1a over chunk coordinate and every block id, same seed should give same checksum
+     *
+     * */
+    [[nodiscard]] uint64_t GetChecksum( ) const;
+
+    // Bytes used by block sections, compare to ChunkVolume * sizeof( Block ) uncompressed
+    [[nodiscard]] size_t GetBlockStorageSize( ) const;
+    [[nodiscard]] size_t GetBlockStorageSaving( ) const;
+
     size_t GetObjectSize( ) const;
 };
 
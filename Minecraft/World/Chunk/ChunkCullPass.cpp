@@ -0,0 +1,189 @@
+#include "ChunkCullPass.hpp"
+
+#include <Graphic/Vulkan/Pipeline/VulkanShader.hpp>
+#include <Graphic/Vulkan/VulkanAPI.hpp>
+#include <Utility/Logger.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+
+ChunkCullPass::ChunkCullPass( )
+{
+    auto& device = VulkanAPI::GetInstance( ).getLogicalDevice( );
+
+    // ubo, commands, origins, culled commands, draw count
+    std::array<vk::DescriptorSetLayoutBinding, 5> bindings;
+    bindings[ 0 ].setBinding( 0 ).setDescriptorType( vk::DescriptorType::eUniformBufferDynamic ).setDescriptorCount( 1 ).setStageFlags( vk::ShaderStageFlagBits::eCompute );
+    for ( uint32_t i = 1; i < bindings.size( ); ++i )
+        bindings[ i ].setBinding( i ).setDescriptorType( vk::DescriptorType::eStorageBuffer ).setDescriptorCount( 1 ).setStageFlags( vk::ShaderStageFlagBits::eCompute );
+
+    vk::DescriptorSetLayoutCreateInfo layoutInfo;
+    layoutInfo.setBindings( bindings );
+    m_DescriptorSetLayout = device.createDescriptorSetLayoutUnique( layoutInfo );
+
+    const vk::PushConstantRange  pushConstantRange { vk::ShaderStageFlagBits::eCompute, 0, sizeof( PushConstants ) };
+    vk::PipelineLayoutCreateInfo pipelineLayoutInfo;
+    pipelineLayoutInfo.setSetLayouts( *m_DescriptorSetLayout ).setPushConstantRanges( pushConstantRange );
+    m_PipelineLayout = device.createPipelineLayoutUnique( pipelineLayoutInfo );
+
+    VulkanShader shader;
+    shader.InitComputeGLSLFile( device, FindResourcePath( ) + "/Shader/chunk_cull.comp" );
+
+    vk::ComputePipelineCreateInfo pipelineInfo;
+    pipelineInfo.setStage( { { }, vk::ShaderStageFlagBits::eCompute, shader.GetComputeShaderModule( ), "main" } ).setLayout( *m_PipelineLayout );
+
+    auto result = device.createComputePipelineUnique( nullptr, pipelineInfo );
+    assert( result.result == vk::Result::eSuccess );
+
+    m_Pipeline = std::move( result.value );
+}
+
+void
+ChunkCullPass::AllocateDescriptorSets( FrameResources& frame, uint32_t tableCount, std::vector<vk::DescriptorSet>& descriptorSets )
+{
+    auto& device = VulkanAPI::GetInstance( ).getLogicalDevice( );
+
+    if ( frame.descriptorSetCapacity < tableCount )
+    {
+        frame.descriptorSetCapacity = std::max<uint32_t>( std::bit_ceil( tableCount ), 8 );
+
+        const std::array<vk::DescriptorPoolSize, 2> poolSizes {
+            vk::DescriptorPoolSize { vk::DescriptorType::eUniformBufferDynamic, frame.descriptorSetCapacity },
+            vk::DescriptorPoolSize {        vk::DescriptorType::eStorageBuffer, frame.descriptorSetCapacity * 4 }
+        };
+
+        vk::DescriptorPoolCreateInfo poolInfo;
+        poolInfo.setPoolSizes( poolSizes ).setMaxSets( frame.descriptorSetCapacity );
+        frame.descriptorPool = device.createDescriptorPoolUnique( poolInfo );
+    } else
+    {
+        device.resetDescriptorPool( *frame.descriptorPool );
+    }
+
+    std::vector<vk::DescriptorSetLayout> layouts( tableCount, *m_DescriptorSetLayout );
+
+    vk::DescriptorSetAllocateInfo allocInfo;
+    allocInfo.setDescriptorPool( *frame.descriptorPool ).setSetLayouts( layouts );
+    descriptorSets = device.allocateDescriptorSets( allocInfo );
+}
+
+void
+ChunkCullPass::ValidateReadback( FrameResources& frame )
+{
+    if ( frame.referenceCounts.empty( ) ) return;
+
+    frame.readbackBuffer.Invalidate( 0, frame.referenceCounts.size( ) * sizeof( uint32_t ) );
+    const auto* gpuCounts = static_cast<const uint32_t*>( frame.readbackBuffer.GetMappedData( ) );
+
+    uint32_t gpuVisibleDraws = 0, cpuVisibleDraws = 0;
+    bool     isMismatched    = false;
+    for ( size_t i = 0; i < frame.referenceCounts.size( ); ++i )
+    {
+        if ( frame.referenceCounts[ i ] == NoReference ) continue;
+
+        gpuVisibleDraws += gpuCounts[ i ];
+        cpuVisibleDraws += frame.referenceCounts[ i ];
+        isMismatched |= gpuCounts[ i ] != frame.referenceCounts[ i ];
+    }
+
+    m_Statistics.totalDraws      = frame.totalDraws;
+    m_Statistics.gpuVisibleDraws = gpuVisibleDraws;
+    m_Statistics.cpuVisibleDraws = cpuVisibleDraws;
+    ++m_Statistics.comparedFrames;
+
+    if ( isMismatched )
+    {
+        ++m_Statistics.mismatchedFrames;
+        Logger::getInstance( ).LogLine( Logger::LogType::eWarn, "Chunk culling mismatch, gpu", gpuVisibleDraws, "cpu", cpuVisibleDraws, "of", frame.totalDraws, "draws" );
+    }
+
+    frame.referenceCounts.clear( );
+}
+
+void
+ChunkCullPass::Record( const vk::CommandBuffer& commandBuffer, uint32_t frameIndex, const vk::DescriptorBufferInfo& uniform, uint32_t uniformOffset,
+                       std::span<const DrawTable> tables, const ChunkCullView& view )
+{
+    using Stage  = vk::PipelineStageFlagBits;
+    using Access = vk::AccessFlagBits;
+
+    if ( m_Frames.size( ) <= frameIndex ) m_Frames.resize( frameIndex + 1 );
+    auto& frame = m_Frames[ frameIndex ];
+
+    // the last frame recorded with this index has finished, as the command buffer is being reused
+    ValidateReadback( frame );
+
+    if ( tables.empty( ) ) return;
+
+    const auto                     tableCount = (uint32_t) tables.size( );
+    std::vector<vk::DescriptorSet> descriptorSets;
+    AllocateDescriptorSets( frame, tableCount, descriptorSets );
+
+    std::vector<vk::DescriptorBufferInfo> bufferInfos;
+    std::vector<vk::WriteDescriptorSet>   writeDescriptorSets;
+    bufferInfos.reserve( tableCount * 5 );
+    writeDescriptorSets.reserve( tableCount * 5 );
+    for ( uint32_t i = 0; i < tableCount; ++i )
+    {
+        bufferInfos.push_back( uniform );
+        for ( const auto& buffer : { tables[ i ].commands, tables[ i ].origins, tables[ i ].culledCommands, tables[ i ].drawCount } )
+            bufferInfos.emplace_back( buffer, 0, VK_WHOLE_SIZE );
+
+        for ( uint32_t binding = 0; binding < 5; ++binding )
+        {
+            auto& write = writeDescriptorSets.emplace_back( );
+            write.setDstSet( descriptorSets[ i ] ).setDstBinding( binding ).setDescriptorCount( 1 ).setBufferInfo( bufferInfos[ i * 5 + binding ] );
+            write.setDescriptorType( binding == 0 ? vk::DescriptorType::eUniformBufferDynamic : vk::DescriptorType::eStorageBuffer );
+        }
+    }
+
+    VulkanAPI::GetInstance( ).getLogicalDevice( ).updateDescriptorSets( writeDescriptorSets, nullptr );
+
+    // previous frames may still draw from the culled commands
+    commandBuffer.pipelineBarrier( Stage::eDrawIndirect, Stage::eTransfer, { }, nullptr, nullptr, nullptr );
+
+    for ( const auto& table : tables )
+        commandBuffer.fillBuffer( table.drawCount, 0, sizeof( uint32_t ), 0 );
+
+    // also covers the draw table uploads
+    const vk::MemoryBarrier clearedBarrier { Access::eTransferWrite, Access::eShaderRead | Access::eShaderWrite };
+    commandBuffer.pipelineBarrier( Stage::eTransfer | Stage::eDrawIndirect, Stage::eComputeShader, { }, clearedBarrier, nullptr, nullptr );
+
+    commandBuffer.bindPipeline( vk::PipelineBindPoint::eCompute, *m_Pipeline );
+    for ( uint32_t i = 0; i < tableCount; ++i )
+    {
+        if ( tables[ i ].commandCount == 0 ) continue;
+
+        const PushConstants pushConstants { view.drawExtent, tables[ i ].commandCount, view.cameraPosition, view.maxDistance };
+        commandBuffer.bindDescriptorSets( vk::PipelineBindPoint::eCompute, *m_PipelineLayout, 0, descriptorSets[ i ], uniformOffset );
+        commandBuffer.pushConstants( *m_PipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof( PushConstants ), &pushConstants );
+        commandBuffer.dispatch( ( tables[ i ].commandCount + WorkGroupSize - 1 ) / WorkGroupSize, 1, 1 );
+    }
+
+    const vk::MemoryBarrier culledBarrier { Access::eShaderWrite, Access::eIndirectCommandRead | Access::eTransferRead };
+    commandBuffer.pipelineBarrier( Stage::eComputeShader, Stage::eDrawIndirect | Stage::eTransfer, { }, culledBarrier, nullptr, nullptr );
+
+    if ( !m_Validate ) return;
+
+    if ( frame.readbackCapacity < tableCount )
+    {
+        frame.readbackCapacity = std::max<uint32_t>( std::bit_ceil( tableCount ), 8 );
+        frame.readbackBuffer.SetAllocator( );
+        frame.readbackBuffer.Create( frame.readbackCapacity * sizeof( uint32_t ), vk::BufferUsageFlagBits::eTransferDst, VMA_MEMORY_USAGE_GPU_TO_CPU, vk::SharingMode::eExclusive, VMA_ALLOCATION_CREATE_MAPPED_BIT );
+    }
+
+    frame.totalDraws = 0;
+    frame.referenceCounts.resize( tableCount );
+    for ( uint32_t i = 0; i < tableCount; ++i )
+    {
+        commandBuffer.copyBuffer( tables[ i ].drawCount, frame.readbackBuffer.GetBuffer( ), vk::BufferCopy { 0, i * sizeof( uint32_t ), sizeof( uint32_t ) } );
+
+        frame.referenceCounts[ i ] = tables[ i ].referenceVisibleCount;
+        frame.totalDraws += tables[ i ].commandCount;
+    }
+
+    const vk::MemoryBarrier readbackBarrier { Access::eTransferWrite, Access::eHostRead };
+    commandBuffer.pipelineBarrier( Stage::eTransfer, Stage::eHost, { }, readbackBarrier, nullptr, nullptr );
+}
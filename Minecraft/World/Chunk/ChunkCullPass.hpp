@@ -0,0 +1,105 @@
+#ifndef MINECRAFT_VK_MINECRAFT_WORLD_CHUNK_CHUNKCULLPASS_HPP
+#define MINECRAFT_VK_MINECRAFT_WORLD_CHUNK_CHUNKCULLPASS_HPP
+
+#include <Graphic/Vulkan/BufferMeta.hpp>
+#include <Include/GLM.hpp>
+#include <Include/GraphicAPI.hpp>
+
+#include "ChunkCulling.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/*
+ *
+ * Frustum and distance culling of chunk draws on the GPU, with chunk_cull.comp
+ *
+ * Each draw table is tested against the frame's view and projection, visible commands are appended to the culled command buffer
+ * and their number to the draw count, for drawIndexedIndirectCount. Same test as ChunkCullView
+ * Record outside the render pass, after the draw tables are uploaded
+ *
+ * With validation the draw counts are copied back and compared against the CPU reference given to Record,
+ * the next time the same frame index is recorded. Runs the same on a software ICD
+ *
+ * */
+class ChunkCullPass
+{
+public:
+    static constexpr uint32_t NoReference = ~0U;
+
+    struct DrawTable {
+        vk::Buffer commands, origins;            // read, origins are indexed by firstInstance
+        vk::Buffer culledCommands, drawCount;   // written
+        uint32_t   commandCount = 0;
+
+        // Visible draws counted by ChunkCullView::Cull, NoReference to leave the table out of validation
+        uint32_t referenceVisibleCount = NoReference;
+    };
+
+    struct Statistics {
+        // of the last validated frame
+        uint32_t totalDraws      = 0;
+        uint32_t gpuVisibleDraws = 0;
+        uint32_t cpuVisibleDraws = 0;
+
+        uint64_t comparedFrames   = 0;
+        uint64_t mismatchedFrames = 0;
+    };
+
+private:
+    static constexpr uint32_t WorkGroupSize = 64;   // local_size_x of chunk_cull.comp
+
+    struct PushConstants {
+        glm::vec3 drawExtent;
+        uint32_t  commandCount;
+        glm::vec3 cameraPosition;
+        float     maxDistance;
+    };
+
+    static_assert( sizeof( PushConstants ) == 32 );
+
+    // Reused once the frame index comes around again, same as its command buffer
+    struct FrameResources {
+        vk::UniqueDescriptorPool descriptorPool;
+        uint32_t                 descriptorSetCapacity = 0;
+
+        BufferMeta            readbackBuffer;
+        uint32_t              readbackCapacity = 0;
+        std::vector<uint32_t> referenceCounts;   // per table of the pending readback, empty if none
+        uint32_t              totalDraws = 0;
+    };
+
+    vk::UniqueDescriptorSetLayout m_DescriptorSetLayout;
+    vk::UniquePipelineLayout      m_PipelineLayout;
+    vk::UniquePipeline            m_Pipeline;
+
+    std::vector<FrameResources> m_Frames;
+
+    bool       m_Validate = false;
+    Statistics m_Statistics;
+
+    void AllocateDescriptorSets( FrameResources& frame, uint32_t tableCount, std::vector<vk::DescriptorSet>& descriptorSets );
+    void ValidateReadback( FrameResources& frame );
+
+public:
+    ChunkCullPass( );
+
+    /*
+     *
+     * Record culling of every table into commandBuffer
+     *
+     * @param uniform BlockTransformUBO of the frame, its buffer is bound as dynamic uniform at uniformOffset
+     * @param view    frustum is taken from the uniform, the rest is pushed
+     *
+     * */
+    void Record( const vk::CommandBuffer& commandBuffer, uint32_t frameIndex, const vk::DescriptorBufferInfo& uniform, uint32_t uniformOffset,
+                 std::span<const DrawTable> tables, const ChunkCullView& view );
+
+    inline void              SetValidation( bool validate ) { m_Validate = validate; }
+    inline bool              IsValidating( ) const { return m_Validate; }
+    inline const Statistics& GetStatistics( ) const { return m_Statistics; }
+};
+
+
+#endif   // MINECRAFT_VK_MINECRAFT_WORLD_CHUNK_CHUNKCULLPASS_HPP
@@ -0,0 +1,57 @@
+#ifndef MINECRAFT_VK_MINECRAFT_WORLD_CHUNK_CHUNKCULLING_HPP
+#define MINECRAFT_VK_MINECRAFT_WORLD_CHUNK_CHUNKCULLING_HPP
+
+#include <Include/GLM.hpp>
+#include <Include/GraphicAPI.hpp>
+#include <Utility/Math/Frustum.hpp>
+
+#include <glm/common.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/*
+ *
+ * Visibility of chunk draws, used by the CPU culling path and by ChunkCullPass
+ *
+ * A draw covers its origin to origin + drawExtent, it is visible if the box intersects the frustum
+ * and its closest point is within maxDistance of the camera on the horizontal plane, 0 for no distance limit
+ * chunk_cull.comp does the same test, keep them in sync
+ *
+ * */
+struct ChunkCullView {
+    Frustum   frustum;
+    glm::vec3 cameraPosition { };
+    float     maxDistance = 0;
+    glm::vec3 drawExtent { };
+
+    [[nodiscard]] bool IsVisible( const glm::vec3& origin ) const
+    {
+        if ( maxDistance > 0 )
+        {
+            const glm::vec2 camera { cameraPosition.x, cameraPosition.z };
+            const glm::vec2 offset = glm::clamp( camera, glm::vec2 { origin.x, origin.z }, glm::vec2 { origin.x + drawExtent.x, origin.z + drawExtent.z } ) - camera;
+            if ( glm::dot( offset, offset ) > maxDistance * maxDistance ) return false;
+        }
+
+        return frustum.Intersects( origin, origin + drawExtent );
+    }
+
+    // Visible commands are appended to visibleCommands if given, in table order, returns their count
+    uint32_t Cull( std::span<const vk::DrawIndexedIndirectCommand> commands, std::span<const glm::ivec3> origins, std::vector<vk::DrawIndexedIndirectCommand>* visibleCommands = nullptr ) const
+    {
+        uint32_t visibleCount = 0;
+        for ( const auto& command : commands )
+        {
+            if ( command.indexCount == 0 || !IsVisible( glm::vec3( origins[ command.firstInstance ] ) ) ) continue;
+
+            ++visibleCount;
+            if ( visibleCommands != nullptr ) visibleCommands->push_back( command );
+        }
+
+        return visibleCount;
+    }
+};
+
+#endif   // MINECRAFT_VK_MINECRAFT_WORLD_CHUNK_CHUNKCULLING_HPP
@@ -0,0 +1,109 @@
+#include "ChunkMeshCache.hpp"
+#include "RenderableChunk.hpp"
+
+#include <bit>
+
+void
+ChunkMeshCache::EvictLeastRecentlyUsed( )
+{
+    const auto& entry = m_RecentlyUsed.back( );
+
+    // holders of the mesh data keep it alive
+    auto chunkEntries = m_ChunkEntries.find( entry.chunk );
+    if ( ( chunkEntries->second.sectionMask &= ~( 1U << entry.sectionIndex ) ) == 0 ) m_ChunkEntries.erase( chunkEntries );
+
+    m_RecentlyUsed.pop_back( );
+    ++m_Statistics.evictions;
+}
+
+std::shared_ptr<SectionMeshData>
+ChunkMeshCache::Find( const RenderableChunk* chunk, uint32_t sectionIndex )
+{
+    std::lock_guard lock( m_CacheLock );
+
+    const auto chunkEntries = m_ChunkEntries.find( chunk );
+    if ( chunkEntries == m_ChunkEntries.end( ) || ( chunkEntries->second.sectionMask & ( 1U << sectionIndex ) ) == 0 )
+    {
+        ++m_Statistics.misses;
+        return { };
+    }
+
+    ++m_Statistics.hits;
+
+    const auto entry = chunkEntries->second.entries[ sectionIndex ];
+    m_RecentlyUsed.splice( m_RecentlyUsed.begin( ), m_RecentlyUsed, entry );
+    return entry->meshData;
+}
+
+std::shared_ptr<SectionMeshData>
+ChunkMeshCache::Peek( const RenderableChunk* chunk, uint32_t sectionIndex )
+{
+    std::lock_guard lock( m_CacheLock );
+
+    const auto chunkEntries = m_ChunkEntries.find( chunk );
+    if ( chunkEntries == m_ChunkEntries.end( ) || ( chunkEntries->second.sectionMask & ( 1U << sectionIndex ) ) == 0 ) return { };
+
+    return chunkEntries->second.entries[ sectionIndex ]->meshData;
+}
+
+void
+ChunkMeshCache::Insert( const RenderableChunk* chunk, uint32_t sectionIndex, std::shared_ptr<SectionMeshData> meshData )
+{
+    std::lock_guard lock( m_CacheLock );
+    if ( m_Capacity == 0 ) return;
+
+    if ( const auto chunkEntries = m_ChunkEntries.find( chunk ); chunkEntries != m_ChunkEntries.end( ) && ( chunkEntries->second.sectionMask & ( 1U << sectionIndex ) ) )
+    {
+        auto entry      = chunkEntries->second.entries[ sectionIndex ];
+        entry->meshData = std::move( meshData );
+        m_RecentlyUsed.splice( m_RecentlyUsed.begin( ), m_RecentlyUsed, entry );
+        return;
+    }
+
+    // make room first, eviction may drop the map node of chunk
+    while ( m_RecentlyUsed.size( ) >= m_Capacity )
+        EvictLeastRecentlyUsed( );
+
+    auto& chunkEntries = m_ChunkEntries[ chunk ];
+
+    m_RecentlyUsed.push_front( { chunk, sectionIndex, std::move( meshData ) } );
+    chunkEntries.entries[ sectionIndex ] = m_RecentlyUsed.begin( );
+    chunkEntries.sectionMask |= 1U << sectionIndex;
+}
+
+void
+ChunkMeshCache::Erase( const RenderableChunk* chunk )
+{
+    std::lock_guard lock( m_CacheLock );
+
+    const auto chunkEntries = m_ChunkEntries.find( chunk );
+    if ( chunkEntries == m_ChunkEntries.end( ) ) return;
+
+    for ( uint32_t sections = chunkEntries->second.sectionMask; sections != 0; sections &= sections - 1 )
+        m_RecentlyUsed.erase( chunkEntries->second.entries[ std::countr_zero( sections ) ] );
+
+    m_ChunkEntries.erase( chunkEntries );
+}
+
+void
+ChunkMeshCache::SetCapacity( uint32_t capacity )
+{
+    std::lock_guard lock( m_CacheLock );
+
+    m_Capacity = capacity;
+    while ( m_RecentlyUsed.size( ) > m_Capacity )
+        EvictLeastRecentlyUsed( );
+}
+
+size_t
+ChunkMeshCache::GetSectionCount( )
+{
+    std::lock_guard lock( m_CacheLock );
+    return m_RecentlyUsed.size( );
+}
+
+size_t
+ChunkMeshCache::GetMemorySize( )
+{
+    return GetSectionCount( ) * sizeof( SectionMeshData );
+}
@@ -0,0 +1,92 @@
+#ifndef MINECRAFT_VK_MINECRAFT_WORLD_CHUNK_CHUNKMESHCACHE_HPP
+#define MINECRAFT_VK_MINECRAFT_WORLD_CHUNK_CHUNKMESHCACHE_HPP
+
+#include <Minecraft/util/MinecraftConstants.hpp>
+
+#include <array>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+class RenderableChunk;
+struct SectionMeshData;
+
+/*
+ *
+ * Bounded LRU of section mesh data of recently edited chunks
+ *
+ * Mesh data is otherwise computed into thread local scratch every time a section is meshed,
+ * a cached section is patched by SetBlock around the edit instead, so editing it again does not recompute the whole section
+ *
+ * Entries are only read or written under the sync lock of their chunk, the cache lock is only held inside its own methods
+ * Capacity of 0 disables the cache
+ *
+ * */
+class ChunkMeshCache
+{
+public:
+    struct Statistics {
+        uint64_t hits      = 0;
+        uint64_t misses    = 0;
+        uint64_t evictions = 0;
+    };
+
+private:
+    struct Entry {
+        const RenderableChunk*           chunk;
+        uint32_t                         sectionIndex;
+        std::shared_ptr<SectionMeshData> meshData;
+    };
+
+    using EntryIterator = std::list<Entry>::iterator;
+
+    struct ChunkEntries {
+        uint32_t                                     sectionMask = 0;
+        std::array<EntryIterator, MaxSectionInChunk> entries;
+    };
+
+    std::mutex m_CacheLock;
+
+    std::list<Entry>                                         m_RecentlyUsed;   // most recently used first
+    std::unordered_map<const RenderableChunk*, ChunkEntries> m_ChunkEntries;
+
+    uint32_t   m_Capacity;
+    Statistics m_Statistics;
+
+    void EvictLeastRecentlyUsed( );
+
+public:
+    explicit ChunkMeshCache( uint32_t capacity )
+        : m_Capacity( capacity )
+    { }
+
+    // Counted as a hit or miss, a hit becomes the most recently used
+    std::shared_ptr<SectionMeshData> Find( const RenderableChunk* chunk, uint32_t sectionIndex );
+
+    // Not counted and not touched
+    std::shared_ptr<SectionMeshData> Peek( const RenderableChunk* chunk, uint32_t sectionIndex );
+
+    void Insert( const RenderableChunk* chunk, uint32_t sectionIndex, std::shared_ptr<SectionMeshData> meshData );
+
+    // Drop every section of chunk, its mesh data is stale or the chunk is going away
+    void Erase( const RenderableChunk* chunk );
+
+    void SetCapacity( uint32_t capacity );
+
+    inline uint32_t GetCapacity( ) const { return m_Capacity; }
+    inline bool     IsEnabled( ) const { return m_Capacity != 0; }
+
+    size_t GetSectionCount( );
+    size_t GetMemorySize( );
+
+    Statistics GetStatistics( )
+    {
+        std::lock_guard lock( m_CacheLock );
+        return m_Statistics;
+    }
+};
+
+
+#endif   // MINECRAFT_VK_MINECRAFT_WORLD_CHUNK_CHUNKMESHCACHE_HPP
@@ -0,0 +1,44 @@
+#include "ChunkPayloadPool.hpp"
+#include "PalettedBlockStorage.hpp"
+
+#include <array>
+#include <bit>
+
+SlabPool&
+ChunkPayloadPool::GetBlockSections( )
+{
+    static auto* pool = new SlabPool( "Block sections", sizeof( PalettedBlockStorage ) * MaxSectionInChunk, alignof( PalettedBlockStorage ) );
+    return *pool;
+}
+
+SlabPool&
+ChunkPayloadPool::GetSectionData( uint8_t bitsPerEntry )
+{
+    assert( std::has_single_bit( bitsPerEntry ) && bitsPerEntry <= 8 );
+
+    static const auto pools = [] {
+        std::array<SlabPool*, 4> result;
+        for ( int i = 0; i < (int) result.size( ); ++i )
+            result[ i ] = new SlabPool( "Section data " + std::to_string( 1 << i ) + " bit", SectionVolume * ( 1 << i ) / 8 );
+
+        return result;
+    }( );
+
+    return *pools[ std::countr_zero( bitsPerEntry ) ];
+}
+
+SlabPool&
+ChunkPayloadPool::GetHeightMaps( )
+{
+    static auto* pool = new SlabPool( "Height maps", sizeof( int32_t ) * SectionSurfaceSize, alignof( int32_t ) );
+    return *pool;
+}
+
+SlabPool&
+ChunkPayloadPool::GetChunkObjects( size_t objectSize, size_t objectAlignment )
+{
+    static auto* pool = new SlabPool( "Chunk objects", objectSize, objectAlignment );
+
+    assert( objectSize <= pool->GetBlockSize( ) && objectAlignment <= pool->GetBlockAlignment( ) );
+    return *pool;
+}
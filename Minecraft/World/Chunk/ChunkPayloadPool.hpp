@@ -0,0 +1,30 @@
+#ifndef MINECRAFT_VK_MINECRAFT_WORLD_CHUNK_CHUNKPAYLOADPOOL_HPP
+#define MINECRAFT_VK_MINECRAFT_WORLD_CHUNK_CHUNKPAYLOADPOOL_HPP
+
+#include <Utility/Memory/SlabPool.hpp>
+
+#include <cstdint>
+
+/*
+ *
+ * Slab pools of the fixed size storage every chunk allocates, recycled as chunks unload
+ *
+ * Pools are created on first use and never destroyed, chunks can still be released during static destruction
+ *
+ * */
+struct ChunkPayloadPool {
+
+    // SlabPoolArray of MaxSectionInChunk PalettedBlockStorage
+    static SlabPool& GetBlockSections( );
+
+    // Bit-packed palette indices of a section, bitsPerEntry of 1, 2, 4 or 8
+    static SlabPool& GetSectionData( uint8_t bitsPerEntry );
+
+    // SectionSurfaceSize heights
+    static SlabPool& GetHeightMaps( );
+
+    // Chunk objects of objectSize, the size is fixed by the first call
+    static SlabPool& GetChunkObjects( size_t objectSize, size_t objectAlignment );
+};
+
+#endif   // MINECRAFT_VK_MINECRAFT_WORLD_CHUNK_CHUNKPAYLOADPOOL_HPP
@@ -88,37 +88,21 @@ ChunkPool::UpdateThread( const std::stop_token& st )
 
     while ( !st.stop_requested( ) )
     {
-        if ( !HasThreadRunning( ) )
-        {
-            // all thread ended, resources are safe to use
-            CleanUpJobs( );
-            FlushSafeAddedChunks( );
-            RemoveChunkOutsizeRange( );
-
-            if ( m_PendingThreads.empty( ) )
-            {
-                // std::this_thread::yield();
-                std::this_thread::sleep_for( std::chrono::milliseconds( ChunkThreadDelayPeriod ) );
-                continue;
-            }
-
-            UpdateSorted( [ this ]( ChunkTy* cache ) { ChunkPool::LoadChunk( cache ); },
-                          [ centre = m_PrioritizeCoordinate ]( const ChunkTy* a, const ChunkTy* b ) -> bool {
-                              const auto aUpgradeable = a->NextStatusUpgradeSatisfied( );
-                              const auto bUpgradeable = b->NextStatusUpgradeSatisfied( );
-                              if ( aUpgradeable != bUpgradeable ) return aUpgradeable;
-
-                              const auto aEmergency = a->GetEmergencyLevel( );
-                              const auto bEmergency = b->GetEmergencyLevel( );
-                              if ( aEmergency != bEmergency )
-                                  return aEmergency < bEmergency;
-
-                              return a->ManhattanDistance( centre ) < b->ManhattanDistance( centre );
-                          } );
-        } else
-        {
-            std::this_thread::sleep_for( std::chrono::milliseconds( ChunkThreadDelayPeriod ) );
-        }
+        // Retire finished jobs and refill the pool as soon as any worker frees up
+        RefreshPriority( );
+        CleanUpJobs( );
+        FlushSafeAddedChunks( );
+        RemoveChunkOutsizeRange( );
+        ReclaimRetiredChunks( );
+        UpdateQueueDepth( );
+
+        UpdatePrioritized(
+            [ this ]( ChunkTy* cache ) { ChunkPool::LoadChunk( cache ); },
+            [ this ]( ) { return m_PendingQueue.Pop( ); },
+            [ this ]( ChunkTy* cache ) { OnJobDispatched( cache ); } );
+
+        // Wake up on the first finished job, fall back to polling for newly introduced chunks
+        WaitFinishedJob( std::chrono::milliseconds( ChunkThreadDelayPeriod ) );
     }
 
     LOGL_SYS( "Chunk update thread stopped." )
@@ -133,38 +117,215 @@ ChunkPool::UpdateThread( const std::stop_token& st )
 }
 
 void
-ChunkPool::RemoveChunkOutsizeRange( )
+ChunkPool::OnJobDispatched( ChunkTy* cache )
 {
-    if ( m_MaxRemoveJobRange > 0 )
+    // Mark before the job starts, RemoveChunkOutsizeRange must not erase chunks sitting in worker queues
+    cache->initialized  = false;
+    cache->initializing = true;
+
+    m_DispatchedStatus[ cache ] = cache->GetStatus( );
+    ++m_AttemptCount;
+}
+
+void
+ChunkPool::UpdateQueueDepth( )
+{
+    std::array<uint32_t, ChunkStatusSize> queueDepth { };
+
+    for ( int i = 0; i < ChunkStatusSize; ++i )
+        queueDepth[ i ] = m_PendingQueue.GetStatusCount( static_cast<ChunkStatus>( i ) );
+
+    for ( int i = 0; i < ChunkStatusSize; ++i )
+        queueDepth[ i ] += m_WaitingStatusCount[ i ];
+
+    for ( int i = 0; i < ChunkStatusSize; ++i )
+        m_QueueDepth[ i ].store( queueDepth[ i ], std::memory_order_relaxed );
+}
+
+void
+ChunkPool::RefreshPriority( )
+{
+    const ChunkCoordinate centre  = m_PrioritizeCoordinate;
+    const uint32_t        maxRing = m_MaxRemoveJobRange > 0 ? m_MaxRemoveJobRange * 2 : UnboundedPriorityRing;
+
+    if ( centre != m_PendingQueue.GetCentre( ) || maxRing != m_PendingQueue.GetMaxRing( ) )
+        m_PendingQueue.Reset( centre, maxRing );
+}
+
+void
+ChunkPool::ScheduleChunk( ChunkTy* cache )
+{
+    if ( cache->IsAtLeastTargetStatus( ) ) return;
+
+    // Rescheduled, previous registrations are invalidated by the new ticket
+    if ( auto waitingIt = m_WaitingChunks.find( cache ); waitingIt != m_WaitingChunks.end( ) ) EraseWaitingChunk( waitingIt );
+
+    const auto dependency = WorldChunk::GetUpgradeDependency( cache->GetStatus( ) );
+    if ( dependency.range == 0 )
     {
+        m_PendingQueue.Push( cache );
+        return;
+    }
+
+    const auto ticket    = ++m_DependencyTicket;
+    uint32_t   remaining = 0;
+
+    for ( int dz = -dependency.range; dz <= dependency.range; ++dz )
+        for ( int dx = -dependency.range; dx <= dependency.range; ++dx )
         {
-            std::lock_guard<std::recursive_mutex> guard( m_PendingThreadsMutex );
-            const auto                            lastIt = std::partition( m_PendingThreads.begin( ), m_PendingThreads.end( ),
-                                                                           [ range = m_StatusJobRemoveRange, centre = m_PrioritizeCoordinate ]( const auto& cache ) { return cache->MaxAxisDistance( centre ) <= range[ cache->GetStatus( ) ]; } );
+            const auto coordinate = cache->GetChunkCoordinate( ) + MakeMinecraftChunkCoordinate( dx, dz );
 
-            const auto amountToRemove = std::distance( lastIt, m_PendingThreads.end( ) );
+            // Introduce or upgrade the prerequisite node, unless it can never be loaded at this distance
+            ChunkTy* dependencyChunk = CanLoadCoordinate( coordinate, dependency.status ) ? AddCoordinate( coordinate, dependency.status ) : GetChunkCacheUnsafe( coordinate );
+            if ( dependencyChunk != nullptr && dependencyChunk->IsChunkStatusAtLeast( dependency.status ) ) continue;
 
-            // elements outside the range
-            if ( amountToRemove > 0 )
-                m_PendingThreads.erase( lastIt, m_PendingThreads.end( ) );
+            ++remaining;
+            m_StatusWaiters[ ToChunkCoordinateHash( coordinate ) ][ dependency.status ].push_back( { cache, ticket } );
         }
 
+    if ( remaining == 0 )
+    {
+        m_PendingQueue.Push( cache );
+        return;
+    }
+
+    m_WaitingChunks[ cache ] = { remaining, ticket };
+    ++m_WaitingStatusCount[ cache->GetStatus( ) ];
+}
+
+void
+ChunkPool::NotifyStatusCompleted( ChunkTy* cache, ChunkStatus from, ChunkStatus to )
+{
+    const auto waitersIt = m_StatusWaiters.find( ToChunkCoordinateHash( cache->GetChunkCoordinate( ) ) );
+    if ( waitersIt == m_StatusWaiters.end( ) ) return;
+
+    for ( auto status = from + 1; status <= to; ++status )
+    {
+        for ( const auto& waiter : waitersIt->second[ status ] )
         {
+            auto waitingIt = m_WaitingChunks.find( waiter.chunk );
+
+            // Waiter removed or rescheduled since registered
+            if ( waitingIt == m_WaitingChunks.end( ) || waitingIt->second.ticket != waiter.ticket ) continue;
 
+            if ( --waitingIt->second.remaining == 0 )
+            {
+                EraseWaitingChunk( waitingIt );
+                m_PendingQueue.Push( waiter.chunk );
+            }
+        }
 
+        waitersIt->second[ status ].clear( );
+    }
+
+    if ( std::all_of( waitersIt->second.begin( ), waitersIt->second.end( ), []( const auto& waiters ) { return waiters.empty( ); } ) )
+        m_StatusWaiters.erase( waitersIt );
+}
+
+void
+ChunkPool::EraseWaitingChunk( std::unordered_map<ChunkTy*, WaitingChunk>::iterator it )
+{
+    --m_WaitingStatusCount[ it->first->GetStatus( ) ];
+    m_WaitingChunks.erase( it );
+}
+
+void
+ChunkPool::RemoveChunkOutsizeRange( )
+{
+    if ( m_MaxRemoveJobRange > 0 )
+    {
+        // elements outside the range
+        const auto outsideRange = [ range = m_StatusJobRemoveRange, centre = m_PrioritizeCoordinate ]( const auto& cache ) { return cache->MaxAxisDistance( centre ) > range[ cache->GetStatus( ) ]; };
+        m_PendingQueue.EraseIf( outsideRange );
+        for ( auto it = m_WaitingChunks.begin( ); it != m_WaitingChunks.end( ); )
+        {
+            if ( outsideRange( it->first ) )
+                EraseWaitingChunk( it++ );
+            else
+                ++it;
+        }
+
+        std::vector<ChunkCoordinateHash> erasedCoordinates;
+        std::vector<ChunkTy*>            erasedChunks;
+
+        {
             std::lock_guard<std::recursive_mutex> lock( m_ChunkCacheLock );
 
-            const auto condition = [ range = m_MaxRemoveJobRange, centre = m_PrioritizeCoordinate ]( const std::pair<ChunkCoordinateHash, std::shared_ptr<ChunkTy>>& cache ) {
+            const auto condition = [ range = m_MaxRemoveJobRange, centre = m_PrioritizeCoordinate ]( const std::pair<ChunkCoordinateHash, ChunkTy*>& cache ) {
                 return cache.second->MaxAxisDistance( centre ) > range && ( !cache.second->initializing || cache.second->initialized );
             };
-            if ( std::erase_if( m_ChunkCache, condition ) > 0 )
+
+            for ( auto it = m_ChunkCache.begin( ); it != m_ChunkCache.end( ); )
+            {
+                if ( condition( *it ) )
+                {
+                    // handles resolve to nullptr from now on
+                    m_ChunkSlots.Release( it->second->GetHandle( ) );
+
+                    erasedCoordinates.push_back( it->first );
+                    erasedChunks.push_back( it->second );
+                    it = m_ChunkCache.erase( it );
+                } else
+                    ++it;
+            }
+
+            if ( !erasedCoordinates.empty( ) )
             {
                 m_ChunkErased.test_and_set( );
             }
         }
+
+        // Guards entered before this point may still be using the erased chunks
+        if ( !erasedChunks.empty( ) )
+        {
+            const auto retiredEpoch = EpochReclamation::GetCurrentEpoch( );
+            for ( auto* chunk : erasedChunks )
+            {
+                // a chunk loaded again at the same coordinate is linked by CleanUpJobs before this one is deleted
+                chunk->UnlinkNearChunks( );
+                m_RetiredChunks.push_back( { chunk, retiredEpoch } );
+            }
+        }
+
+        // Chunks waiting on removed nodes have to re-evaluate their dependencies
+        std::vector<ChunkTy*> rescheduleChunks;
+        for ( const auto hashedCoordinate : erasedCoordinates )
+        {
+            const auto waitersIt = m_StatusWaiters.find( hashedCoordinate );
+            if ( waitersIt == m_StatusWaiters.end( ) ) continue;
+
+            for ( const auto& waiters : waitersIt->second )
+                for ( const auto& waiter : waiters )
+                    if ( auto waitingIt = m_WaitingChunks.find( waiter.chunk ); waitingIt != m_WaitingChunks.end( ) && waitingIt->second.ticket == waiter.ticket )
+                    {
+                        EraseWaitingChunk( waitingIt );
+                        rescheduleChunks.push_back( waiter.chunk );
+                    }
+
+            m_StatusWaiters.erase( waitersIt );
+        }
+
+        for ( auto* cache : rescheduleChunks )
+            ScheduleChunk( cache );
     }
 }
 
+void
+ChunkPool::ReclaimRetiredChunks( )
+{
+    if ( m_RetiredChunks.empty( ) ) return;
+
+    EpochReclamation::Advance( );
+    const auto oldestActiveEpoch = EpochReclamation::GetOldestActiveEpoch( );
+
+    std::erase_if( m_RetiredChunks, [ oldestActiveEpoch ]( const RetiredChunk& retired ) {
+        if ( !EpochReclamation::CanReclaim( retired.epoch, oldestActiveEpoch ) ) return false;
+
+        delete retired.chunk;
+        return true;
+    } );
+}
+
 void
 ChunkPool::CleanUpJobs( )
 {
@@ -172,8 +333,21 @@ ChunkPool::CleanUpJobs( )
     finished.reserve( m_maxThread );
 
     CleanRunningThread( &finished );
+
     for ( auto* cache : finished )
     {
+        ChunkStatus dispatchedStatus = cache->GetStatus( );
+        if ( const auto dispatchedIt = m_DispatchedStatus.find( cache ); dispatchedIt != m_DispatchedStatus.end( ) )
+        {
+            dispatchedStatus = dispatchedIt->second;
+            m_DispatchedStatus.erase( dispatchedIt );
+        }
+
+        if ( dispatchedStatus != cache->GetStatus( ) )
+            NotifyStatusCompleted( cache, dispatchedStatus, cache->GetStatus( ) );
+        else
+            ++m_WastedAttemptCount;
+
         if ( !cache->IsAtLeastTargetStatus( ) )
         {
             // Logger::getInstance( ).LogLine( "Load not complete, re-appending chunk", cache );
@@ -182,7 +356,7 @@ ChunkPool::CleanUpJobs( )
 
             // Could be outside range at the time the job finish
             if ( CanLoadCoordinate( cache->GetChunkCoordinate( ), cache->GetStatus( ) + 1 ) )
-                AddJobContext( cache );
+                ScheduleChunk( cache );
             else
             {
                 std::lock_guard<std::recursive_mutex> chunkLock( m_ChunkCacheLock );
@@ -195,7 +369,7 @@ ChunkPool::CleanUpJobs( )
             continue;
         }
 
-        if ( cache->GetStatus( ) == ChunkStatus::eFull )
+        if ( m_BuildRenderBuffer && cache->GetStatus( ) == ChunkStatus::eFull )
         {
             for ( int i = 0; i < EightWayDirectionSize; ++i )
             {
@@ -206,8 +380,8 @@ ChunkPool::CleanUpJobs( )
 
                     // this is ok, I guess
                     // std::lock_guard<std::mutex> lock( m_RenderBufferLock );
-                    if ( cache->SyncChunkFromDirection( chunkPtr.get( ), static_cast<EightWayDirection>( i ) ) ) cache->GenerateRenderBuffer( );
-                    if ( chunkPtr->SyncChunkFromDirection( cache, static_cast<EightWayDirection>( i ^ 0b1 ) ) ) chunkPtr->GenerateRenderBuffer( );
+                    if ( cache->SyncChunkFromDirection( chunkPtr, static_cast<EightWayDirection>( i ) ) ) cache->RequestRemesh( );
+                    if ( chunkPtr->SyncChunkFromDirection( cache, static_cast<EightWayDirection>( i ^ 0b1 ) ) ) chunkPtr->RequestRemesh( );
                 }
             }
 
@@ -218,21 +392,6 @@ ChunkPool::CleanUpJobs( )
         cache->initializing = false;
         cache->initialized  = true;
     }
-
-    {
-        std::unordered_map<ChunkCoordinate, ChunkStatusTy> combinedMap;
-        for ( auto* finishedJob : finished )
-        {
-            const auto chunks = finishedJob->ExtractMissingEssentialChunks( );
-            for ( const auto& requiredChunk : chunks )
-                combinedMap[ requiredChunk.first ] = std::max( combinedMap[ requiredChunk.first ], requiredChunk.second );
-            // AddCoordinateSafe( requiredChunk.first, (ChunkStatus) requiredChunk.second );
-        }
-
-        // Logger::getInstance( ).LogLine( "combinedMap:", combinedMap.size( ) );
-        for ( const auto& requiredChunk : combinedMap )
-            AddCoordinateSafe( requiredChunk.first, (ChunkStatus) requiredChunk.second );
-    }
 }
 
 ChunkTy*
@@ -256,18 +415,19 @@ ChunkPool::AddCoordinate( const ChunkCoordinate& coordinate, ChunkStatus status
                 // } else
 
                 if ( find_it->second->initialized )   //  previous job already ended, need to add job for upgrading
-                    AddJobContext( find_it->second.get( ) );
+                    ScheduleChunk( find_it->second );
             }
 
-            return find_it->second.get( );
+            return find_it->second;
         }
 
         auto newChunk = new ChunkTy( m_World );
         newChunk->SetCoordinate( coordinate );
         newChunk->SetExpectedStatus( status );
+        newChunk->SetHandle( m_ChunkSlots.Acquire( newChunk ) );
 
-        m_ChunkCache.insert( { hashedCoordinate, std::shared_ptr<ChunkTy>( newChunk ) } );
-        AddJobContext( newChunk );
+        m_ChunkCache.insert( { hashedCoordinate, newChunk } );
+        ScheduleChunk( newChunk );
 
         return newChunk;
     }
@@ -288,7 +448,6 @@ ChunkPool::FlushSafeAddedChunks( )
     }
 
     //    std::lock_guard<std::recursive_mutex> chunkLock( m_ChunkCacheLock );
-    //    std::lock_guard<std::recursive_mutex> threadLock( m_PendingThreadsMutex );
     for ( const auto& chunk : chunks )
         AddCoordinate( chunk.first, static_cast<ChunkStatus>( chunk.second ) );
 }
@@ -297,8 +456,9 @@ void
 ChunkPool::LoadChunk( ChunkTy* cache )
 {
     // Logger::getInstance( ).LogLine( "Start loading", cache );
+    // initializing flags are set by OnJobDispatched on the update thread
 
-    cache->initialized  = false;
-    cache->initializing = true;
+    // surrounding chunks resolved by the job are not deleted before it ends
+    EpochGuard epochGuard;
     cache->TryUpgradeChunk( );
 }
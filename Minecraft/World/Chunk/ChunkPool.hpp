@@ -7,10 +7,15 @@
 
 #include <mutex>
 
+#include "ChunkMeshCache.hpp"
+#include "ChunkPriorityQueue.hpp"
+#include "ChunkRemeshQueue.hpp"
 #include "ChunkRenderBuffers.hpp"
+#include "ChunkSlotTable.hpp"
 #include "WorldChunk.hpp"
 
 #include <Utility/Logger.hpp>
+#include <Utility/Thread/EpochReclamation.hpp>
 #include <Utility/Thread/ThreadPool.hpp>
 
 #include "ChunkPoolType.hpp"
@@ -25,39 +30,113 @@ private:
     ChunkCoordinate               m_PrioritizeCoordinate;
     std::unique_ptr<std::jthread> m_UpdateThread;
 
-    std::recursive_mutex                                              m_ChunkCacheLock;
-    std::unordered_map<ChunkCoordinateHash, std::shared_ptr<ChunkTy>> m_ChunkCache;
+    /*
+     *
+     * Chunks are owned by the pool, and referenced elsewhere by ChunkHandle
+     * Erased chunks are retired, and deleted by UpdateThread once no EpochGuard entered before can still use them
+     *
+     * */
+    std::recursive_mutex                              m_ChunkCacheLock;
+    std::unordered_map<ChunkCoordinateHash, ChunkTy*> m_ChunkCache;
+    ChunkSlotTable                                    m_ChunkSlots;
+
+    struct RetiredChunk {
+        ChunkTy* chunk;
+        uint64_t epoch;
+    };
+
+    std::vector<RetiredChunk> m_RetiredChunks;   // only touched by UpdateThread
 
     std::atomic_flag m_ChunkErased = ATOMIC_FLAG_INIT;
 
     std::mutex                                         m_SafeAddedChunksLock;
     std::unordered_map<ChunkCoordinate, ChunkStatusTy> m_SafeAddedChunks;
 
+    /*
+     *
+     * Scheduling, only touched by UpdateThread
+     *
+     * */
+    std::unordered_map<ChunkTy*, ChunkStatus> m_DispatchedStatus;
+    ChunkPriorityQueue                        m_PendingQueue;
+
+    // Distance ring limit when there is no remove range
+    static constexpr uint32_t UnboundedPriorityRing = 64;
+
+    std::array<std::atomic<uint32_t>, ChunkStatusSize> m_QueueDepth { };
+
+    /*
+     *
+     * Generation dependency graph
+     *
+     * Node is (chunk, next status), a node waits in m_WaitingChunks until all prerequisite nodes are completed
+     * Waiters are registered on the coordinate and status they need, rescheduling a chunk issue a new ticket
+     * so stale registrations are ignored
+     *
+     * */
+    struct DependencyWaiter {
+        ChunkTy* chunk;
+        uint64_t ticket;
+    };
+
+    struct WaitingChunk {
+        uint32_t remaining;
+        uint64_t ticket;
+    };
+
+    using StatusWaiters = std::array<std::vector<DependencyWaiter>, ChunkStatusSize>;
+
+    uint64_t                                               m_DependencyTicket = 0;
+    std::unordered_map<ChunkTy*, WaitingChunk>             m_WaitingChunks;
+    std::unordered_map<ChunkCoordinateHash, StatusWaiters> m_StatusWaiters;
+    std::array<uint32_t, ChunkStatusSize>                  m_WaitingStatusCount { };
+
+    // Meshing and render buffer uploads, disabled when running without a renderer
+    bool             m_BuildRenderBuffer = true;
+    ChunkMeshCache   m_MeshCache;
+    ChunkRemeshQueue m_RemeshQueue;
+
+    std::atomic<uint64_t> m_AttemptCount       = 0;
+    std::atomic<uint64_t> m_WastedAttemptCount = 0;
+
+    // Queue the chunk if its next status is runnable, otherwise wait for its dependencies
+    void ScheduleChunk( ChunkTy* cache );
+    void NotifyStatusCompleted( ChunkTy* cache, ChunkStatus from, ChunkStatus to );
+    void EraseWaitingChunk( std::unordered_map<ChunkTy*, WaitingChunk>::iterator it );
+
     static inline void LoadChunk( ChunkTy* cache );
+    void               OnJobDispatched( ChunkTy* cache );
 
     void CleanUpJobs( );
+    void UpdateQueueDepth( );
+
+    // Pending priorities are cached, refresh when centre moved
+    void RefreshPriority( );
 
     /*
      *
-     * This should only be called from UpdateThread when all thread are stopped.
+     * This should only be called from UpdateThread, chunks handed to worker are never removed.
      *
      * */
     void RemoveChunkOutsizeRange( );
+    void ReclaimRetiredChunks( );
     void UpdateThread( const std::stop_token& st );
 
     /*
      *
      * This Function should only be called in the main thread to avoid te use of mutex
-     * Namely m_ChunkCache and m_PendingThreads
+     * Namely m_ChunkCache and m_PendingQueue
      *
      * */
     ChunkTy* AddCoordinate( const ChunkCoordinate& coordinate, ChunkStatus status = ChunkStatus::eFull );
     void     FlushSafeAddedChunks( );
 
 public:
-    explicit ChunkPool( class MinecraftWorld* world, uint32_t maxThread )
+    explicit ChunkPool( class MinecraftWorld* world, uint32_t maxThread, uint32_t remeshThread, uint32_t remeshFrameBudget, uint32_t meshCacheSections )
         : m_World( world )
         , ThreadPool<ChunkTy>( maxThread )
+        , m_MeshCache( meshCacheSections )
+        , m_RemeshQueue( remeshThread, remeshFrameBudget )
     { }
 
     ~ChunkPool( )
@@ -75,6 +154,21 @@ public:
         m_PrioritizeCoordinate = centre;
     }
 
+    inline void SetRenderBufferEnabled( bool enabled )
+    {
+        m_BuildRenderBuffer = enabled;
+    }
+
+    inline auto& GetRemeshQueue( )
+    {
+        return m_RemeshQueue;
+    }
+
+    inline auto& GetMeshCache( )
+    {
+        return m_MeshCache;
+    }
+
     inline void SetStatusValidRange( std::array<int32_t, ChunkStatusSize> range )
     {
         m_StatusJobRemoveRange = range;
@@ -95,8 +189,24 @@ public:
     void Clean( )
     {
         CleanRunningThread( );
-        m_PendingThreads.clear( );
+        m_PendingQueue.Clear( );
+        m_DispatchedStatus.clear( );
+        m_WaitingChunks.clear( );
+        m_StatusWaiters.clear( );
+        m_WaitingStatusCount.fill( 0 );
+
+        std::lock_guard<std::recursive_mutex> chunkLock( m_ChunkCacheLock );
+        for ( auto& cache : m_ChunkCache )
+        {
+            m_ChunkSlots.Release( cache.second->GetHandle( ) );
+            delete cache.second;
+        }
         m_ChunkCache.clear( );
+
+        // no thread is left to use them
+        for ( const auto& retired : m_RetiredChunks )
+            delete retired.chunk;
+        m_RetiredChunks.clear( );
     }
 
     void AddCoordinateSafe( const ChunkCoordinate& coordinate, ChunkStatus status = ChunkStatus::eFull )
@@ -126,12 +236,40 @@ public:
 
     inline size_t GetPendingCount( ) const
     {
-        return m_PendingThreads.size( );
+        size_t pendingCount = 0;
+        for ( const auto& depth : m_QueueDepth )
+            pendingCount += depth.load( std::memory_order_relaxed );
+        return pendingCount;
     }
 
     inline size_t GetLoadingCount( ) const
     {
-        return m_RunningThreads.size( );
+        return GetRunningThreadCount( );
+    }
+
+    /*
+     *
+     * Number of chunks waiting to be upgraded from status
+     *
+     * */
+    inline uint32_t GetQueueDepth( ChunkStatus status ) const
+    {
+        return m_QueueDepth[ status ].load( std::memory_order_relaxed );
+    }
+
+    /*
+     *
+     * Jobs dispatched, and jobs finished without completing any status
+     *
+     * */
+    inline uint64_t GetAttemptCount( ) const
+    {
+        return m_AttemptCount.load( std::memory_order_relaxed );
+    }
+
+    inline uint64_t GetWastedAttemptCount( ) const
+    {
+        return m_WastedAttemptCount.load( std::memory_order_relaxed );
     }
 
     inline size_t GetTotalChunk( ) const
@@ -162,7 +300,8 @@ public:
     }
 
 
-    [[nodiscard]] inline std::shared_ptr<ChunkTy> GetChunkCacheSafe( const ChunkCoordinate& coordinate )
+    // The chunk stays alive while the caller is inside an EpochGuard, or holds the chunk cache lock
+    [[nodiscard]] inline ChunkTy* GetChunkCacheSafe( const ChunkCoordinate& coordinate )
     {
         std::lock_guard<std::recursive_mutex> chunkLock( m_ChunkCacheLock );
         if ( auto it = m_ChunkCache.find( ToChunkCoordinateHash( coordinate ) ); it != m_ChunkCache.end( ) )
@@ -170,18 +309,25 @@ public:
             return it->second;
         }
 
-        return { };
+        return nullptr;
     }
 
-    // This function should only be called when ChunkCache can be confirmed not changing
-    [[nodiscard]] inline std::shared_ptr<ChunkTy> GetChunkCacheUnsafe( const ChunkCoordinate& coordinate ) const
+    // This function should only be called when ChunkCache can be confirmed not changing, i.e. from UpdateThread
+    // Chunk jobs run concurrently with cache mutation, use GetChunkCacheSafe there
+    [[nodiscard]] inline ChunkTy* GetChunkCacheUnsafe( const ChunkCoordinate& coordinate ) const
     {
         if ( auto it = m_ChunkCache.find( ToChunkCoordinateHash( coordinate ) ); it != m_ChunkCache.end( ) )
         {
             return it->second;
         }
 
-        return { };
+        return nullptr;
+    }
+
+    // No lock, nullptr once the chunk is unloaded, same lifetime rule as GetChunkCacheSafe
+    [[nodiscard]] inline ChunkTy* ResolveChunk( ChunkHandle handle ) const
+    {
+        return m_ChunkSlots.Resolve( handle );
     }
 
     [[nodiscard]] inline bool CanLoadCoordinate( const ChunkCoordinate& coordinate, ChunkStatus targetStatus ) const
@@ -0,0 +1,113 @@
+#include "ChunkPriorityQueue.hpp"
+#include "WorldChunk.hpp"
+
+uint32_t
+ChunkPriorityQueue::GetBucketIndex( const ChunkTy* cache ) const
+{
+    const uint32_t ring = std::min<uint32_t>( cache->ManhattanDistance( m_Centre ), m_MaxRing );
+
+    return ring * ChunkStatusSize + ( ChunkStatusSize - 1 - cache->GetStatus( ) );
+}
+
+void
+ChunkPriorityQueue::Insert( ChunkTy* cache )
+{
+    const auto bucketIndex = GetBucketIndex( cache );
+    auto&      bucket      = m_Buckets[ bucketIndex ];
+
+    m_Locations[ cache ] = { bucketIndex, static_cast<uint32_t>( bucket.size( ) ) };
+    bucket.push_back( cache );
+
+    ++m_StatusCount[ cache->GetStatus( ) ];
+    m_FirstNonEmpty = std::min( m_FirstNonEmpty, bucketIndex );
+}
+
+void
+ChunkPriorityQueue::RemoveAt( const Location& location )
+{
+    auto& bucket = m_Buckets[ location.bucket ];
+    auto* cache  = bucket[ location.index ];
+
+    // swap with last
+    if ( location.index != bucket.size( ) - 1 )
+    {
+        bucket[ location.index ]            = bucket.back( );
+        m_Locations[ bucket.back( ) ].index = location.index;
+    }
+
+    bucket.pop_back( );
+    --m_StatusCount[ cache->GetStatus( ) ];
+}
+
+void
+ChunkPriorityQueue::Reset( const ChunkCoordinate& centre, uint32_t maxRing )
+{
+    std::vector<ChunkTy*> queued;
+    queued.reserve( m_Locations.size( ) );
+    for ( const auto& [ cache, location ] : m_Locations )
+        queued.push_back( cache );
+
+    Clear( );
+
+    m_Centre  = centre;
+    m_MaxRing = maxRing;
+    m_Buckets.resize( ( m_MaxRing + 1 ) * ChunkStatusSize );
+    m_FirstNonEmpty = static_cast<uint32_t>( m_Buckets.size( ) );
+
+    for ( auto* cache : queued )
+        Insert( cache );
+}
+
+void
+ChunkPriorityQueue::Push( ChunkTy* cache )
+{
+    if ( !Update( cache ) ) Insert( cache );
+}
+
+bool
+ChunkPriorityQueue::Update( ChunkTy* cache )
+{
+    // Status never change while queued, per status count stay valid
+    if ( !Erase( cache ) ) return false;
+
+    Insert( cache );
+    return true;
+}
+
+bool
+ChunkPriorityQueue::Erase( ChunkTy* cache )
+{
+    auto it = m_Locations.find( cache );
+    if ( it == m_Locations.end( ) ) return false;
+
+    RemoveAt( it->second );
+    m_Locations.erase( it );
+    return true;
+}
+
+ChunkTy*
+ChunkPriorityQueue::Pop( )
+{
+    for ( ; m_FirstNonEmpty < m_Buckets.size( ); ++m_FirstNonEmpty )
+    {
+        auto& bucket = m_Buckets[ m_FirstNonEmpty ];
+        if ( bucket.empty( ) ) continue;
+
+        auto* cache = bucket.back( );
+        Erase( cache );
+        return cache;
+    }
+
+    return nullptr;
+}
+
+void
+ChunkPriorityQueue::Clear( )
+{
+    for ( auto& bucket : m_Buckets )
+        bucket.clear( );
+
+    m_Locations.clear( );
+    m_StatusCount.fill( 0 );
+    m_FirstNonEmpty = static_cast<uint32_t>( m_Buckets.size( ) );
+}
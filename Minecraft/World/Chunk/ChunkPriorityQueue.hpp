@@ -0,0 +1,90 @@
+#ifndef MINECRAFT_VK_MINECRAFT_WORLD_CHUNK_CHUNKPRIORITYQUEUE_HPP
+#define MINECRAFT_VK_MINECRAFT_WORLD_CHUNK_CHUNKPRIORITYQUEUE_HPP
+
+#include <Minecraft/util/MinecraftType.h>
+
+#include "ChunkPoolType.hpp"
+#include "ChunkStatus.hpp"
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+/*
+ *
+ * Bucketed radial queue of pending chunk jobs
+ *
+ * Only runnable chunks are queued, dependencies are resolved by ChunkPool
+ *
+ * Priority, from high to low:
+ *      Manhattan distance ring to centre
+ *      higher current status (closer to complete)
+ *
+ * Keys are cached on insertion, call Update / Reset when they become stale
+ *
+ * */
+class ChunkPriorityQueue
+{
+    struct Location {
+        uint32_t bucket;
+        uint32_t index;
+    };
+
+    ChunkCoordinate m_Centre { };
+    uint32_t        m_MaxRing = 0;
+
+    std::vector<std::vector<ChunkTy*>>    m_Buckets;
+    std::unordered_map<ChunkTy*, Location> m_Locations;
+    std::array<uint32_t, ChunkStatusSize>  m_StatusCount { };
+
+    // No bucket before this index contains any element
+    uint32_t m_FirstNonEmpty = 0;
+
+    [[nodiscard]] uint32_t GetBucketIndex( const ChunkTy* cache ) const;
+
+    void Insert( ChunkTy* cache );
+    void RemoveAt( const Location& location );
+
+public:
+    ChunkPriorityQueue( ) { Reset( { }, 0 ); }
+
+    /*
+     *
+     * Recompute all keys, only needed when centre moved
+     *
+     * */
+    void Reset( const ChunkCoordinate& centre, uint32_t maxRing );
+
+    // Insert, or recompute the key if already queued
+    void Push( ChunkTy* cache );
+
+    // Recompute the key, return false if not queued
+    bool Update( ChunkTy* cache );
+
+    bool     Erase( ChunkTy* cache );
+    ChunkTy* Pop( );
+    void     Clear( );
+
+    template <typename Pred>
+    size_t EraseIf( Pred&& pred )
+    {
+        std::vector<ChunkTy*> toErase;
+        for ( const auto& [ cache, location ] : m_Locations )
+            if ( pred( cache ) ) toErase.push_back( cache );
+
+        for ( auto* cache : toErase )
+            Erase( cache );
+
+        return toErase.size( );
+    }
+
+    [[nodiscard]] inline bool                   Contains( ChunkTy* cache ) const { return m_Locations.contains( cache ); }
+    [[nodiscard]] inline size_t                 Size( ) const { return m_Locations.size( ); }
+    [[nodiscard]] inline bool                   Empty( ) const { return m_Locations.empty( ); }
+    [[nodiscard]] inline const ChunkCoordinate& GetCentre( ) const { return m_Centre; }
+    [[nodiscard]] inline uint32_t               GetMaxRing( ) const { return m_MaxRing; }
+    [[nodiscard]] inline uint32_t               GetStatusCount( ChunkStatus status ) const { return m_StatusCount[ status ]; }
+};
+
+
+#endif   // MINECRAFT_VK_MINECRAFT_WORLD_CHUNK_CHUNKPRIORITYQUEUE_HPP
@@ -0,0 +1,84 @@
+#include "ChunkRemeshQueue.hpp"
+#include "RenderableChunk.hpp"
+
+#include <vector>
+
+void
+ChunkRemeshQueue::Request( RenderableChunk* chunk )
+{
+    ++m_RequestedCount;
+
+    std::lock_guard lock( m_QueueLock );
+    if ( !m_Requested.insert( chunk ).second )
+    {
+        ++m_CoalescedCount;
+        return;
+    }
+
+    m_RequestOrder.push_back( chunk );
+}
+
+void
+ChunkRemeshQueue::Cancel( RenderableChunk* chunk )
+{
+    std::unique_lock lock( m_QueueLock );
+    if ( m_Requested.erase( chunk ) != 0 ) std::erase( m_RequestOrder, chunk );
+
+    m_RemeshFinishedCondition.wait( lock, [ & ] { return !m_Remeshing.contains( chunk ); } );
+}
+
+void
+ChunkRemeshQueue::Remesh( RenderableChunk* chunk )
+{
+    chunk->GenerateRenderBuffer( );
+    ++m_RemeshedCount;
+
+    {
+        std::lock_guard lock( m_QueueLock );
+        m_Remeshing.erase( chunk );
+    }
+
+    m_RemeshFinishedCondition.notify_all( );
+}
+
+void
+ChunkRemeshQueue::Dispatch( )
+{
+    // finished contexts are not needed, Remesh already released them
+    CleanRunningThread( );
+
+    uint32_t                      dispatchCount = 0;
+    std::vector<RenderableChunk*> stillRemeshing;
+
+    UpdatePrioritized(
+        [ this ]( RenderableChunk* chunk ) { Remesh( chunk ); },
+        [ & ]( ) -> RenderableChunk* {
+            std::lock_guard lock( m_QueueLock );
+            while ( dispatchCount < m_FrameBudget && !m_RequestOrder.empty( ) )
+            {
+                auto* chunk = m_RequestOrder.front( );
+                m_RequestOrder.pop_front( );
+
+                // requested again while being remeshed, next frame
+                if ( m_Remeshing.contains( chunk ) )
+                {
+                    stillRemeshing.push_back( chunk );
+                    continue;
+                }
+
+                m_Requested.erase( chunk );
+                m_Remeshing.insert( chunk );
+                ++dispatchCount;
+                return chunk;
+            }
+
+            return nullptr;
+        } );
+
+    if ( stillRemeshing.empty( ) ) return;
+
+    // back to the front, unless cancelled in between
+    std::lock_guard lock( m_QueueLock );
+    std::erase_if( stillRemeshing, [ this ]( RenderableChunk* chunk ) { return !m_Requested.contains( chunk ); } );
+    m_RequestOrder.insert( m_RequestOrder.begin( ), stillRemeshing.begin( ), stillRemeshing.end( ) );
+}
@@ -0,0 +1,89 @@
+#ifndef MINECRAFT_VK_MINECRAFT_WORLD_CHUNK_CHUNKREMESHQUEUE_HPP
+#define MINECRAFT_VK_MINECRAFT_WORLD_CHUNK_CHUNKREMESHQUEUE_HPP
+
+#include <Utility/Thread/ThreadPool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_set>
+
+class RenderableChunk;
+
+/*
+ *
+ * Deferred remeshing of chunks, RenderableChunk::GenerateRenderBuffer runs on the queue's own workers
+ *
+ * Requests only set a chunk pending, every request made before it is dispatched is served by the same remesh
+ * Dispatch hands out at most the frame budget and one chunk per idle worker, in request order
+ * A chunk still being remeshed is never handed out again, so it is remeshed at most once per Dispatch
+ * What is left waits for the next one
+ *
+ * Call Dispatch once per frame, Request and Cancel from any thread
+ *
+ * */
+class ChunkRemeshQueue : public ThreadPool<RenderableChunk>
+{
+public:
+    struct Statistics {
+        uint64_t requested = 0;
+        uint64_t coalesced = 0;   // requests for a chunk already pending
+        uint64_t remeshed  = 0;
+    };
+
+private:
+    std::mutex                           m_QueueLock;
+    std::condition_variable              m_RemeshFinishedCondition;
+    std::deque<RenderableChunk*>         m_RequestOrder;
+    std::unordered_set<RenderableChunk*> m_Requested;   // same chunks as m_RequestOrder
+    std::unordered_set<RenderableChunk*> m_Remeshing;   // dispatched and not finished
+
+    uint32_t m_FrameBudget;
+
+    std::atomic<uint64_t> m_RequestedCount = 0;
+    std::atomic<uint64_t> m_CoalescedCount = 0;
+    std::atomic<uint64_t> m_RemeshedCount  = 0;
+
+    void Remesh( RenderableChunk* chunk );
+
+public:
+    explicit ChunkRemeshQueue( uint32_t maxThread, uint32_t frameBudget )
+        : ThreadPool<RenderableChunk>( maxThread )
+        , m_FrameBudget( std::max( frameBudget, 1U ) )
+    { }
+
+    // Workers use the queue, stop them first
+    ~ChunkRemeshQueue( ) { StopWorkers( ); }
+
+    void Request( RenderableChunk* chunk );
+
+    /*
+     *
+     * Drop a pending request and wait for a running remesh of chunk to finish
+     * Called by the chunk destructor, the caller must not hold the chunk's sync lock or the allocation owner lock
+     *
+     * */
+    void Cancel( RenderableChunk* chunk );
+
+    void Dispatch( );
+
+    inline void     SetFrameBudget( uint32_t frameBudget ) { m_FrameBudget = std::max( frameBudget, 1U ); }
+    inline uint32_t GetFrameBudget( ) const { return m_FrameBudget; }
+
+    size_t GetPendingCount( )
+    {
+        std::lock_guard lock( m_QueueLock );
+        return m_RequestOrder.size( );
+    }
+
+    Statistics GetStatistics( ) const
+    {
+        return { m_RequestedCount.load( std::memory_order_relaxed ), m_CoalescedCount.load( std::memory_order_relaxed ), m_RemeshedCount.load( std::memory_order_relaxed ) };
+    }
+};
+
+
+#endif   // MINECRAFT_VK_MINECRAFT_WORLD_CHUNK_CHUNKREMESHQUEUE_HPP
@@ -6,13 +6,22 @@
 #define MINECRAFT_VK_MINECRAFT_WORLD_CHUNK_CHUNKRENDERBUFFERS_HPP
 
 #include <Graphic/Vulkan/BufferMeta.hpp>
+#include <Graphic/Vulkan/StagingRing.hpp>
 #include <Graphic/Vulkan/VulkanAPI.hpp>
 #include <Include/vk_mem_alloc.h>
 #include <Minecraft/util/MinecraftConstants.hpp>
 #include <Utility/Math/Math.hpp>
 
 #include <Minecraft/util/Tickable.hpp>
+#include <Utility/Memory/TLSFAllocator.hpp>
+
 #include <deque>
+#include <list>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 template <typename VertexTy, typename IndexTy>
 class ChunkRenderBuffers : public Tickable
@@ -20,41 +29,29 @@ class ChunkRenderBuffers : public Tickable
 {
 
 public:
+    // Per draw data fed with instance rate, commands point at their entry with firstInstance
+    using ChunkOriginTy = typename VertexTy::ChunkOriginTy;
+
+    // Quads only, indices come from the shared quad index buffer
     struct SingleBufferRegion {
         uint32_t vertexStartingOffset;
         uint32_t vertexSize;
 
-        uint32_t indexStartingOffset;
-        uint32_t indexSize;
-
-        inline void SetBufferAllocation( uint32_t startingPoint, uint32_t vertexDataSize, uint32_t indexDataSize )
-        {
-            vertexStartingOffset = startingPoint;
-            vertexSize           = vertexDataSize;
-            indexStartingOffset  = AlignTo<uint32_t>( startingPoint + vertexDataSize, sizeof( IndexTy ) );
-            indexSize            = indexDataSize;
-        }
-
-        inline uint32_t GetOffsetDiff( )
-        {
-            assert( indexStartingOffset > vertexStartingOffset );
-            return indexStartingOffset - vertexStartingOffset;
-        }
-
-        inline uint32_t GetVertexEndingPoint( ) const { return vertexStartingOffset + vertexSize; }
-        inline uint32_t GetIndexEndingPoint( ) const { return indexStartingOffset + indexSize; }
-
         inline uint32_t GetStartingPoint( ) const { return vertexStartingOffset; }
-        inline uint32_t GetEndingPoint( ) const { return indexStartingOffset + indexSize; }
-        inline uint32_t GetBufferSize( ) const { return vertexSize + indexSize; }
-        inline uint32_t GetTotalSize( ) const { return GetEndingPoint( ) - GetStartingPoint( ); }
+        inline uint32_t GetEndingPoint( ) const { return vertexStartingOffset + vertexSize; }
+        inline uint32_t GetTotalSize( ) const { return vertexSize; }
+
+        inline uint32_t GetFirstVertex( ) const { return ScaleToSecond<sizeof( VertexTy ), 1, uint32_t>( vertexStartingOffset ); }
+        inline uint32_t GetIndexCount( ) const { return ScaleToSecond<sizeof( VertexTy ) * FaceVerticesCount, FaceIndicesCount, uint32_t>( vertexSize ); }
 
         inline bool operator==( const SingleBufferRegion& other )
         {
-            return vertexStartingOffset == other.vertexStartingOffset && vertexSize == other.vertexSize && indexStartingOffset == other.indexStartingOffset && indexSize == other.indexSize;
+            return vertexStartingOffset == other.vertexStartingOffset && vertexSize == other.vertexSize;
         }
     };
 
+    struct SuitableAllocation;
+
 private:
     VmaAllocator allocator { };
 
@@ -63,10 +60,7 @@ private:
 
         explicit BufferChunk( )
             : allocator( VulkanAPI::GetInstance( ).getMemoryAllocator( ) )
-        {
-            stagingBuffer.SetAllocator( );
-            indirectDrawBuffers.SetAllocator( );
-        }
+        { }
 
         ~BufferChunk( )
         {
@@ -77,17 +71,51 @@ private:
         vk::Buffer    buffer { };
         VmaAllocation bufferAllocation { };
 
+        /*
+         *
+         * Command table, a command keeps its slot until removed and the slot is also its firstInstance
+         * Removing moves the last command into the hole, only changed slots are uploaded
+         *
+         * */
         std::vector<vk::DrawIndexedIndirectCommand> indirectCommands;
-
-        bool       shouldUpdateIndirectDrawBuffers = false;
-        std::mutex indirectDrawBuffersMutex { };
-        uint32_t   indirectDrawBufferSize = 0;
-        BufferMeta stagingBuffer;
-        BufferMeta indirectDrawBuffers;
-
-        void UpdateIndirectDrawBuffers( );
-
-        std::vector<SingleBufferRegion> m_DataSlots;
+        std::vector<ChunkOriginTy>                  drawOrigins;    // same slots as indirectCommands
+        std::unordered_map<int32_t, uint32_t>       commandSlots;   // vertexOffset to slot
+        std::vector<uint32_t>                       dirtySlots;
+        std::mutex                                  indirectDrawBuffersMutex { };
+
+        // All below need indirectDrawBuffersMutex
+        void AddCommand( vk::DrawIndexedIndirectCommand command, const ChunkOriginTy& origin );
+        void RemoveCommand( int32_t vertexOffset, vk::DrawIndexedIndirectCommand* removedCommand = nullptr, ChunkOriginTy* removedOrigin = nullptr );
+
+        // Marked to be uploaded, nullptr if no command starts at vertexOffset
+        vk::DrawIndexedIndirectCommand* ModifyCommand( int32_t vertexOffset );
+
+        /*
+         *
+         * Device copy of the table, read by the frames in flight
+         * Replaced buffers are kept for as many frames as there are swap chain images
+         * Culled commands and their count are written by ChunkCullPass, only created with draw indirect count support
+         *
+         * */
+        std::unique_ptr<BufferMeta>                              indirectCommandBuffer, drawOriginBuffer;
+        std::unique_ptr<BufferMeta>                              culledCommandBuffer, drawCountBuffer;
+        uint32_t                                                 drawBufferCapacity = 0;
+        std::vector<std::pair<std::unique_ptr<BufferMeta>, int>> retiredDrawBuffers;
+        uint32_t                                                 frameDrawCount    = 0;   // valid for the frame being recorded
+        uint32_t                                                 uploadedDrawCount = 0;   // commands in the device table after the last complete upload
+
+        struct DrawBufferCopy {
+            vk::Buffer     source, destination;
+            vk::BufferCopy region;
+        };
+
+        // Stage dirty slots in frameRing, copies to the device table are appended to copies
+        void UpdateIndirectDrawBuffers( StagingRing& frameRing, std::vector<DrawBufferCopy>& copies );
+
+        TLSFAllocator m_Allocator { MaxMemoryAllocation, sizeof( VertexTy ) };
+
+        // Allocation owners by offset, compaction writes the moved allocation back to them
+        std::unordered_map<uint32_t, SuitableAllocation*> allocationOwners;
     };
 
 public:
@@ -97,45 +125,170 @@ public:
 
         friend std::ostream& operator<<( std::ostream& o, const SuitableAllocation& sa )
         {
-            o << "[ " << sa.targetChunk << " ] : (" << sa.region.vertexStartingOffset << ", " << sa.region.vertexSize << ", " << sa.region.indexStartingOffset << ", " << sa.region.indexSize << ')' << std::flush;
+            o << "[ " << sa.targetChunk << " ] : (" << sa.region.vertexStartingOffset << ", " << sa.region.vertexSize << ')' << std::flush;
             return o;
         }
     };
 
 private:
-    std::recursive_mutex    buffersMutex { };
-    std::deque<BufferChunk> m_Buffers;
+    std::recursive_mutex   buffersMutex { };
+    std::list<BufferChunk> m_Buffers;   // chunks are released from the middle, SuitableAllocation keeps pointers
+
+    // Snapshot of m_Buffers taken by UpdateAllIndirectDrawBuffers, only used on the render thread
+    // Remesh workers can grow m_Buffers at any time, the frame being recorded walks this instead
+    std::vector<BufferChunk*> m_FrameBuffers;
 
     std::mutex                                     m_PendingErasesLock;
     std::deque<std::pair<SuitableAllocation, int>> m_PendingErases;
 
-    float cleanupTimer { };
+    /*
+     *
+     * Index pattern of quads shared by every draw, commands start at vertexOffset
+     * Mesh allocations can then move without rewriting anything but the command
+     *
+     * */
+    BufferMeta m_QuadIndexBuffer;
+
+    /*
+     *
+     * Mesh uploads
+     *
+     * CopyBuffer only writes into the staging ring, FlushUploads records every pending copy into one transfer submission
+     * Ownership of the written ranges is handed to the graphics queue, batches are retired by fence
+     * A command only starts drawing once its upload is submitted, replaced allocations keep drawing until then
+     *
+     * */
+    struct PendingUpload {
+        BufferChunk*   targetChunk { };
+        vk::Buffer     stagingBuffer { };
+        vk::BufferCopy region { };
+    };
+
+    struct UploadBatch {
+        vk::UniqueCommandBuffer transferCommandBuffer;
+        vk::UniqueCommandBuffer acquireCommandBuffer;
+        vk::UniqueSemaphore     transferCompleteSemaphore;
+        vk::UniqueFence         completeFence;
 
-    void GrowCapacity( );
+        std::vector<std::unique_ptr<BufferMeta>> overflowStagingBuffers;
+    };
+
+    std::mutex                               m_UploadLock;
+    StagingRing                              m_UploadStagingRing;
+    std::vector<PendingUpload>               m_PendingUploads;
+    std::vector<std::unique_ptr<BufferMeta>> m_PendingOverflowStagingBuffers;
+
+    // new allocation, allocation it replaces
+    std::vector<std::pair<SuitableAllocation, SuitableAllocation>> m_ReplacedAllocations;
+
+    // Stage a write of vertexBuffer into allocation, needs m_UploadLock
+    void QueueUpload( const SuitableAllocation& allocation, void* vertexBuffer );
+
+    uint32_t                 m_UploadFamilyIndex { };
+    vk::UniqueCommandPool    m_UploadCommandPool;
+    vk::UniqueCommandPool    m_AcquireCommandPool;
+    std::deque<UploadBatch>  m_InFlightUploadBatches;
+    std::vector<UploadBatch> m_FreeUploadBatches;
+
+    /*
+     *
+     * Compaction
+     *
+     * The least used buffer chunk is evacuated a budget of bytes per frame, with copies on the graphics queue
+     * Moved commands and owners point to the new region right away, the old region is freed as a delayed delete
+     * New allocations skip the evacuating chunk, it is destroyed once its last region is freed
+     *
+     * */
+public:
+    struct CompactionStatistics {
+        uint64_t bytesMoved      = 0;
+        uint32_t regionsMoved    = 0;
+        uint32_t buffersReleased = 0;
+    };
+
+private:
+    std::mutex           m_AllocationOwnerLock;
+    BufferChunk*         m_EvacuatingChunk { };
+    CompactionStatistics m_CompactionStatistics;
+
+    BufferChunk* PickEvacuatingChunk( );
+
+    void        GrowCapacity( );
+    void        CreateQuadIndexBuffer( );
+    void        SetupUploads( );
+    UploadBatch GetUploadBatch( );
+    void        RetireUploadBatches( bool wait );
 
 public:
     explicit ChunkRenderBuffers( )
         : allocator( VulkanAPI::GetInstance( ).getMemoryAllocator( ) )
-    { }
+    {
+        CreateQuadIndexBuffer( );
+        SetupUploads( );
+    }
     ~ChunkRenderBuffers( );
 
-    SuitableAllocation CreateBuffer( uint32_t vertexDataSize, uint32_t indexDataSize );
+    SuitableAllocation CreateBuffer( uint32_t vertexDataSize, const ChunkOriginTy& origin );
     void               DeleteBuffer( const ChunkRenderBuffers::SuitableAllocation& allocation );
     void               DelayedDeleteBuffer( const ChunkRenderBuffers::SuitableAllocation& allocation );
-    SuitableAllocation AlterBuffer( const ChunkRenderBuffers::SuitableAllocation& allocation, uint32_t vertexDataSize, uint32_t indexDataSize );
-    void               CopyBuffer( SuitableAllocation allocation, void* vertexBuffer, void* indexBuffer );
+    SuitableAllocation AlterBuffer( const ChunkRenderBuffers::SuitableAllocation& allocation, uint32_t vertexDataSize, const ChunkOriginTy& origin );
+    void               CopyBuffer( SuitableAllocation allocation, void* vertexBuffer );
+
+    // CopyBuffer for every pair together, they start drawing in the same FlushUploads
+    void CopyBuffers( std::span<const std::pair<SuitableAllocation, void*>> uploads );
 
-    void UpdateAllIndirectDrawBuffers( )
+    // Submit every upload queued by CopyBuffer, call from the render thread once per frame
+    void FlushUploads( );
+
+    // Compaction may move the allocation *owner holds and write the new one back, until it is altered or deleted
+    // Owners read and write their allocation, and call into this class with it, only under GetAllocationOwnerLock
+    void         SetAllocationOwner( SuitableAllocation* owner );
+    inline auto& GetAllocationOwnerLock( ) { return m_AllocationOwnerLock; }
+
+    // Move up to byteBudget of meshes out of the least used buffer chunk, call from the render thread after FlushUploads
+    void Compact( uint32_t byteBudget );
+
+    CompactionStatistics GetCompactionStatistics( )
     {
-        for ( auto& chunk : m_Buffers )
-        {
-            chunk.UpdateIndirectDrawBuffers( );
-        }
+        std::lock_guard<std::recursive_mutex> lock( buffersMutex );
+        return m_CompactionStatistics;
+    }
+
+    inline const auto& GetQuadIndexBuffer( ) const { return m_QuadIndexBuffer; }
+
+    // Regions of every buffer chunk added together
+    TLSFAllocator::Statistics GetAllocationStatistics( )
+    {
+        std::lock_guard<std::recursive_mutex> lock( buffersMutex );
+
+        TLSFAllocator::Statistics statistics;
+        for ( const auto& chunk : m_Buffers )
+            statistics += chunk.m_Allocator.GetStatistics( );
+
+        return statistics;
     }
 
+    // Upload changed commands and origins through frameRing, call from the render thread outside the render pass
+    void UpdateAllIndirectDrawBuffers( StagingRing& frameRing, const vk::CommandBuffer& commandBuffer );
+
     void Clean( )
     {
+        RetireUploadBatches( true );
+
+        {
+            std::lock_guard<std::mutex> lock( m_UploadLock );
+            m_PendingUploads.clear( );
+            m_PendingOverflowStagingBuffers.clear( );
+            m_ReplacedAllocations.clear( );
+
+            // written but never submitted
+            m_UploadStagingRing.Release( );
+            m_UploadStagingRing.Retire( );
+        }
+
         m_PendingErases.clear( );
+        m_EvacuatingChunk = nullptr;
+        m_FrameBuffers.clear( );
         m_Buffers.clear( );
     }
 
@@ -146,20 +299,18 @@ public:
         return m_PendingErases.empty( );
     }
 
+    // Once per frame, a delayed delete is freed after every frame that could still draw it
     inline void Tick( float deltaTime )
     {
-        cleanupTimer += deltaTime;
-        if ( cleanupTimer > 1 )
+        (void) deltaTime;
+
+        std::lock_guard<std::mutex> lock( m_PendingErasesLock );
+        for ( int i = 0; i < m_PendingErases.size( ); ++i )
         {
-            cleanupTimer = 0;
-            std::lock_guard<std::mutex> lock( m_PendingErasesLock );
-            for ( int i = 0; i < m_PendingErases.size( ); ++i )
+            if ( --m_PendingErases[ i ].second <= 0 )
             {
-                if ( m_PendingErases[ i ].second-- > 0 )
-                {
-                    DeleteBuffer( m_PendingErases[ i ].first );
-                    m_PendingErases.erase( m_PendingErases.begin( ) + i-- );
-                }
+                DeleteBuffer( m_PendingErases[ i ].first );
+                m_PendingErases.erase( m_PendingErases.begin( ) + i-- );
             }
         }
     }
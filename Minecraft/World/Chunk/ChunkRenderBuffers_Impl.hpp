@@ -10,7 +10,18 @@
 #include <Utility/Logger.hpp>
 
 #include "ChunkRenderBuffers.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cmath>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
 
 namespace
 {
@@ -29,273 +40,806 @@ sum_components( Tuple const& tuple )
     template <typename VertexTy, typename IndexTy> \
     __VA_ARGS__ ChunkRenderBuffers<VertexTy, IndexTy>
 
-ClassName( typename ChunkRenderBuffers<VertexTy, IndexTy>::SuitableAllocation )::CreateBuffer( uint32_t vertexDataSize, uint32_t indexDataSize )
+ClassName( typename ChunkRenderBuffers<VertexTy, IndexTy>::SuitableAllocation )::CreateBuffer( uint32_t vertexDataSize, const ChunkOriginTy& origin )
 {
     std::lock_guard<std::recursive_mutex> lock( buffersMutex );
 
-    const auto requitedSize = AlignTo<uint32_t>( vertexDataSize, sizeof( IndexTy ) ) + indexDataSize;
-    if ( m_Buffers.empty( ) )
-    {
-        assert( requitedSize < MaxMemoryAllocation );
-        GrowCapacity( );
-    }
+    assert( ScaleToSecond<1, sizeof( VertexTy ) * FaceVerticesCount>( MaxQuadPerDraw ) >= vertexDataSize );
+
+    // empty mesh still needs an offset of its own, commands are found by it
+    const auto requitedSize = std::max<uint32_t>( vertexDataSize, sizeof( VertexTy ) );
 
-    std::vector<SuitableAllocation> suitableAllocations;
+    BufferChunk* chunkUsing = nullptr;
+    uint32_t     offset     = TLSFAllocator::InvalidOffset;
     for ( auto& bufferChunk : m_Buffers )
     {
-        for ( int i = 1; i < bufferChunk.m_DataSlots.size( ); ++i )
-        {
-            auto prevEnd  = AlignTo<uint32_t>( bufferChunk.m_DataSlots[ i - 1 ].GetEndingPoint( ), sizeof( VertexTy ) );
-            auto sizeDiff = bufferChunk.m_DataSlots[ i ].GetStartingPoint( ) - prevEnd;
-            if ( sizeDiff >= requitedSize )
-            {
-                suitableAllocations.push_back( SuitableAllocation {
-                    &bufferChunk, {prevEnd, sizeDiff}
-                } );
-            }
-        }
+        if ( &bufferChunk == m_EvacuatingChunk ) continue;
 
-        auto firstGap = MaxMemoryAllocation;
-        if ( !bufferChunk.m_DataSlots.empty( ) ) firstGap = bufferChunk.m_DataSlots.front( ).GetStartingPoint( );
-        if ( firstGap >= requitedSize )
+        offset = bufferChunk.m_Allocator.Allocate( requitedSize );
+        if ( offset != TLSFAllocator::InvalidOffset )
         {
-            suitableAllocations.push_back( SuitableAllocation {
-                &bufferChunk, {0, firstGap, 0}
-            } );
+            chunkUsing = &bufferChunk;
+            break;
         }
+    }
 
-        auto lastGap = MaxMemoryAllocation;
-        if ( !bufferChunk.m_DataSlots.empty( ) ) lastGap -= AlignTo<uint32_t>( bufferChunk.m_DataSlots.back( ).GetEndingPoint( ), sizeof( VertexTy ) );
-        if ( lastGap >= requitedSize )
-        {
-            suitableAllocations.push_back( SuitableAllocation {
-                &bufferChunk, {MaxMemoryAllocation - lastGap, lastGap, 0}
-            } );
-        }
+    if ( chunkUsing == nullptr )
+    {
+        assert( requitedSize <= MaxMemoryAllocation );
+        GrowCapacity( );
+
+        chunkUsing = &m_Buffers.back( );
+        offset     = chunkUsing->m_Allocator.Allocate( requitedSize );
+
+        // the new buffer chunk is kept for later allocations
+        if ( offset == TLSFAllocator::InvalidOffset ) throw std::runtime_error( "Chunk mesh of " + std::to_string( requitedSize ) + " bytes does not fit in an empty buffer chunk" );
     }
 
-    if ( !suitableAllocations.empty( ) )
+    const SingleBufferRegion newAllocation { offset, vertexDataSize };
+
     {
-        const auto optimalBufferSize = requitedSize + ( OptimalBufferGap << 1 );
-        std::sort( suitableAllocations.begin( ), suitableAllocations.end( ), [ optimalBufferSize ]( const SuitableAllocation& a, const SuitableAllocation& b ) {
-            const auto aDiff = AbsDiff( a.region.vertexSize, optimalBufferSize );
-            const auto bDiff = AbsDiff( b.region.vertexSize, optimalBufferSize );
+        vk::DrawIndexedIndirectCommand newCommand;
+        newCommand.instanceCount = 1;
+        newCommand.firstIndex    = 0;
+        newCommand.vertexOffset  = (int32_t) newAllocation.GetFirstVertex( );
+        newCommand.indexCount    = 0;   // until the mesh is uploaded, see FlushUploads
+
+        std::lock_guard<std::mutex> indirectLock( chunkUsing->indirectDrawBuffersMutex );
+        chunkUsing->AddCommand( newCommand, origin );
+    }
 
-            // TODO: test if this is optimal
-            if ( aDiff == bDiff )
-                return a.region.vertexSize < b.region.vertexSize;
+    // Logger::getInstance( ).LogLine( Logger::LogType::eVerbose, "New Buffer at", std::make_tuple( newAllocation.vertexStartingOffset, newAllocation.vertexSize ) );
+    return { chunkUsing, newAllocation };
+}
 
-            return aDiff < bDiff;
-        } );
+// #define ALTER_IN_PLACE
 
-        auto& chunkUsing  = *suitableAllocations.begin( )->targetChunk;
-        auto& regionUsing = suitableAllocations.begin( )->region;
+ClassName( typename ChunkRenderBuffers<VertexTy, IndexTy>::SuitableAllocation )::AlterBuffer( const ChunkRenderBuffers::SuitableAllocation& allocation, uint32_t vertexDataSize, const ChunkOriginTy& origin )
+{
+    {
+        // owner sets it again on the altered allocation
+        std::lock_guard<std::recursive_mutex> bufferLock( buffersMutex );
+        allocation.targetChunk->allocationOwners.erase( allocation.region.vertexStartingOffset );
+    }
+
+#ifdef ALTER_IN_PLACE
+
+    {
+        std::lock_guard<std::recursive_mutex> bufferLock( buffersMutex );
+        std::lock_guard<std::mutex>           indirectLock( allocation.targetChunk->indirectDrawBuffersMutex );
 
-        // leave space for gap
-        if ( regionUsing.vertexStartingOffset != 0 && regionUsing.vertexSize > requitedSize )
+        // shrink, or expand into the free space right after
+        if ( allocation.targetChunk->m_Allocator.TryResize( allocation.region.vertexStartingOffset, std::max<uint32_t>( vertexDataSize, sizeof( VertexTy ) ) ) )
         {
-            const auto additionalSpace = std::min( regionUsing.vertexSize - requitedSize, optimalBufferSize << 1 );
-            regionUsing.vertexSize += additionalSpace >> 1;
+            const SingleBufferRegion resizedAllocation { allocation.region.vertexStartingOffset, vertexDataSize };
+
+            auto* oldCommand = allocation.targetChunk->ModifyCommand( (int32_t) allocation.region.GetFirstVertex( ) );
+            assert( oldCommand != nullptr );
+            oldCommand->indexCount = resizedAllocation.GetIndexCount( );
+
+            return { allocation.targetChunk, resizedAllocation };
         }
 
-        SingleBufferRegion newAllocation = regionUsing;
-        newAllocation.SetBufferAllocation( newAllocation.vertexStartingOffset, vertexDataSize, indexDataSize );
+        Logger::getInstance( ).LogLine( Logger::LogType::eInfo, "Relocating buffer allocation" );
 
-        const auto insertIter = std::find_if( chunkUsing.m_DataSlots.begin( ), chunkUsing.m_DataSlots.end( ), [ newAllocation ]( const SingleBufferRegion& d ) { return d.vertexStartingOffset > newAllocation.vertexStartingOffset; } );
-        chunkUsing.m_DataSlots.insert( insertIter, newAllocation );
+        // else delete this allocation and find new allocation
+        allocation.targetChunk->m_Allocator.Free( allocation.region.vertexStartingOffset );
+        allocation.targetChunk->RemoveCommand( (int32_t) allocation.region.GetFirstVertex( ) );
+    }
 
-        {
-            std::lock_guard<std::mutex> indirectLock( chunkUsing.indirectDrawBuffersMutex );
-            auto&                       newCommand = chunkUsing.indirectCommands.emplace_back( );
+    return CreateBuffer( vertexDataSize, origin );
 
-            newCommand.instanceCount = 1;
-            newCommand.firstInstance = 0;   // chunkUsing.m_DataSlots.size( ) - 1;
-            newCommand.firstIndex    = ScaleToSecond<sizeof( IndexTy ), 1>( newAllocation.indexStartingOffset );
-            newCommand.indexCount    = ScaleToSecond<sizeof( IndexTy ), 1>( indexDataSize );
-        }
-        chunkUsing.shouldUpdateIndirectDrawBuffers = true;
+#else
+
+    // old mesh keeps drawing until the new one is uploaded
+    const auto newAllocation = CreateBuffer( vertexDataSize, origin );
+
+    std::lock_guard<std::mutex> lock( m_UploadLock );
+    m_ReplacedAllocations.emplace_back( newAllocation, allocation );
+
+    return newAllocation;
+
+#endif
+}
+
+ClassName( void )::SetAllocationOwner( SuitableAllocation* owner )
+{
+    std::lock_guard<std::recursive_mutex> bufferLock( buffersMutex );
+    owner->targetChunk->allocationOwners[ owner->region.vertexStartingOffset ] = owner;
+}
+
+ClassName( void )::GrowCapacity( )
+{
+    using Usage = vk::BufferUsageFlagBits;
+
+    auto& newBuffer = m_Buffers.emplace_back( );
+
+    vk::BufferCreateInfo    bufferInfo { { }, MaxMemoryAllocation, Usage::eVertexBuffer | Usage::eTransferDst, vk::SharingMode::eExclusive };
+    VmaAllocationCreateInfo allocInfo = { };
+    allocInfo.usage                   = VMA_MEMORY_USAGE_GPU_ONLY;
+    allocInfo.flags                   = VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+
+    vmaCreateBuffer( allocator, reinterpret_cast<const VkBufferCreateInfo*>( &bufferInfo ), &allocInfo, reinterpret_cast<VkBuffer*>( &newBuffer.buffer ), &newBuffer.bufferAllocation, nullptr );
+}
+
+ClassName( void )::CreateQuadIndexBuffer( )
+{
+    using Usage = vk::BufferUsageFlagBits;
+
+    static constexpr std::array<IndexTy, FaceIndicesCount> quadIndices = { 0, 1, 2, 2, 3, 0 };
+
+    const auto indexCount = ScaleToSecond<1, FaceIndicesCount>( MaxQuadPerDraw );
+    auto       indices    = std::make_unique<IndexTy[]>( indexCount );
+    for ( uint32_t i = 0, quadVertex = 0; i < indexCount; i += FaceIndicesCount, quadVertex += FaceVerticesCount )
+        for ( int k = 0; k < FaceIndicesCount; ++k )
+            indices[ i + k ] = quadIndices[ k ] + quadVertex;
+
+    const vk::DeviceSize indexBufferSize = ScaleToSecond<1, sizeof( IndexTy )>( indexCount );
+
+    BufferMeta stagingBuffer;
+    stagingBuffer.SetAllocator( );
+    stagingBuffer.Create( indexBufferSize, Usage::eTransferSrc );
+    stagingBuffer.writeBuffer( indices.get( ), indexBufferSize );
+
+    m_QuadIndexBuffer.SetAllocator( );
+    m_QuadIndexBuffer.Create( indexBufferSize, Usage::eIndexBuffer | Usage::eTransferDst, VMA_MEMORY_USAGE_GPU_ONLY );
+
+    vk::BufferCopy bufferRegion;
+    bufferRegion.setSize( indexBufferSize );
+    m_QuadIndexBuffer.CopyFromBuffer( stagingBuffer, bufferRegion, VulkanAPI::GetInstance( ) );
+}
 
-        // Logger::getInstance( ).LogLine( Logger::LogType::eVerbose, "New Buffer at", std::make_tuple( newAllocation.vertexStartingOffset, newAllocation.indexStartingOffset, newAllocation.vertexSize, newAllocation.indexSize ) );
-        return { &chunkUsing, newAllocation };
+ClassName( )::~ChunkRenderBuffers( )
+{
+    Clean( );
+}
+
+ClassName( void )::QueueUpload( const ChunkRenderBuffers::SuitableAllocation& allocation, void* vertexBuffer )
+{
+    using Usage = vk::BufferUsageFlagBits;
+
+    const uint32_t uploadSize = allocation.region.GetTotalSize( );
 
+    PendingUpload upload { allocation.targetChunk };
+    upload.region.setDstOffset( allocation.region.vertexStartingOffset ).setSize( uploadSize );
+
+    if ( const auto staging = m_UploadStagingRing.Write( vertexBuffer, uploadSize ) )
+    {
+        upload.stagingBuffer = staging.buffer;
+        upload.region.setSrcOffset( staging.offset );
     } else
     {
-        assert( requitedSize < MaxMemoryAllocation );
-        GrowCapacity( );
+        // ring is taken by in flight uploads, never wait for them
+        auto& stagingBuffer = m_PendingOverflowStagingBuffers.emplace_back( std::make_unique<BufferMeta>( ) );
+        stagingBuffer->SetAllocator( );
+        stagingBuffer->Create( uploadSize, Usage::eTransferSrc );
+        stagingBuffer->writeBuffer( vertexBuffer, uploadSize );
 
-        return CreateBuffer( vertexDataSize, indexDataSize );
+        upload.stagingBuffer = stagingBuffer->GetBuffer( );
     }
+
+    m_PendingUploads.push_back( upload );
 }
 
-// #define ALTER_IN_PLACE
+ClassName( void )::CopyBuffer( ChunkRenderBuffers::SuitableAllocation allocation, void* vertexBuffer )
+{
+    // write while holding the lock, FlushUploads releases every write made so far with its batch
+    std::lock_guard<std::mutex> lock( m_UploadLock );
+    QueueUpload( allocation, vertexBuffer );
+}
 
-ClassName( typename ChunkRenderBuffers<VertexTy, IndexTy>::SuitableAllocation )::AlterBuffer( const ChunkRenderBuffers::SuitableAllocation& allocation, uint32_t vertexDataSize, uint32_t indexDataSize )
+ClassName( void )::CopyBuffers( std::span<const std::pair<SuitableAllocation, void*>> uploads )
 {
+    // one hold of the lock, so no FlushUploads can take only part of them
+    std::lock_guard<std::mutex> lock( m_UploadLock );
+    for ( const auto& [ allocation, vertexBuffer ] : uploads )
+        QueueUpload( allocation, vertexBuffer );
+}
 
-#ifdef ALTER_IN_PLACE
+ClassName( void )::SetupUploads( )
+{
+    auto& api    = VulkanAPI::GetInstance( );
+    auto& device = api.getLogicalDevice( );
+
+    m_UploadStagingRing.Create( UploadStagingRingSize, vk::BufferUsageFlagBits::eTransferSrc, VMA_MEMORY_USAGE_CPU_ONLY );
 
+    m_UploadFamilyIndex = api.GetTransferFamilyIndices( ).resources.first;
+
+    m_UploadCommandPool  = device.createCommandPoolUnique( { { vk::CommandPoolCreateFlagBits::eResetCommandBuffer }, m_UploadFamilyIndex } );
+    m_AcquireCommandPool = device.createCommandPoolUnique( { { vk::CommandPoolCreateFlagBits::eResetCommandBuffer }, api.getGraphicFamilyIndex( ) } );
+}
+
+ClassName( typename ChunkRenderBuffers<VertexTy, IndexTy>::UploadBatch )::GetUploadBatch( )
+{
+    auto& device = VulkanAPI::GetInstance( ).getLogicalDevice( );
+
+    UploadBatch batch;
+    if ( !m_FreeUploadBatches.empty( ) )
     {
-        std::lock_guard<std::recursive_mutex> bufferLock( buffersMutex );
-        std::lock_guard<std::mutex>           indirectLock( allocation.targetChunk->indirectDrawBuffersMutex );
+        batch = std::move( m_FreeUploadBatches.back( ) );
+        m_FreeUploadBatches.pop_back( );
+
+        device.resetFences( batch.completeFence.get( ) );
+    } else
+    {
+        vk::CommandBufferAllocateInfo allocInfo { };
+        allocInfo.setLevel( vk::CommandBufferLevel::ePrimary );
+        allocInfo.setCommandBufferCount( 1 );
 
-        const auto& bufferSize = allocation.region.GetTotalSize( );
+        allocInfo.setCommandPool( m_UploadCommandPool.get( ) );
+        batch.transferCommandBuffer = std::move( device.allocateCommandBuffersUnique( allocInfo ).front( ) );
+        allocInfo.setCommandPool( m_AcquireCommandPool.get( ) );
+        batch.acquireCommandBuffer = std::move( device.allocateCommandBuffersUnique( allocInfo ).front( ) );
 
-        const auto newRequitedSize = AlignTo<uint32_t>( vertexDataSize, sizeof( IndexTy ) ) + indexDataSize;
+        batch.transferCompleteSemaphore = device.createSemaphoreUnique( { } );
+        batch.completeFence             = device.createFenceUnique( { } );
+    }
 
-        auto allocationIter = std::find( allocation.targetChunk->m_DataSlots.begin( ), allocation.targetChunk->m_DataSlots.end( ), allocation.region );
-        assert( allocationIter != allocation.targetChunk->m_DataSlots.end( ) );
+    return batch;
+}
 
-        auto oldCommandIter = std::find_if( allocation.targetChunk->indirectCommands.begin( ), allocation.targetChunk->indirectCommands.end( ), [ originalFirstIndex = ScaleToSecond<sizeof( IndexTy ), 1>( allocation.region.indexStartingOffset ) ]( const vk::DrawIndexedIndirectCommand& command ) { return command.firstIndex == originalFirstIndex; } );
-        assert( oldCommandIter != allocation.targetChunk->indirectCommands.end( ) );
+ClassName( void )::RetireUploadBatches( bool wait )
+{
+    auto& device = VulkanAPI::GetInstance( ).getLogicalDevice( );
 
-        if ( newRequitedSize <= bufferSize )
+    while ( !m_InFlightUploadBatches.empty( ) )
+    {
+        auto& batch = m_InFlightUploadBatches.front( );
+        if ( wait )
         {
-            // we don't allocate a buffer that is smaller than our current size
+            const auto waitResult = device.waitForFences( batch.completeFence.get( ), true, std::numeric_limits<uint64_t>::max( ) );
+            assert( waitResult == vk::Result::eSuccess );
+            (void) waitResult;
+        } else if ( device.getFenceStatus( batch.completeFence.get( ) ) != vk::Result::eSuccess )
+        {
+            break;
+        }
 
-            allocationIter->SetBufferAllocation( allocationIter->vertexStartingOffset, vertexDataSize, indexDataSize );
-            oldCommandIter->firstIndex = ScaleToSecond<sizeof( IndexTy ), 1>( allocationIter->indexStartingOffset );
-            oldCommandIter->indexCount = ScaleToSecond<sizeof( IndexTy ), 1>( indexDataSize );
+        batch.overflowStagingBuffers.clear( );
+        m_FreeUploadBatches.push_back( std::move( batch ) );
+        m_InFlightUploadBatches.pop_front( );
+    }
 
-            return { allocation.targetChunk, *allocationIter };
-        }
+    // after the batches, fences of everything just retired are still signaled
+    m_UploadStagingRing.Retire( wait );
+}
+
+ClassName( void )::FlushUploads( )
+{
+    RetireUploadBatches( false );
+
+    auto& api    = VulkanAPI::GetInstance( );
+    auto& device = api.getLogicalDevice( );
+
+    {
+        std::lock_guard<std::mutex> lock( m_UploadLock );
+        if ( m_PendingUploads.empty( ) ) return;
+    }
+
+    UploadBatch batch = GetUploadBatch( );
+
+    std::vector<PendingUpload> uploads;
+    {
+        std::lock_guard<std::mutex> lock( m_UploadLock );
 
-        uint32_t nextBufferStarts = MaxMemoryAllocation;
-        if ( allocationIter + 1 != allocation.targetChunk->m_DataSlots.end( ) )
+        uploads.swap( m_PendingUploads );
+        batch.overflowStagingBuffers = std::move( m_PendingOverflowStagingBuffers );
+        m_PendingOverflowStagingBuffers.clear( );
+
+        // every staging write so far is in this batch
+        m_UploadStagingRing.Release( batch.completeFence.get( ) );
+    }
+
+    /*
+     *
+     * Record copies, one call per staging and destination buffer pair
+     *
+     * */
+    std::sort( uploads.begin( ), uploads.end( ), []( const PendingUpload& a, const PendingUpload& b ) {
+        return std::make_pair( (VkBuffer) a.targetChunk->buffer, (VkBuffer) a.stagingBuffer ) < std::make_pair( (VkBuffer) b.targetChunk->buffer, (VkBuffer) b.stagingBuffer );
+    } );
+
+    const auto& transferCommandBuffer = batch.transferCommandBuffer.get( );
+    transferCommandBuffer.begin( { vk::CommandBufferUsageFlagBits::eOneTimeSubmit } );
+
+    std::vector<vk::BufferCopy> copyRegions;
+    for ( size_t i = 0; i < uploads.size( ); ++i )
+    {
+        copyRegions.push_back( uploads[ i ].region );
+
+        const bool lastOfPair = i + 1 == uploads.size( ) || uploads[ i + 1 ].targetChunk->buffer != uploads[ i ].targetChunk->buffer || uploads[ i + 1 ].stagingBuffer != uploads[ i ].stagingBuffer;
+        if ( lastOfPair )
         {
-            nextBufferStarts = ( allocationIter + 1 )->GetStartingPoint( );
+            transferCommandBuffer.copyBuffer( uploads[ i ].stagingBuffer, uploads[ i ].targetChunk->buffer, copyRegions );
+            copyRegions.clear( );
         }
+    }
+
+    /*
+     *
+     * Queue family ownership transfer, release on transfer queue and acquire on graphics queue
+     * Same family only need the copies to be visible to vertex input
+     *
+     * */
+    const auto graphicFamilyIndex = api.getGraphicFamilyIndex( );
+
+    std::vector<vk::BufferMemoryBarrier> ownershipBarriers;
+    if ( m_UploadFamilyIndex != graphicFamilyIndex )
+    {
+        for ( const auto& upload : uploads )
+            ownershipBarriers.emplace_back( vk::AccessFlagBits::eTransferWrite, vk::AccessFlags { }, m_UploadFamilyIndex, graphicFamilyIndex, upload.targetChunk->buffer, upload.region.dstOffset, upload.region.size );
+
+        transferCommandBuffer.pipelineBarrier( vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe, { }, nullptr, ownershipBarriers, nullptr );
+    }
+
+    transferCommandBuffer.end( );
+
+    const auto& acquireCommandBuffer = batch.acquireCommandBuffer.get( );
+    acquireCommandBuffer.begin( { vk::CommandBufferUsageFlagBits::eOneTimeSubmit } );
+
+    if ( !ownershipBarriers.empty( ) )
+    {
+        for ( auto& barrier : ownershipBarriers )
+            barrier.setSrcAccessMask( { } ).setDstAccessMask( vk::AccessFlagBits::eVertexAttributeRead );
+
+        acquireCommandBuffer.pipelineBarrier( vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eVertexInput, { }, nullptr, ownershipBarriers, nullptr );
+    } else
+    {
+        const vk::MemoryBarrier visibleBarrier { { }, vk::AccessFlagBits::eVertexAttributeRead };
+        acquireCommandBuffer.pipelineBarrier( vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eVertexInput, { }, visibleBarrier, nullptr, nullptr );
+    }
+
+    acquireCommandBuffer.end( );
+
+    /*
+     *
+     * Submit, graphics queue waits for the transfer and orders every later frame after the acquire
+     *
+     * */
+    {
+        // this will lock the transfer queue
+        const auto& transferFamilyIndicesResources = api.GetTransferFamilyIndices( );
+        auto        transferQueue                  = device.getQueue( transferFamilyIndicesResources.resources.first, transferFamilyIndicesResources.resources.second );
+
+        vk::SubmitInfo submitInfo;
+        submitInfo.setCommandBuffers( transferCommandBuffer );
+        submitInfo.setSignalSemaphores( batch.transferCompleteSemaphore.get( ) );
+        transferQueue.submit( submitInfo, nullptr );
+    }
+
+    const vk::PipelineStageFlags acquireWaitStage = vk::PipelineStageFlagBits::eAllCommands;
+
+    vk::SubmitInfo acquireSubmitInfo;
+    acquireSubmitInfo.setWaitSemaphores( batch.transferCompleteSemaphore.get( ) );
+    acquireSubmitInfo.setWaitDstStageMask( acquireWaitStage );
+    acquireSubmitInfo.setCommandBuffers( acquireCommandBuffer );
+    api.getGraphicQueue( ).submit( acquireSubmitInfo, batch.completeFence.get( ) );
+
+    m_InFlightUploadBatches.push_back( std::move( batch ) );
+
+    /*
+     *
+     * Start drawing the uploaded meshes, and stop drawing what they replaced
+     *
+     * */
+    std::vector<SuitableAllocation> replacedAllocations;
+    for ( const auto& upload : uploads )
+    {
+        const SingleBufferRegion uploadedRegion { (uint32_t) upload.region.dstOffset, (uint32_t) upload.region.size };
 
-        if ( nextBufferStarts - allocationIter->GetStartingPoint( ) >= newRequitedSize )
         {
-            // there's enough space for expanding this allocation
+            std::lock_guard<std::mutex> indirectLock( upload.targetChunk->indirectDrawBuffersMutex );
 
-            allocationIter->SetBufferAllocation( allocationIter->vertexStartingOffset, vertexDataSize, indexDataSize );
-            oldCommandIter->firstIndex = ScaleToSecond<sizeof( IndexTy ), 1>( allocationIter->indexStartingOffset );
-            oldCommandIter->indexCount = ScaleToSecond<sizeof( IndexTy ), 1>( indexDataSize );
+            auto* command = upload.targetChunk->ModifyCommand( (int32_t) uploadedRegion.GetFirstVertex( ) );
 
-            return { allocation.targetChunk, *allocationIter };
+            // deleted before its upload was flushed
+            if ( command == nullptr ) continue;
+
+            command->indexCount = uploadedRegion.GetIndexCount( );
         }
 
-        Logger::getInstance( ).LogLine( Logger::LogType::eInfo, "Relocating buffer allocation" );
+        std::lock_guard<std::mutex> lock( m_UploadLock );
 
-        // else delete this allocation and find new allocation
-        allocation.targetChunk->m_DataSlots.erase( allocationIter );
-        allocation.targetChunk->indirectCommands.erase( oldCommandIter );
+        auto replacedIter = std::find_if( m_ReplacedAllocations.begin( ), m_ReplacedAllocations.end( ), [ & ]( const auto& replaced ) { return replaced.first.targetChunk == upload.targetChunk && replaced.first.region.vertexStartingOffset == uploadedRegion.vertexStartingOffset; } );
+        if ( replacedIter != m_ReplacedAllocations.end( ) )
+        {
+            replacedAllocations.push_back( replacedIter->second );
+            m_ReplacedAllocations.erase( replacedIter );
+        }
     }
 
-#else
+    for ( const auto& allocation : replacedAllocations )
+        DelayedDeleteBuffer( allocation );
+}
 
-    DelayedDeleteBuffer( allocation );
+ClassName( void )::DeleteBuffer( const ChunkRenderBuffers::SuitableAllocation& allocation )
+{
 
-#endif
+    std::lock_guard<std::recursive_mutex> bufferLock( buffersMutex );
+    Logger::getInstance( ).LogLine( Logger::LogType::eInfo, "Deleting buffer", allocation );
 
-    return CreateBuffer( vertexDataSize, indexDataSize );
+    assert( allocation.targetChunk->m_Allocator.GetAllocationSize( allocation.region.vertexStartingOffset ) >= allocation.region.vertexSize );
+    allocation.targetChunk->m_Allocator.Free( allocation.region.vertexStartingOffset );
 }
 
-ClassName( void )::GrowCapacity( )
+ClassName( void )::DelayedDeleteBuffer( const ChunkRenderBuffers::SuitableAllocation& allocation )
 {
-    using Usage = vk::BufferUsageFlagBits;
+    {
+        std::lock_guard<std::recursive_mutex> bufferLock( buffersMutex );
+        allocation.targetChunk->allocationOwners.erase( allocation.region.vertexStartingOffset );
+    }
 
-    auto& newBuffer = m_Buffers.emplace_back( );
+    // deleted before its upload was flushed, the allocation it was replacing goes too
+    std::optional<SuitableAllocation> replacedAllocation;
+    {
+        std::lock_guard<std::mutex> lock( m_UploadLock );
 
-    vk::BufferCreateInfo    bufferInfo { { }, MaxMemoryAllocation, Usage::eVertexBuffer | Usage::eIndexBuffer | Usage::eTransferDst, vk::SharingMode::eExclusive };
-    VmaAllocationCreateInfo allocInfo = { };
-    allocInfo.usage                   = VMA_MEMORY_USAGE_GPU_ONLY;
-    allocInfo.flags                   = VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+        auto replacedIter = std::find_if( m_ReplacedAllocations.begin( ), m_ReplacedAllocations.end( ), [ & ]( const auto& replaced ) { return replaced.first.targetChunk == allocation.targetChunk && replaced.first.region.vertexStartingOffset == allocation.region.vertexStartingOffset; } );
+        if ( replacedIter != m_ReplacedAllocations.end( ) )
+        {
+            replacedAllocation = replacedIter->second;
+            m_ReplacedAllocations.erase( replacedIter );
+        }
+    }
 
-    vmaCreateBuffer( allocator, reinterpret_cast<const VkBufferCreateInfo*>( &bufferInfo ), &allocInfo, reinterpret_cast<VkBuffer*>( &newBuffer.buffer ), &newBuffer.bufferAllocation, nullptr );
+    {
+        std::lock_guard<std::mutex> lock( m_PendingErasesLock );
+        std::lock_guard<std::mutex> indirectLock( allocation.targetChunk->indirectDrawBuffersMutex );
+
+        allocation.targetChunk->RemoveCommand( (int32_t) allocation.region.GetFirstVertex( ) );
+
+        m_PendingErases.emplace_back( allocation, (int) VulkanAPI::GetInstance( ).getSwapChainImagesCount( ) );
+    }
+
+    if ( replacedAllocation ) DelayedDeleteBuffer( *replacedAllocation );
 }
 
-ClassName( )::~ChunkRenderBuffers( )
+ClassName( typename ChunkRenderBuffers<VertexTy, IndexTy>::BufferChunk* )::PickEvacuatingChunk( )
 {
-    Clean( );
+    if ( m_Buffers.size( ) < 2 ) return nullptr;
+
+    BufferChunk* leastUsedChunk = nullptr;
+    uint64_t     totalFreeSize  = 0;
+    for ( auto& bufferChunk : m_Buffers )
+    {
+        totalFreeSize += bufferChunk.m_Allocator.GetCapacity( ) - bufferChunk.m_Allocator.GetUsedSize( );
+        if ( leastUsedChunk == nullptr || bufferChunk.m_Allocator.GetUsedSize( ) < leastUsedChunk->m_Allocator.GetUsedSize( ) )
+            leastUsedChunk = &bufferChunk;
+    }
+
+    // what it holds has to fit in the others with room to spare, or the next meshes would grow a new chunk right away
+    const uint64_t usedSize = leastUsedChunk->m_Allocator.GetUsedSize( );
+    const uint64_t freeSize = leastUsedChunk->m_Allocator.GetCapacity( ) - usedSize;
+    if ( totalFreeSize - freeSize < usedSize + ChunkCompactionHeadroom ) return nullptr;
+
+    return leastUsedChunk;
 }
 
-ClassName( void )::CopyBuffer( ChunkRenderBuffers::SuitableAllocation allocation, void* vertexBuffer, void* indexBuffer )
+ClassName( void )::Compact( uint32_t byteBudget )
 {
-    using Usage = vk::BufferUsageFlagBits;
+    std::lock_guard<std::mutex> ownerLock( m_AllocationOwnerLock );
 
-    BufferMeta stagingBuffer;
-    stagingBuffer.SetAllocator( );
+    std::vector<SuitableAllocation>                    movedAllocations;
+    std::vector<std::pair<vk::Buffer, vk::BufferCopy>> copyRegions;   // destination buffer, region
+    vk::Buffer                                         sourceBuffer;
+
+    {
+        std::lock_guard<std::recursive_mutex> bufferLock( buffersMutex );
+
+        // last region freed, every frame drawing from it is done
+        if ( m_EvacuatingChunk != nullptr && m_EvacuatingChunk->m_Allocator.Empty( ) )
+        {
+            std::erase( m_FrameBuffers, m_EvacuatingChunk );
+            m_Buffers.remove_if( [ this ]( const BufferChunk& bufferChunk ) { return &bufferChunk == m_EvacuatingChunk; } );
+            m_EvacuatingChunk = nullptr;
+            ++m_CompactionStatistics.buffersReleased;
+
+            Logger::getInstance( ).LogLine( Logger::LogType::eInfo, "Released chunk buffer,", m_Buffers.size( ), "left" );
+        }
+
+        if ( m_EvacuatingChunk == nullptr ) m_EvacuatingChunk = PickEvacuatingChunk( );
+        if ( m_EvacuatingChunk == nullptr ) return;
+
+        sourceBuffer = m_EvacuatingChunk->buffer;
+
+        // allocations with a copy not yet submitted stay, they are moved in a later frame
+        std::vector<uint32_t> pendingOffsets;
+        {
+            std::lock_guard<std::mutex> lock( m_UploadLock );
+            for ( const auto& upload : m_PendingUploads )
+                if ( upload.targetChunk == m_EvacuatingChunk ) pendingOffsets.push_back( (uint32_t) upload.region.dstOffset );
+        }
+
+        uint32_t budgetUsed = 0;
+
+        const std::vector<std::pair<uint32_t, SuitableAllocation*>> owners( m_EvacuatingChunk->allocationOwners.begin( ), m_EvacuatingChunk->allocationOwners.end( ) );
+        for ( const auto& [ offset, owner ] : owners )
+        {
+            if ( std::find( pendingOffsets.begin( ), pendingOffsets.end( ), offset ) != pendingOffsets.end( ) ) continue;
+
+            const SuitableAllocation oldAllocation = *owner;
+            assert( oldAllocation.targetChunk == m_EvacuatingChunk && oldAllocation.region.vertexStartingOffset == offset );
+
+            if ( budgetUsed > 0 && budgetUsed + oldAllocation.region.vertexSize > byteBudget ) break;
+
+            const auto   requitedSize = std::max<uint32_t>( oldAllocation.region.vertexSize, sizeof( VertexTy ) );
+            BufferChunk* targetChunk  = nullptr;
+            uint32_t     newOffset    = TLSFAllocator::InvalidOffset;
+            for ( auto& bufferChunk : m_Buffers )
+            {
+                if ( &bufferChunk == m_EvacuatingChunk ) continue;
+
+                newOffset = bufferChunk.m_Allocator.Allocate( requitedSize );
+                if ( newOffset != TLSFAllocator::InvalidOffset )
+                {
+                    targetChunk = &bufferChunk;
+                    break;
+                }
+            }
+
+            // filled up since it was picked, try another one later
+            if ( targetChunk == nullptr )
+            {
+                m_EvacuatingChunk = nullptr;
+                break;
+            }
+
+            const SuitableAllocation newAllocation { targetChunk, { newOffset, oldAllocation.region.vertexSize } };
+
+            /*
+             *
+             * Move the command, copy is submitted before this frame and ordered by barriers
+             *
+             * */
+            vk::DrawIndexedIndirectCommand movedCommand;
+            ChunkOriginTy                  movedOrigin;
+            {
+                std::lock_guard<std::mutex> indirectLock( m_EvacuatingChunk->indirectDrawBuffersMutex );
+                m_EvacuatingChunk->RemoveCommand( (int32_t) oldAllocation.region.GetFirstVertex( ), &movedCommand, &movedOrigin );
+            }
+
+            {
+                std::lock_guard<std::mutex> indirectLock( targetChunk->indirectDrawBuffersMutex );
+
+                movedCommand.vertexOffset = (int32_t) newAllocation.region.GetFirstVertex( );
+                targetChunk->AddCommand( movedCommand, movedOrigin );
+            }
+
+            if ( oldAllocation.region.vertexSize > 0 )
+                copyRegions.emplace_back( targetChunk->buffer, vk::BufferCopy { oldAllocation.region.vertexStartingOffset, newOffset, oldAllocation.region.vertexSize } );
+
+            m_EvacuatingChunk->allocationOwners.erase( offset );
+            targetChunk->allocationOwners[ newOffset ] = owner;
+            *owner                                     = newAllocation;
 
-    const vk::DeviceSize stagingSize = allocation.region.GetTotalSize( );
-    stagingBuffer.Create( stagingSize, Usage::eVertexBuffer | Usage::eIndexBuffer | Usage::eTransferSrc );
-    stagingBuffer.writeBuffer( vertexBuffer, allocation.region.vertexSize );
-    stagingBuffer.writeBufferOffseted( indexBuffer, allocation.region.indexSize, allocation.region.GetOffsetDiff( ) );
+            movedAllocations.push_back( oldAllocation );
+            budgetUsed += oldAllocation.region.vertexSize;
 
-    // this will lock the transfer queue
-    const auto& transferFamilyIndicesResources = VulkanAPI::GetInstance( ).GetTransferFamilyIndices( );
-    auto        transferQueue                  = VulkanAPI::GetInstance( ).getLogicalDevice( ).getQueue( transferFamilyIndicesResources.resources.first, transferFamilyIndicesResources.resources.second );
+            m_CompactionStatistics.bytesMoved += oldAllocation.region.vertexSize;
+            ++m_CompactionStatistics.regionsMoved;
+        }
+    }
+
+    if ( movedAllocations.empty( ) ) return;
 
-    vk::CommandBufferAllocateInfo allocInfo { };
-    allocInfo.setCommandPool( *VulkanAPI::GetInstance( ).GetTransferCommandPool( ) );
-    allocInfo.setLevel( vk::CommandBufferLevel::ePrimary );
-    allocInfo.setCommandBufferCount( 1 );
+    // frames in flight may still draw the old regions
+    {
+        std::lock_guard<std::mutex> lock( m_PendingErasesLock );
+        for ( const auto& allocation : movedAllocations )
+            m_PendingErases.emplace_back( allocation, (int) VulkanAPI::GetInstance( ).getSwapChainImagesCount( ) );
+    }
 
-    auto  commandBuffers = VulkanAPI::GetInstance( ).getLogicalDevice( ).allocateCommandBuffersUnique( allocInfo );
-    auto& commandBuffer  = commandBuffers.begin( )->get( );
+    if ( copyRegions.empty( ) ) return;
 
+    /*
+     *
+     * Record copies on the graphics queue, the uploads of the moved regions were acquired there already
+     *
+     * */
+    auto& api   = VulkanAPI::GetInstance( );
+    auto  batch = GetUploadBatch( );
+
+    std::sort( copyRegions.begin( ), copyRegions.end( ), []( const auto& a, const auto& b ) { return (VkBuffer) a.first < (VkBuffer) b.first; } );
+
+    const auto& commandBuffer = batch.acquireCommandBuffer.get( );
     commandBuffer.begin( { vk::CommandBufferUsageFlagBits::eOneTimeSubmit } );
 
-    vk::BufferCopy bufferRegion;
-    bufferRegion.setSize( stagingSize ).setDstOffset( allocation.region.vertexStartingOffset );
-    commandBuffer.copyBuffer( stagingBuffer.GetBuffer( ), allocation.targetChunk->buffer, bufferRegion );
+    const vk::MemoryBarrier beforeCopyBarrier { vk::AccessFlagBits::eMemoryWrite, vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eTransferWrite };
+    commandBuffer.pipelineBarrier( vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer, { }, beforeCopyBarrier, nullptr, nullptr );
+
+    std::vector<vk::BufferCopy> bufferCopies;
+    for ( size_t i = 0; i < copyRegions.size( ); ++i )
+    {
+        bufferCopies.push_back( copyRegions[ i ].second );
+
+        if ( i + 1 == copyRegions.size( ) || copyRegions[ i + 1 ].first != copyRegions[ i ].first )
+        {
+            commandBuffer.copyBuffer( sourceBuffer, copyRegions[ i ].first, bufferCopies );
+            bufferCopies.clear( );
+        }
+    }
+
+    const vk::MemoryBarrier afterCopyBarrier { vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eVertexAttributeRead };
+    commandBuffer.pipelineBarrier( vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eVertexInput, { }, afterCopyBarrier, nullptr, nullptr );
 
     commandBuffer.end( );
 
     vk::SubmitInfo submitInfo;
     submitInfo.setCommandBuffers( commandBuffer );
-    transferQueue.submit( submitInfo, nullptr );
-    transferQueue.waitIdle( );
+    api.getGraphicQueue( ).submit( submitInfo, batch.completeFence.get( ) );
+
+    m_InFlightUploadBatches.push_back( std::move( batch ) );
 }
 
-ClassName( void )::DeleteBuffer( const ChunkRenderBuffers::SuitableAllocation& allocation )
+ClassName( void )::BufferChunk::AddCommand( vk::DrawIndexedIndirectCommand command, const ChunkOriginTy& origin )
 {
+    const auto slot       = (uint32_t) indirectCommands.size( );
+    command.firstInstance = slot;
 
-    std::lock_guard<std::recursive_mutex> bufferLock( buffersMutex );
-    Logger::getInstance( ).LogLine( Logger::LogType::eInfo, "Deleting buffer", allocation );
+    indirectCommands.push_back( command );
+    drawOrigins.push_back( origin );
+    commandSlots[ command.vertexOffset ] = slot;
+    dirtySlots.push_back( slot );
+}
+
+ClassName( void )::BufferChunk::RemoveCommand( int32_t vertexOffset, vk::DrawIndexedIndirectCommand* removedCommand, ChunkOriginTy* removedOrigin )
+{
+    const auto slotIter = commandSlots.find( vertexOffset );
+    assert( slotIter != commandSlots.end( ) );
+
+    const auto slot = slotIter->second;
+    commandSlots.erase( slotIter );
 
-    auto allocationIter = std::find( allocation.targetChunk->m_DataSlots.begin( ), allocation.targetChunk->m_DataSlots.end( ), allocation.region );
-    assert( allocationIter != allocation.targetChunk->m_DataSlots.end( ) );
+    if ( removedCommand != nullptr ) *removedCommand = indirectCommands[ slot ];
+    if ( removedOrigin != nullptr ) *removedOrigin = drawOrigins[ slot ];
 
-    allocation.targetChunk->m_DataSlots.erase( allocationIter );
+    // last command fills the hole, the slot past the end is simply not drawn
+    if ( const auto lastSlot = (uint32_t) indirectCommands.size( ) - 1; slot != lastSlot )
+    {
+        indirectCommands[ slot ]               = indirectCommands[ lastSlot ];
+        indirectCommands[ slot ].firstInstance = slot;
+        drawOrigins[ slot ]                    = drawOrigins[ lastSlot ];
+
+        commandSlots[ indirectCommands[ slot ].vertexOffset ] = slot;
+        dirtySlots.push_back( slot );
+    }
+
+    indirectCommands.pop_back( );
+    drawOrigins.pop_back( );
 }
 
-ClassName( void )::DelayedDeleteBuffer( const ChunkRenderBuffers::SuitableAllocation& allocation )
+ClassName( vk::DrawIndexedIndirectCommand* )::BufferChunk::ModifyCommand( int32_t vertexOffset )
 {
-    std::lock_guard<std::mutex> lock( m_PendingErasesLock );
-    std::lock_guard<std::mutex> indirectLock( allocation.targetChunk->indirectDrawBuffersMutex );
+    const auto slotIter = commandSlots.find( vertexOffset );
+    if ( slotIter == commandSlots.end( ) ) return nullptr;
 
-    auto oldCommandIter = std::find_if( allocation.targetChunk->indirectCommands.begin( ), allocation.targetChunk->indirectCommands.end( ), [ originalFirstIndex = ScaleToSecond<sizeof( IndexTy ), 1>( allocation.region.indexStartingOffset ) ]( const vk::DrawIndexedIndirectCommand& command ) { return command.firstIndex == originalFirstIndex; } );
-    assert( oldCommandIter != allocation.targetChunk->indirectCommands.end( ) );
-    allocation.targetChunk->indirectCommands.erase( oldCommandIter );
-    allocation.targetChunk->shouldUpdateIndirectDrawBuffers = true;
-
-    m_PendingErases.emplace_back( allocation, (int) VulkanAPI::GetInstance( ).getSwapChainImagesCount( ) );
+    dirtySlots.push_back( slotIter->second );
+    return &indirectCommands[ slotIter->second ];
 }
 
-ClassName( void )::BufferChunk::UpdateIndirectDrawBuffers( )
+ClassName( void )::BufferChunk::UpdateIndirectDrawBuffers( StagingRing& frameRing, std::vector<DrawBufferCopy>& copies )
 {
-    if ( !shouldUpdateIndirectDrawBuffers ) return;
-    shouldUpdateIndirectDrawBuffers = false;
+    using Usage = vk::BufferUsageFlagBits;
 
     std::lock_guard<std::mutex> lock( indirectDrawBuffersMutex );
-    const auto                  newIndirectDrawBufferSize = (uint32_t) ( indirectCommands.size( ) * sizeof( indirectCommands[ 0 ] ) );
-    if ( indirectDrawBufferSize < newIndirectDrawBufferSize )
+
+    // called once per frame
+    for ( size_t i = 0; i < retiredDrawBuffers.size( ); ++i )
+        if ( --retiredDrawBuffers[ i ].second <= 0 ) retiredDrawBuffers.erase( retiredDrawBuffers.begin( ) + i-- );
+
+    frameDrawCount = (uint32_t) indirectCommands.size( );
+    if ( frameDrawCount == 0 )
     {
-        indirectDrawBufferSize = newIndirectDrawBufferSize + ( IndirectDrawBufferSizeStep - ( newIndirectDrawBufferSize % IndirectDrawBufferSizeStep ) );
+        uploadedDrawCount = 0;
+        dirtySlots.clear( );
+        return;
+    }
+
+    if ( drawBufferCapacity < frameDrawCount )
+    {
+        const auto framesInFlight = (int) VulkanAPI::GetInstance( ).getSwapChainImagesCount( );
+        if ( indirectCommandBuffer ) retiredDrawBuffers.emplace_back( std::move( indirectCommandBuffer ), framesInFlight );
+        if ( drawOriginBuffer ) retiredDrawBuffers.emplace_back( std::move( drawOriginBuffer ), framesInFlight );
+        if ( culledCommandBuffer ) retiredDrawBuffers.emplace_back( std::move( culledCommandBuffer ), framesInFlight );
+        if ( drawCountBuffer ) retiredDrawBuffers.emplace_back( std::move( drawCountBuffer ), framesInFlight );
+
+        drawBufferCapacity = std::max<uint32_t>( std::bit_ceil( frameDrawCount ), 64 );
+
+        indirectCommandBuffer = std::make_unique<BufferMeta>( );
+        indirectCommandBuffer->SetAllocator( );
+        indirectCommandBuffer->Create( drawBufferCapacity * sizeof( vk::DrawIndexedIndirectCommand ), Usage::eIndirectBuffer | Usage::eStorageBuffer | Usage::eTransferDst, VMA_MEMORY_USAGE_GPU_ONLY );
 
-        indirectDrawBuffers.Create( indirectDrawBufferSize, vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst, VMA_MEMORY_USAGE_GPU_ONLY );
-        Logger::getInstance( ).LogLine( "Creating indirectDrawBuffer [", indirectDrawBuffers, "] with size:", indirectDrawBufferSize );
+        drawOriginBuffer = std::make_unique<BufferMeta>( );
+        drawOriginBuffer->SetAllocator( );
+        drawOriginBuffer->Create( drawBufferCapacity * sizeof( ChunkOriginTy ), Usage::eVertexBuffer | Usage::eStorageBuffer | Usage::eTransferDst, VMA_MEMORY_USAGE_GPU_ONLY );
 
-        // Logger::getInstance( ).LogLine( "Creating indirectDrawStagingBuffer with size:", indirectDrawBufferSize );
-        stagingBuffer.Create( indirectDrawBufferSize, vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferSrc, VMA_MEMORY_USAGE_CPU_ONLY );
+        if ( VulkanAPI::GetInstance( ).isDrawIndirectCountSupported( ) )
+        {
+            culledCommandBuffer = std::make_unique<BufferMeta>( );
+            culledCommandBuffer->SetAllocator( );
+            culledCommandBuffer->Create( drawBufferCapacity * sizeof( vk::DrawIndexedIndirectCommand ), Usage::eIndirectBuffer | Usage::eStorageBuffer, VMA_MEMORY_USAGE_GPU_ONLY );
+
+            drawCountBuffer = std::make_unique<BufferMeta>( );
+            drawCountBuffer->SetAllocator( );
+            drawCountBuffer->Create( sizeof( uint32_t ), Usage::eIndirectBuffer | Usage::eStorageBuffer | Usage::eTransferDst | Usage::eTransferSrc, VMA_MEMORY_USAGE_GPU_ONLY );
+        }
+
+        // new buffers start empty
+        uploadedDrawCount = 0;
+        dirtySlots.resize( frameDrawCount );
+        std::iota( dirtySlots.begin( ), dirtySlots.end( ), 0 );
     }
 
-    vk::BufferCopy bufferRegion;
-    bufferRegion.setSize( newIndirectDrawBufferSize );
-    stagingBuffer.writeBuffer( indirectCommands.data( ), newIndirectDrawBufferSize );
-    indirectDrawBuffers.CopyFromBuffer( stagingBuffer, bufferRegion, VulkanAPI::GetInstance( ) );
+    if ( dirtySlots.empty( ) )
+    {
+        uploadedDrawCount = frameDrawCount;
+        return;
+    }
+
+    std::sort( dirtySlots.begin( ), dirtySlots.end( ) );
+    dirtySlots.erase( std::unique( dirtySlots.begin( ), dirtySlots.end( ) ), dirtySlots.end( ) );
+
+    // removed since they were marked
+    dirtySlots.erase( std::lower_bound( dirtySlots.begin( ), dirtySlots.end( ), frameDrawCount ), dirtySlots.end( ) );
+
+    const auto copiesBegin = copies.size( );
+    for ( size_t i = 0; i < dirtySlots.size( ); )
+    {
+        // one copy per run of consecutive slots
+        size_t runEnd = i + 1;
+        while ( runEnd < dirtySlots.size( ) && dirtySlots[ runEnd ] == dirtySlots[ runEnd - 1 ] + 1 )
+            ++runEnd;
+
+        const uint32_t firstSlot = dirtySlots[ i ], slotCount = uint32_t( runEnd - i );
+        i                        = runEnd;
+
+        const vk::DeviceSize commandsSize = slotCount * sizeof( vk::DrawIndexedIndirectCommand ), originsSize = slotCount * sizeof( ChunkOriginTy );
+
+        const auto stagedCommands = frameRing.Write( &indirectCommands[ firstSlot ], commandsSize );
+        const auto stagedOrigins  = frameRing.Write( &drawOrigins[ firstSlot ], originsSize );
+        if ( !stagedCommands || !stagedOrigins )
+        {
+            // Slots stay dirty for the next frame, the device table is left as last uploaded and still drawn
+            copies.resize( copiesBegin );
+            frameDrawCount = uploadedDrawCount;
+
+            Logger::getInstance( ).LogLine( Logger::LogType::eWarn, "Frame staging ring is full, deferring", dirtySlots.size( ), "draw updates" );
+            return;
+        }
+
+        copies.push_back( { stagedCommands.buffer, indirectCommandBuffer->GetBuffer( ), { stagedCommands.offset, firstSlot * sizeof( vk::DrawIndexedIndirectCommand ), commandsSize } } );
+        copies.push_back( { stagedOrigins.buffer, drawOriginBuffer->GetBuffer( ), { stagedOrigins.offset, firstSlot * sizeof( ChunkOriginTy ), originsSize } } );
+    }
+
+    uploadedDrawCount = frameDrawCount;
+    dirtySlots.clear( );
+}
+
+ClassName( void )::UpdateAllIndirectDrawBuffers( StagingRing& frameRing, const vk::CommandBuffer& commandBuffer )
+{
+    {
+        std::lock_guard<std::recursive_mutex> bufferLock( buffersMutex );
+
+        m_FrameBuffers.clear( );
+        for ( auto& chunk : m_Buffers )
+            m_FrameBuffers.push_back( &chunk );
+    }
+
+    // chunks are only released on this thread, the snapshot stays valid without the lock
+    std::vector<typename BufferChunk::DrawBufferCopy> copies;
+    for ( auto* chunk : m_FrameBuffers )
+        chunk->UpdateIndirectDrawBuffers( frameRing, copies );
+
+    if ( copies.empty( ) ) return;
+
+    // previous frames may still read the slots being overwritten
+    commandBuffer.pipelineBarrier( vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexInput, vk::PipelineStageFlagBits::eTransfer, { }, nullptr, nullptr, nullptr );
+
+    for ( const auto& copy : copies )
+        commandBuffer.copyBuffer( copy.source, copy.destination, copy.region );
+
+    const vk::MemoryBarrier visibleBarrier { vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eVertexAttributeRead };
+    commandBuffer.pipelineBarrier( vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexInput, { }, visibleBarrier, nullptr, nullptr );
 }
 
 #endif   // MINECRAFT_VK_MINECRAFT_WORLD_CHUNK_CHUNKRENDERBUFFERS_IMPL_HPP
\ No newline at end of file
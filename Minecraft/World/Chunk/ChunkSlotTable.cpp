@@ -0,0 +1,48 @@
+#include "ChunkSlotTable.hpp"
+
+#include <cassert>
+#include <stdexcept>
+
+ChunkSlotTable::~ChunkSlotTable( )
+{
+    for ( auto& segment : m_Segments )
+        delete[] segment.load( std::memory_order_relaxed );
+}
+
+ChunkHandle
+ChunkSlotTable::Acquire( ChunkTy* chunk )
+{
+    uint32_t index;
+    if ( !m_FreeSlots.empty( ) )
+    {
+        index = m_FreeSlots.front( );
+        m_FreeSlots.pop_front( );
+    } else
+    {
+        if ( m_SlotCount > ChunkHandle::IndexMask ) throw std::runtime_error( "Chunk slot table is full" );
+
+        index         = m_SlotCount++;
+        auto& segment = m_Segments[ index >> SegmentBits ];
+        if ( segment.load( std::memory_order_relaxed ) == nullptr ) segment.store( new Slot[ SegmentSize ], std::memory_order_release );
+    }
+
+    auto& slot = GetSlot( index );
+    slot.chunk.store( chunk, std::memory_order_release );
+
+    ++m_UsedSlotCount;
+    return { index, slot.generation.load( std::memory_order_relaxed ) };
+}
+
+void
+ChunkSlotTable::Release( ChunkHandle handle )
+{
+    auto& slot = GetSlot( handle.GetIndex( ) );
+    assert( !handle.IsNull( ) && slot.generation.load( std::memory_order_relaxed ) == handle.GetGeneration( ) );
+
+    // skip generation 0, kept for null handles
+    slot.generation.store( handle.GetGeneration( ) % ChunkHandle::GenerationMask + 1, std::memory_order_relaxed );
+    slot.chunk.store( nullptr, std::memory_order_release );
+
+    m_FreeSlots.push_back( handle.GetIndex( ) );
+    --m_UsedSlotCount;
+}
@@ -0,0 +1,102 @@
+#ifndef MINECRAFT_VK_MINECRAFT_WORLD_CHUNK_CHUNKSLOTTABLE_HPP
+#define MINECRAFT_VK_MINECRAFT_WORLD_CHUNK_CHUNKSLOTTABLE_HPP
+
+#include "ChunkPoolType.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+
+/*
+ *
+ * 32-bit reference to a loaded chunk, the index of its slot and the generation of the slot when the chunk was added
+ * Resolves to nullptr once the chunk is unloaded, even after the slot is reused
+ *
+ * */
+class ChunkHandle
+{
+public:
+    static constexpr uint32_t IndexBits      = 20;
+    static constexpr uint32_t GenerationBits = 32 - IndexBits;
+    static constexpr uint32_t IndexMask      = ( 1U << IndexBits ) - 1;
+    static constexpr uint32_t GenerationMask = ( 1U << GenerationBits ) - 1;
+
+private:
+    uint32_t m_Value = 0;   // generation 0 is never used, default handle is null
+
+public:
+    constexpr ChunkHandle( ) = default;
+    constexpr ChunkHandle( uint32_t index, uint32_t generation )
+        : m_Value( generation << IndexBits | index )
+    { }
+
+    [[nodiscard]] constexpr uint32_t GetIndex( ) const { return m_Value & IndexMask; }
+    [[nodiscard]] constexpr uint32_t GetGeneration( ) const { return m_Value >> IndexBits; }
+    [[nodiscard]] constexpr bool     IsNull( ) const { return GetGeneration( ) == 0; }
+
+    constexpr bool operator==( const ChunkHandle& ) const = default;
+};
+
+/*
+ *
+ * Slots of every chunk in ChunkPool, resolving a ChunkHandle is an index and a generation check, no reference counting
+ *
+ * Slots live in segments that are never moved or freed before the table, so Resolve never races with growth
+ * Released slots bump their generation and are reused first in first out,
+ * a stale handle can only alias after its slot is reused GenerationMask times
+ *
+ * Acquire and Release must be serialized by the caller
+ * Resolve is safe from any thread, the chunk returned stays alive only while the caller is inside an EpochGuard
+ *
+ * */
+class ChunkSlotTable
+{
+    static constexpr uint32_t SegmentBits  = 12;
+    static constexpr uint32_t SegmentSize  = 1U << SegmentBits;
+    static constexpr uint32_t SegmentCount = 1U << ( ChunkHandle::IndexBits - SegmentBits );
+
+    struct Slot {
+        std::atomic<uint32_t> generation { 1 };
+        std::atomic<ChunkTy*> chunk { nullptr };
+    };
+
+    std::array<std::atomic<Slot*>, SegmentCount> m_Segments { };   // allocated on first use
+
+    std::deque<uint32_t> m_FreeSlots;
+    uint32_t             m_SlotCount     = 0;
+    uint32_t             m_UsedSlotCount = 0;
+
+    inline Slot& GetSlot( uint32_t index ) const
+    {
+        return m_Segments[ index >> SegmentBits ].load( std::memory_order_acquire )[ index & ( SegmentSize - 1 ) ];
+    }
+
+public:
+    ChunkSlotTable( ) = default;
+    ~ChunkSlotTable( );
+
+    ChunkSlotTable( const ChunkSlotTable& )            = delete;
+    ChunkSlotTable& operator=( const ChunkSlotTable& ) = delete;
+
+    ChunkHandle Acquire( ChunkTy* chunk );
+
+    // Every handle of the slot resolves to nullptr afterward, the chunk itself is not touched
+    void Release( ChunkHandle handle );
+
+    [[nodiscard]] inline ChunkTy* Resolve( ChunkHandle handle ) const
+    {
+        if ( handle.IsNull( ) ) return nullptr;
+
+        const auto& slot  = GetSlot( handle.GetIndex( ) );
+        auto*       chunk = slot.chunk.load( std::memory_order_acquire );
+
+        // a chunk stored after the generation changed is never returned for the old generation
+        return slot.generation.load( std::memory_order_relaxed ) == handle.GetGeneration( ) ? chunk : nullptr;
+    }
+
+    inline uint32_t GetUsedSlotCount( ) const { return m_UsedSlotCount; }
+    inline uint32_t GetSlotCount( ) const { return m_SlotCount; }
+};
+
+#endif   // MINECRAFT_VK_MINECRAFT_WORLD_CHUNK_CHUNKSLOTTABLE_HPP
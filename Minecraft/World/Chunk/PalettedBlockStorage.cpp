@@ -0,0 +1,129 @@
+#include "PalettedBlockStorage.hpp"
+#include "ChunkPayloadPool.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace
+{
+inline uint8_t
+GetBitsForPaletteSize( size_t paletteSize )
+{
+    uint8_t bits = 1;
+    while ( ( 1U << bits ) < paletteSize )
+        bits <<= 1;
+
+    return bits;
+}
+}   // namespace
+
+void
+PalettedBlockStorage::Repack( uint8_t bitsPerEntry )
+{
+    assert( bitsPerEntry > m_BitsPerEntry && bitsPerEntry <= 8 );
+
+    auto data = MakeSlabPoolArray<WordTy>( ChunkPayloadPool::GetSectionData( bitsPerEntry ), GetWordCount( bitsPerEntry ) );
+    if ( m_BitsPerEntry != 0 )
+    {
+        std::swap( data, m_Data );
+        const auto oldBitsPerEntry = m_BitsPerEntry;
+
+        m_BitsPerEntry = bitsPerEntry;
+        for ( uint32_t i = 0; i < SectionVolume; ++i )
+        {
+            const uint32_t bitIndex     = i * oldBitsPerEntry;
+            const uint32_t paletteIndex = static_cast<uint32_t>( data[ bitIndex >> WordBinaryShift ] >> ( bitIndex & ( WordBits - 1 ) ) ) & ( ( 1U << oldBitsPerEntry ) - 1 );
+            SetPaletteIndex( i, paletteIndex );
+        }
+    } else
+    {
+        // from uniform, every block is palette entry 0
+        m_Data         = std::move( data );
+        m_BitsPerEntry = bitsPerEntry;
+    }
+}
+
+void
+PalettedBlockStorage::Set( uint32_t index, const Block& block )
+{
+    assert( index < SectionVolume );
+
+    if ( m_BitsPerEntry == 0 )
+    {
+        if ( m_UniformBlock == block ) return;
+
+        m_Palette = { m_UniformBlock, block };
+        Repack( 1 );
+        SetPaletteIndex( index, 1 );
+        return;
+    }
+
+    auto paletteIt = std::find_if( m_Palette.begin( ), m_Palette.end( ), [ &block ]( const Block& entry ) { return entry == block; } );
+    if ( paletteIt == m_Palette.end( ) )
+    {
+        m_Palette.push_back( block );
+        if ( m_Palette.size( ) > ( 1U << m_BitsPerEntry ) ) Repack( m_BitsPerEntry << 1 );
+
+        paletteIt = m_Palette.end( ) - 1;
+    }
+
+    SetPaletteIndex( index, static_cast<uint32_t>( paletteIt - m_Palette.begin( ) ) );
+}
+
+void
+PalettedBlockStorage::Fill( const Block& block )
+{
+    m_UniformBlock = block;
+    m_BitsPerEntry = 0;
+    m_Palette.clear( );
+    m_Palette.shrink_to_fit( );
+    m_Data.reset( );
+}
+
+void
+PalettedBlockStorage::Load( const Block* blocks )
+{
+    static constexpr int16_t NotInPalette = -1;
+
+    std::array<int16_t, BlockIDSize> paletteIndices;
+    paletteIndices.fill( NotInPalette );
+
+    std::vector<Block> palette;
+    for ( uint32_t i = 0; i < SectionVolume; ++i )
+    {
+        auto& paletteIndex = paletteIndices[ static_cast<BlockID>( blocks[ i ] ) ];
+        if ( paletteIndex == NotInPalette )
+        {
+            paletteIndex = static_cast<int16_t>( palette.size( ) );
+            palette.push_back( blocks[ i ] );
+        }
+    }
+
+    Fill( palette.front( ) );
+    if ( palette.size( ) == 1 ) return;
+
+    m_Palette = std::move( palette );
+    Repack( GetBitsForPaletteSize( m_Palette.size( ) ) );
+
+    for ( uint32_t i = 0; i < SectionVolume; ++i )
+        SetPaletteIndex( i, paletteIndices[ static_cast<BlockID>( blocks[ i ] ) ] );
+}
+
+void
+PalettedBlockStorage::Store( Block* blocks ) const
+{
+    if ( m_BitsPerEntry == 0 )
+    {
+        std::fill_n( blocks, SectionVolume, m_UniformBlock );
+        return;
+    }
+
+    for ( uint32_t i = 0; i < SectionVolume; ++i )
+        blocks[ i ] = m_Palette[ GetPaletteIndex( i ) ];
+}
+
+size_t
+PalettedBlockStorage::GetAllocatedSize( ) const
+{
+    return m_Palette.capacity( ) * sizeof( Block ) + ( m_Data ? GetWordCount( m_BitsPerEntry ) * sizeof( WordTy ) : 0 );
+}
@@ -0,0 +1,87 @@
+#ifndef MINECRAFT_VK_MINECRAFT_WORLD_CHUNK_PALETTEDBLOCKSTORAGE_HPP
+#define MINECRAFT_VK_MINECRAFT_WORLD_CHUNK_PALETTEDBLOCKSTORAGE_HPP
+
+#include <Minecraft/Block/Block.hpp>
+#include <Minecraft/util/MinecraftConstants.hpp>
+
+#include <Utility/Memory/SlabPool.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/*
+ *
+ * Blocks of one 16x16x16 section
+ *
+ * Uniform section only keep a single block, no heap allocation
+ * Otherwise blocks are indices into a palette, bit-packed with 1, 2, 4 or 8 bits per block, from ChunkPayloadPool
+ *
+ * Palette only grows on Set, Load rebuild the smallest representation
+ * Same as raw block array, concurrent Set and Get must be serialized by the caller
+ *
+ * */
+class PalettedBlockStorage
+{
+    using WordTy = uint64_t;
+
+    static constexpr uint32_t WordBits        = sizeof( WordTy ) * 8;
+    static constexpr uint32_t WordBinaryShift = IntLog<(int) WordBits, 2>::value;
+
+    Block                 m_UniformBlock { };
+    uint8_t               m_BitsPerEntry = 0;   // 0 for uniform
+    std::vector<Block>    m_Palette;
+    SlabPoolArray<WordTy> m_Data;
+
+    [[nodiscard]] static constexpr uint32_t GetWordCount( uint8_t bitsPerEntry ) { return SectionVolume * bitsPerEntry / WordBits; }
+
+    [[nodiscard]] inline uint32_t GetPaletteIndex( uint32_t index ) const
+    {
+        const uint32_t bitIndex = index * m_BitsPerEntry;
+        return static_cast<uint32_t>( m_Data[ bitIndex >> WordBinaryShift ] >> ( bitIndex & ( WordBits - 1 ) ) ) & ( ( 1U << m_BitsPerEntry ) - 1 );
+    }
+
+    inline void SetPaletteIndex( uint32_t index, uint32_t paletteIndex )
+    {
+        const uint32_t bitIndex = index * m_BitsPerEntry;
+        const uint32_t shift    = bitIndex & ( WordBits - 1 );
+        auto&          word     = m_Data[ bitIndex >> WordBinaryShift ];
+
+        word = ( word & ~( static_cast<WordTy>( ( 1U << m_BitsPerEntry ) - 1 ) << shift ) ) | ( static_cast<WordTy>( paletteIndex ) << shift );
+    }
+
+    void Repack( uint8_t bitsPerEntry );
+
+public:
+    PalettedBlockStorage( ) = default;
+
+    [[nodiscard]] inline Block Get( uint32_t index ) const
+    {
+        assert( index < SectionVolume );
+
+        if ( m_BitsPerEntry == 0 ) [[likely]]
+            return m_UniformBlock;
+
+        return m_Palette[ GetPaletteIndex( index ) ];
+    }
+
+    void Set( uint32_t index, const Block& block );
+
+    // Whole section to single block
+    void Fill( const Block& block );
+
+    // From / to SectionVolume blocks, in the same order as chunk block index
+    void Load( const Block* blocks );
+    void Store( Block* blocks ) const;
+
+    [[nodiscard]] inline bool         IsUniform( ) const { return m_BitsPerEntry == 0; }
+    [[nodiscard]] inline const Block& GetUniformBlock( ) const { return m_UniformBlock; }
+    [[nodiscard]] inline uint8_t      GetBitsPerEntry( ) const { return m_BitsPerEntry; }
+
+    // Heap memory in used, excluding sizeof( PalettedBlockStorage )
+    [[nodiscard]] size_t GetAllocatedSize( ) const;
+};
+
+
+#endif   // MINECRAFT_VK_MINECRAFT_WORLD_CHUNK_PALETTEDBLOCKSTORAGE_HPP
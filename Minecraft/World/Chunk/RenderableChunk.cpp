@@ -3,6 +3,7 @@
 //
 
 #include <Minecraft/Application/MainApplication.hpp>
+#include <Minecraft/World/MinecraftWorld.hpp>
 #include <Minecraft/util/MinecraftConstants.hpp>
 
 #include <Graphic/Vulkan/VulkanAPI.hpp>
@@ -25,36 +26,50 @@ constexpr auto dirFrontFaceOffset      = 1;
 constexpr auto dirFrontChunkFaceOffset = 1 - SectionUnitLength;
 constexpr auto dirBackFaceOffset       = -1;
 constexpr auto dirBackChunkFaceOffset  = SectionUnitLength - 1;
-}   // namespace
 
-void
-RenderableChunk::ResetRenderBuffer( )
+// Sections with blocks one above or below height, as far as a block edit reaches
+inline uint32_t
+SectionMaskAround( int height )
 {
-    DeleteCache( );
-    m_NeighborTransparency = new uint32_t[ ChunkVolume ];
-    m_VertexMetaData       = new CubeVertexMetaData[ ChunkVolume ];
+    const int lowestSection  = std::max( height - 1, 0 ) >> SectionUnitLengthBinaryOffset;
+    const int highestSection = std::min( height + 1, ChunkMaxHeight - 1 ) >> SectionUnitLengthBinaryOffset;
+
+    return ( ( 2U << highestSection ) - 1 ) & ~( ( 1U << lowestSection ) - 1 );
 }
 
-void
-RenderableChunk::RegenerateVisibleFaces( )
+// Mesh data of sections not kept in ChunkMeshCache, reused by every section meshed on the thread
+SectionMeshData&
+GetMeshDataScratch( )
 {
-    std::lock_guard<std::recursive_mutex> lock( m_SyncMutex );
+    thread_local const auto scratch = std::make_unique<SectionMeshData>( );
+    return *scratch;
+}
+}   // namespace
+
+bool
+RenderableChunk::IsSectionFaceless( uint32_t sectionIndex ) const
+{
+    const auto occupancy = GetSectionOccupancy( sectionIndex );
+    if ( occupancy == eEmptySection ) return true;
+    if ( occupancy == eMixedSection ) return false;
 
-    for ( int i = 0; i < ChunkVolume; ++i )
-        UpdateNeighborAt( i );
+    // Faces at the bottom and top of the world are always visible
+    if ( sectionIndex == 0 || sectionIndex == MaxSectionInChunk - 1 ) return false;
 
-    m_VisibleFacesCount = 0;
-    for ( int i = 0; i < ChunkVolume; ++i )
+    // Buried, every block within reach of ComputeNeighborTransparency is opaque
+    for ( uint32_t i = sectionIndex - 1; i <= sectionIndex + 1; ++i )
     {
-        // only count faces directed covered
-        m_VisibleFacesCount += std::popcount( m_NeighborTransparency[ i ] & DirFaceMask );
-        UpdateMetaDataAt( i );
+        if ( GetSectionOccupancy( i ) != eOpaqueSection ) return false;
+        for ( const auto* chunk : m_NearChunks )
+            if ( chunk->GetSectionOccupancy( i ) != eOpaqueSection ) return false;
     }
+
+    return true;
 }
 
 namespace
 {
-inline auto&
+inline Block
 BlockAtOffset( const std::tuple<RenderableChunk*, EightWayDirection, uint32_t>& chunkIndexPair, CoordinateType indexOffset )
 {
     return std::get<0>( chunkIndexPair )->At( std::get<2>( chunkIndexPair ) + indexOffset );
@@ -159,18 +174,17 @@ RenderableChunk::GetHorizontalChunkAfterPointMoved( uint32_t index )
     return result;
 }
 
-void
-RenderableChunk::UpdateNeighborAt( uint32_t index )
+uint32_t
+RenderableChunk::ComputeNeighborTransparency( uint32_t index )
 {
     assert( m_EmptySlot == 0 );
     assert( std::all_of( m_NearChunks.begin( ), m_NearChunks.end( ), []( const auto& chunk ) { return chunk != nullptr; } ) );
     assert( index < ChunkVolume );
-    assert( m_NeighborTransparency != nullptr );
 
-    auto& blockNeighborTransparency = m_NeighborTransparency[ index ] = 0;
+    uint32_t blockNeighborTransparency = 0;
 
     // not matter at this point
-    if ( At( index ).Transparent( ) ) return;
+    if ( At( index ).Transparent( ) ) return blockNeighborTransparency;
 
     const bool blockOnTop    = indexToHeight( index ) == ChunkMaxHeight - 1;
     const bool blockOnBottom = indexToHeight( index ) == 0;
@@ -243,22 +257,75 @@ RenderableChunk::UpdateNeighborAt( uint32_t index )
 #undef CHUNK_DIR
 #undef CHUNK_DIR_OFFSET
 #undef DIAGONAL_CHECK
+
+    return blockNeighborTransparency;
+}
+
+void
+RenderableChunk::FillSectionMeshData( uint32_t sectionIndex, SectionMeshData& meshData )
+{
+    // Every block is transparent or has no transparent block within reach
+    if ( IsSectionFaceless( sectionIndex ) )
+    {
+        meshData.neighborTransparency.fill( 0 );
+        return;
+    }
+
+    const uint32_t sectionBegin = sectionIndex << SectionVolumeBinaryOffset;
+    for ( uint32_t i = 0; i < SectionVolume; ++i )
+        UpdateMeshDataAt( meshData, sectionBegin + i );
+}
+
+void
+RenderableChunk::UpdateMeshDataAt( SectionMeshData& meshData, uint32_t index )
+{
+    const uint32_t sectionBlockIndex    = index & ( SectionVolume - 1 );
+    const auto     neighborTransparency = meshData.neighborTransparency[ sectionBlockIndex ] = ComputeNeighborTransparency( index );
+
+    // only read by the greedy mesher for visible faces
+    if ( neighborTransparency & DirFaceMask ) meshData.vertexMetaData[ sectionBlockIndex ] = ComputeCubeVertexMetaData( index, neighborTransparency );
+}
+
+void
+RenderableChunk::UpdateCachedMeshDataAt( uint32_t index )
+{
+    if ( m_World == nullptr || m_EmptySlot != 0 ) return;
+
+    if ( const auto meshData = m_World->GetChunkPool( ).GetMeshCache( ).Peek( this, index >> SectionVolumeBinaryOffset ) )
+        UpdateMeshDataAt( *meshData, index );
+}
+
+void
+RenderableChunk::EraseCachedMeshData( )
+{
+    if ( m_World != nullptr ) m_World->GetChunkPool( ).GetMeshCache( ).Erase( this );
 }
 
 
 void
 RenderableChunk::GenerateRenderBuffer( )
 {
-    // TODO: remove m_VisibleFacesCount
-    if ( m_VisibleFacesCount == 0 ) return;
+    std::lock_guard<std::recursive_mutex> lock( m_SyncMutex );
 
-    const auto requiredMeshes    = GenerateGreedyMesh( );
-    uint32_t   greedyVisibleFace = 0;
-    for ( const auto& mesh : requiredMeshes )
-        for ( const auto& face : mesh )
-            greedyVisibleFace += static_cast<uint32_t>( face.second.faces.size( ) );
+    // requested again once the surrounding is completed, see SyncChunkFromDirection
+    if ( !NeighborCompleted( ) ) return;
 
-    // Logger::getInstance( ).LogLine( Logger::LogType::eInfo, "Generating chunk:", chunk.GetCoordinate( ) );
+    const uint32_t dirtySections  = std::exchange( m_DirtySectionMask, 0 );
+    const uint32_t editedSections = std::exchange( m_EditedSectionMask, 0 );
+    if ( dirtySections == 0 ) return;
+
+    std::array<std::vector<DataType::PackedChunkVertex>, MaxSectionInChunk> sectionVertices;
+    for ( uint32_t sections = dirtySections; sections != 0; sections &= sections - 1 )
+    {
+        const int sectionIndex = std::countr_zero( sections );
+
+        sectionVertices[ sectionIndex ]          = GenerateSectionVertices( sectionIndex, editedSections & ( 1U << sectionIndex ) );
+        m_SectionIndexBufferSize[ sectionIndex ] = ScaleToSecond<FaceVerticesCount, FaceIndicesCount>( (uint32_t) sectionVertices[ sectionIndex ].size( ) );
+    }
+
+    m_IndexBufferSize = 0;
+    for ( const auto sectionIndexBufferSize : m_SectionIndexBufferSize )
+        m_IndexBufferSize += sectionIndexBufferSize;
 
     static_assert( MinecraftCoordinateXIndex == 0 );
     auto [ chunkX, chunkZ ] = GetChunkCoordinate( );
@@ -266,97 +333,146 @@ RenderableChunk::GenerateRenderBuffer( )
     chunkX <<= SectionUnitLengthBinaryOffset;
     chunkZ <<= SectionUnitLengthBinaryOffset;
 
-    static const std::array<IndexBufferType, FaceIndicesCount> blockIndices        = { 0, 1, 2, 2, 3, 0 };
-    static const std::array<IndexBufferType, FaceIndicesCount> blockIndicesFlipped = { 0, 1, 3, 1, 2, 3 };
+    auto& chunkSolidBuffer = ChunkSolidBuffer::GetInstance( );
 
-    const auto verticesDataSize = (uint32_t) ScaleToSecond<1, sizeof( DataType::TexturedVertex ) * FaceVerticesCount>( greedyVisibleFace );
-    const auto indicesDataSize  = (uint32_t) ScaleToSecond<1, sizeof( IndexBufferType )>( m_IndexBufferSize = ScaleToSecond<1, FaceIndicesCount>( greedyVisibleFace ) );
+    // compaction may move the allocations, they are only touched under this lock
+    std::lock_guard<std::mutex> ownerLock( chunkSolidBuffer.GetAllocationOwnerLock( ) );
 
-    if ( m_BufferAllocation.targetChunk == nullptr )
-        m_BufferAllocation = ChunkSolidBuffer::GetInstance( ).CreateBuffer( verticesDataSize, indicesDataSize );
-    else
-        m_BufferAllocation = ChunkSolidBuffer::GetInstance( ).AlterBuffer( m_BufferAllocation, verticesDataSize, indicesDataSize );
+    // Uploaded together, the chunk never draws with only part of its sections remeshed
+    std::vector<std::pair<ChunkSolidBuffer::SuitableAllocation, void*>> uploads;
+    for ( uint32_t sections = dirtySections; sections != 0; sections &= sections - 1 )
+    {
+        const int sectionIndex = std::countr_zero( sections );
+        auto&     allocation   = m_SectionAllocations[ sectionIndex ];
+        auto&     vertices     = sectionVertices[ sectionIndex ];
+
+        if ( vertices.empty( ) )
+        {
+            // no draw for sections without faces
+            if ( allocation.targetChunk != nullptr )
+            {
+                chunkSolidBuffer.DelayedDeleteBuffer( allocation );
+                allocation = { };
+            }
+
+            continue;
+        }
 
-    const uint32_t indexOffset = ScaleToSecond<sizeof( DataType::TexturedVertex ), 1, uint32_t>( m_BufferAllocation.region.vertexStartingOffset );
+        const auto       verticesDataSize = (uint32_t) ( vertices.size( ) * sizeof( DataType::PackedChunkVertex ) );
+        const glm::ivec3 sectionOrigin { chunkX, sectionIndex << SectionUnitLengthBinaryOffset, chunkZ };
+        if ( allocation.targetChunk == nullptr )
+            allocation = chunkSolidBuffer.CreateBuffer( verticesDataSize, sectionOrigin );
+        else
+            allocation = chunkSolidBuffer.AlterBuffer( allocation, verticesDataSize, sectionOrigin );
 
-    std::unique_ptr<DataType::TexturedVertex[]> chunkVertices = std::make_unique<DataType::TexturedVertex[]>( ScaleToSecond<1, FaceVerticesCount>( greedyVisibleFace ) );
-    std::unique_ptr<IndexBufferType[]>          chunkIndices  = std::make_unique<IndexBufferType[]>( m_IndexBufferSize );
+        chunkSolidBuffer.SetAllocationOwner( &allocation );
+        uploads.emplace_back( allocation, vertices.data( ) );
+    }
 
-    auto        chunkIndicesPtr  = chunkIndices.get( );
-    auto        chunkVerticesPtr = chunkVertices.get( );
-    int         faceAdded        = 0;
-    const auto& blockTextures    = Minecraft::GetInstance( ).GetBlockTextures( );
-    for ( auto dir = CubeDirection { 0 }; dir < CubeDirection::DirSize; ++dir )
+    chunkSolidBuffer.CopyBuffers( uploads );
+}
+
+void
+RenderableChunk::RequestRemesh( )
+{
+    if ( m_World != nullptr ) m_World->GetChunkPool( ).GetRemeshQueue( ).Request( this );
+}
+
+std::vector<DataType::PackedChunkVertex>
+RenderableChunk::GenerateSectionVertices( uint32_t sectionIndex, bool keepMeshData )
+{
+    std::vector<DataType::PackedChunkVertex> chunkVertices;
+    if ( IsSectionFaceless( sectionIndex ) ) return chunkVertices;
+
+    /*
+     *
+     * Sections edited before are likely to be edited again, keep their mesh data to be patched by SetBlock
+     * Anything else is meshed from scratch
+     *
+     * */
+    std::shared_ptr<SectionMeshData> cachedMeshData;
+    if ( keepMeshData && m_World != nullptr )
     {
-        for ( const auto& faces : requiredMeshes[ dir ] )
+        auto& meshCache = m_World->GetChunkPool( ).GetMeshCache( );
+        if ( meshCache.IsEnabled( ) && ( cachedMeshData = meshCache.Find( this, sectionIndex ) ) == nullptr )
         {
-            const auto& vertexMeta = faces.first;
-            const auto& textures   = blockTextures.GetTextureLocationByIndex( vertexMeta.GetTextureID( ) );
+            cachedMeshData = std::make_shared<SectionMeshData>( );
+            FillSectionMeshData( sectionIndex, *cachedMeshData );
+            meshCache.Insert( this, sectionIndex, cachedMeshData );
+        }
+    }
 
-            for ( const auto& face : faces.second.faces )
-            {
-                auto textureCopy = textures;
-                textureCopy[ 0 ].pos *= face.scale;
-                textureCopy[ 0 ].accumulatedTextureCoordinate *= face.textureScale;
-                textureCopy[ 1 ].pos *= face.scale;
-                textureCopy[ 1 ].accumulatedTextureCoordinate *= face.textureScale;
-                textureCopy[ 2 ].pos *= face.scale;
-                textureCopy[ 2 ].accumulatedTextureCoordinate *= face.textureScale;
-                textureCopy[ 3 ].pos *= face.scale;
-                textureCopy[ 3 ].accumulatedTextureCoordinate *= face.textureScale;
-
-                /*
-                 * for javascript debug purpose
-                 * https://github.com/mikolalysenko/mikolalysenko.github.com/tree/gh-pages/MinecraftMeshes
-                 *
-                 * */
-                // using Log   = LoggerBase<false, false, false>;
-                // static const auto render = []( const glm::vec3& vec ) {
-                //     Log::getInstance( ).LogLine( "[", vec.x, ",", vec.y, ",", vec.z, "]," );
-                // };
-                // Log::getInstance( ).LogLine( "quads.push([" );
-                //
-                // render( textureCopy[ 0 ].pos + face.offset );
-                // render( textureCopy[ 1 ].pos + face.offset );
-                // render( textureCopy[ 2 ].pos + face.offset );
-                // render( textureCopy[ 3 ].pos + face.offset );
-                //
-                // Log::getInstance( ).LogLine( " ]);" );
-
-                // AddFace( textureCopy, (glm::vec3) face.offset + glm::vec3( chunkX, 0, chunkZ ), vertexMeta.ambientOcclusionData, vertexMeta.quadFlipped );
-                static constexpr auto faceShaderMultiplier = 1.0f / 3;
-
-                // Copy vertex data
-                for ( int i = 0; i < FaceVerticesCount; ++i )
-                {
-                    chunkVerticesPtr[ i ] = textureCopy[ i ];
-                    chunkVerticesPtr[ i ].pos += (glm::vec3) face.offset + glm::vec3( chunkX, 0, chunkZ );
-                    chunkVerticesPtr[ i ].textureCoor_ColorIntensity.z *= 0.2f + GetAmbientOcclusionDataAt( vertexMeta.ambientOcclusionData, i ) * faceShaderMultiplier;
-                }
+    auto* meshData = cachedMeshData.get( );
+    if ( meshData == nullptr )
+    {
+        meshData = &GetMeshDataScratch( );
+        FillSectionMeshData( sectionIndex, *meshData );
+    }
 
-                chunkVerticesPtr += FaceVerticesCount;
+    const auto     requiredMeshes    = GenerateGreedyMesh( meshData->neighborTransparency.data( ), meshData->vertexMetaData.data( ), sectionIndex, sectionIndex + 1 );
+    const uint32_t greedyVisibleFace = static_cast<uint32_t>( requiredMeshes.size( ) );
 
-                // Use different index buffer base on ambient occlusion side
-                if ( vertexMeta.GetQuadFlipped( ) )
-                {
-                    for ( int k = 0; k < FaceIndicesCount; ++k, ++chunkIndicesPtr )
-                    {
-                        *chunkIndicesPtr = blockIndicesFlipped[ k ] + ScaleToSecond<1, FaceVerticesCount>( faceAdded ) + indexOffset;
-                    }
-                } else
-                {
-                    for ( int k = 0; k < FaceIndicesCount; ++k, ++chunkIndicesPtr )
-                    {
-                        *chunkIndicesPtr = blockIndices[ k ] + ScaleToSecond<1, FaceVerticesCount>( faceAdded ) + indexOffset;
-                    }
-                }
+    // Logger::getInstance( ).LogLine( Logger::LogType::eInfo, "Generating chunk:", chunk.GetCoordinate( ) );
 
-                ++faceAdded;
-            }
+    // Vertices are relative to the section
+    const glm::ivec3 sectionOffset { 0, (int) sectionIndex << SectionUnitLengthBinaryOffset, 0 };
+
+    chunkVertices.resize( ScaleToSecond<1, FaceVerticesCount>( greedyVisibleFace ) );
+
+    // Same corners as the accumulated texture coordinate in BlockTexture, in blocks
+    static constexpr std::array<glm::ivec2, FaceVerticesCount> textureCorners = {
+        glm::ivec2 { 0, 0 },
+        glm::ivec2 { 1, 0 },
+        glm::ivec2 { 1, 1 },
+        glm::ivec2 { 0, 1 }
+    };
+
+    auto        chunkVerticesPtr = chunkVertices.data( );
+    const auto& blockTextures    = Minecraft::GetInstance( ).GetBlockTextures( );
+    for ( const auto& face : requiredMeshes )
+    {
+        const auto& vertexMeta = face.metaData;
+        const auto& textures   = blockTextures.GetTextureLocationByIndex( vertexMeta.GetTextureID( ) );
+        const auto& atlasCell  = blockTextures.GetTextureAtlasCellByIndex( vertexMeta.GetTextureID( ) );
+
+        /*
+         * for javascript debug purpose
+         * https://github.com/mikolalysenko/mikolalysenko.github.com/tree/gh-pages/MinecraftMeshes
+         *
+         * */
+        // using Log   = LoggerBase<false, false, false>;
+        // static const auto render = []( const glm::vec3& vec ) {
+        //     Log::getInstance( ).LogLine( "[", vec.x, ",", vec.y, ",", vec.z, "]," );
+        // };
+        // Log::getInstance( ).LogLine( "quads.push([" );
+        //
+        // render( textures[ 0 ].pos * face.scale + face.offset );
+        // render( textures[ 1 ].pos * face.scale + face.offset );
+        // render( textures[ 2 ].pos * face.scale + face.offset );
+        // render( textures[ 3 ].pos * face.scale + face.offset );
+        //
+        // Log::getInstance( ).LogLine( " ]);" );
+
+        // Every quad is drawn with indices { 0, 1, 2, 2, 3, 0 } from the shared quad index buffer
+        // Splitting along the other diagonal base on ambient occlusion side is the same as starting from the second vertex
+        const int firstVertex = vertexMeta.GetQuadFlipped( ) ? 1 : 0;
+
+        // Pack vertex data, section relative, intensity is recomputed from face and ambient occlusion in shader
+        for ( int k = 0; k < FaceVerticesCount; ++k )
+        {
+            const int i = ( firstVertex + k ) % FaceVerticesCount;
+
+            chunkVerticesPtr[ k ] = DataType::PackedChunkVertex( textures[ i ].pos * face.scale + face.offset - sectionOffset,
+                                                                 face.direction,
+                                                                 GetAmbientOcclusionDataAt( vertexMeta.ambientOcclusionData, i ),
+                                                                 atlasCell,
+                                                                 glm::uvec2( textureCorners[ i ] * face.textureScale ) );
         }
+
+        chunkVerticesPtr += FaceVerticesCount;
     }
 
-    ChunkSolidBuffer::GetInstance( ).CopyBuffer( m_BufferAllocation, chunkVertices.get( ), chunkIndices.get( ) );
+    return chunkVertices;
 }
 
 bool
@@ -366,104 +482,76 @@ RenderableChunk::SetBlock( const BlockCoordinate& blockCoordinate, const Block&
     assert( blockIndex >= 0 && blockIndex < ChunkVolume );
     assert( std::all_of( m_NearChunks.begin( ), m_NearChunks.end( ), []( const auto& chunk ) { return chunk != nullptr; } ) );
 
-    const auto isBlockTransparent  = block.Transparent( );
-    const auto transparencyChanged = At( blockIndex ).Transparent( ) ^ isBlockTransparent;
+    // Remesh workers read these chunks under their sync lock
+    std::lock_guard<std::recursive_mutex>                                     lock( m_SyncMutex );
+    std::array<std::unique_lock<std::recursive_mutex>, EightWayDirectionSize> nearChunkLocks;
+    for ( int i = 0; i < EightWayDirectionSize; ++i )
+        if ( m_NearChunks[ i ] != nullptr ) nearChunkLocks[ i ] = std::unique_lock<std::recursive_mutex>( m_NearChunks[ i ]->m_SyncMutex );
+
+    const auto transparencyChanged = At( blockIndex ).Transparent( ) ^ block.Transparent( );
     const auto successSetting      = Chunk::SetBlock( blockIndex, block );
 
     if ( !successSetting ) return false;
-    if ( transparencyChanged && m_EmptySlot == 0 )
-    {
-        const auto faceCountDiff = isBlockTransparent ? 1 : -1;
-
-        const bool blockOnTop    = indexToHeight( blockIndex ) == ChunkMaxHeight - 1;
-        const bool blockOnBottom = indexToHeight( blockIndex ) == 0;
+    if ( m_EmptySlot != 0 ) return true;
 
-        const int originalFaceCount = std::popcount( m_NeighborTransparency[ blockIndex ] & DirFaceMask );
-        UpdateNeighborAt( blockIndex );
-        const int newFaceCount = std::popcount( m_NeighborTransparency[ blockIndex ] & DirFaceMask );
-
-        m_VisibleFacesCount += newFaceCount - originalFaceCount;
+    const uint32_t blockSectionMask = 1U << ( blockIndex >> SectionVolumeBinaryOffset );
+    if ( !transparencyChanged )
+    {
+        // Only the textures of the block itself changed
+        UpdateCachedMeshDataAt( blockIndex );
+        m_DirtySectionMask |= blockSectionMask;
+        m_EditedSectionMask |= blockSectionMask;
+        RequestRemesh( );
 
-        const auto* blockPtr = m_Blocks.get( ) + blockIndex;
-        if ( !blockOnTop )
-            if ( !blockPtr[ dirUpFaceOffset ].Transparent( ) )
-            {
-                m_NeighborTransparency[ blockIndex + dirUpFaceOffset ] ^= DirDownBit;
-                UpdateAmbientOcclusionAt( blockIndex + dirUpFaceOffset );
-                m_VisibleFacesCount += faceCountDiff;
-            }
+        return true;
+    }
 
-        if ( !blockOnBottom )
-            if ( !blockPtr[ dirDownFaceOffset ].Transparent( ) )
-            {
-                m_NeighborTransparency[ blockIndex + dirDownFaceOffset ] ^= DirUpBit;
-                UpdateAmbientOcclusionAt( blockIndex + dirDownFaceOffset );
-                m_VisibleFacesCount += faceCountDiff;
-            }
+    // Faces and ambient occlusion change within one block of the edit, only their sections are remeshed
+    const int      blockHeight       = indexToHeight( blockIndex );
+    const uint32_t editedSectionMask = SectionMaskAround( blockHeight );
+    const auto     markEdited        = [ & ]( RenderableChunk* chunk ) {
+        chunk->m_DirtySectionMask |= editedSectionMask;
+        chunk->m_EditedSectionMask |= editedSectionMask;
+    };
+
+    // Transparent blocks have no neighbor transparency, only opaque ones within reach are updated
+    const auto updateColumn = [ & ]( RenderableChunk* chunk, uint32_t index ) {
+        bool reached = false;
+        for ( int heightOffset = -1; heightOffset <= 1; ++heightOffset )
+        {
+            const int height = blockHeight + heightOffset;
+            if ( height < 0 || height >= ChunkMaxHeight ) continue;
 
-        const auto horizontalIndexChunkAfterPointMoved = GetHorizontalChunkAfterPointMoved( blockIndex );
-
-#define UpdateAlongDir( dir )                                                                                                           \
-    {                                                                                                                                   \
-        constexpr auto oppositeDirectionBit                 = DirectionBit( 1 << ( IntLog<(int) Dir##dir##Bit, 2>::value ^ 0b1 ) );     \
-        constexpr auto oppositeDirectionDownBit             = DirectionBit( 1 << ( IntLog<(int) Dir##dir##UpBit, 2>::value ^ 0b1 ) );   \
-        constexpr auto oppositeDirectionUpBit               = DirectionBit( 1 << ( IntLog<(int) Dir##dir##DownBit, 2>::value ^ 0b1 ) ); \
-        const auto [ chunk, chunkBackwordDirection, index ] = horizontalIndexChunkAfterPointMoved[ EWDir##dir ];                        \
-        if ( !BlockAtOffset( horizontalIndexChunkAfterPointMoved[ EWDir##dir ], 0 ).Transparent( ) )                                    \
-        {                                                                                                                               \
-            chunk->m_NeighborTransparency[ index ] ^= oppositeDirectionBit;                                                             \
-            chunk->UpdateAmbientOcclusionAt( index );                                                                                   \
-                                                                                                                                        \
-            /* Within visible range (not diagonal) */                                                                                   \
-            if constexpr ( EWDir##dir <= EWDirLeft )                                                                                    \
-                chunk->m_VisibleFacesCount += faceCountDiff;                                                                            \
-            /* regenerate other chunks faces */                                                                                         \
-            if ( chunk != this ) chunk->SyncChunkFromDirection( this, chunkBackwordDirection ^ 0b1, true );                             \
-        }                                                                                                                               \
-                                                                                                                                        \
-        if ( !BlockAtOffset( horizontalIndexChunkAfterPointMoved[ EWDir##dir ], dirUpFaceOffset ).Transparent( ) )                      \
-        {                                                                                                                               \
-            chunk->m_NeighborTransparency[ index + dirUpFaceOffset ] ^= oppositeDirectionDownBit;                                       \
-            chunk->UpdateAmbientOcclusionAt( index + dirUpFaceOffset );                                                                 \
-                                                                                                                                        \
-            /* regenerate other chunks faces */                                                                                         \
-            if ( chunk != this ) chunk->SyncChunkFromDirection( this, chunkBackwordDirection ^ 0b1, true );                             \
-        }                                                                                                                               \
-                                                                                                                                        \
-        if ( !BlockAtOffset( horizontalIndexChunkAfterPointMoved[ EWDir##dir ], dirDownFaceOffset ).Transparent( ) )                    \
-        {                                                                                                                               \
-            chunk->m_NeighborTransparency[ index + dirDownFaceOffset ] ^= oppositeDirectionUpBit;                                       \
-            chunk->UpdateAmbientOcclusionAt( index + dirDownFaceOffset );                                                               \
-                                                                                                                                        \
-            /* regenerate other chunks faces */                                                                                         \
-            if ( chunk != this ) chunk->SyncChunkFromDirection( this, chunkBackwordDirection ^ 0b1, true );                             \
-        }                                                                                                                               \
-    }
+            const uint32_t columnIndex = index + heightOffset * dirUpFaceOffset;
+            if ( chunk->At( columnIndex ).Transparent( ) ) continue;
 
-        UpdateAlongDir( Front );
-        UpdateAlongDir( Back );
-        UpdateAlongDir( Right );
-        UpdateAlongDir( Left );
+            chunk->UpdateCachedMeshDataAt( columnIndex );
+            reached = true;
+        }
 
-        UpdateAlongDir( FrontRight );
-        UpdateAlongDir( FrontLeft );
-        UpdateAlongDir( BackRight );
-        UpdateAlongDir( BackLeft );
+        return reached;
+    };
 
-#undef UpdateAlongDir
+    // lost its faces, not reached by updateColumn
+    if ( block.Transparent( ) ) UpdateCachedMeshDataAt( blockIndex );
 
-#ifndef NDEBUG
+    updateColumn( this, blockIndex );
+    markEdited( this );
 
-        int checkingFaceCount = 0;
-        for ( int i = 0; i < ChunkVolume; ++i )
-            checkingFaceCount += std::popcount( m_NeighborTransparency[ i ] & DirFaceMask );
-        assert( m_VisibleFacesCount == checkingFaceCount );
-#endif
+    // Remesh requests are coalesced, near chunks are requested once after all updates
+    std::array<RenderableChunk*, EightWayDirectionSize> editedNearChunks { };
+    for ( const auto& [ chunk, chunkDirection, index ] : GetHorizontalChunkAfterPointMoved( blockIndex ) )
+    {
+        if ( !updateColumn( chunk, index ) ) continue;
 
-        // Update self ambient occlusion
-        UpdateMetaDataAt( blockIndex );
+        markEdited( chunk );
+        if ( chunk != this ) editedNearChunks[ chunkDirection ] = chunk;
     }
 
+    RequestRemesh( );
+    for ( auto* chunk : editedNearChunks )
+        if ( chunk != nullptr ) chunk->RequestRemesh( );
+
     return true;
 }
 
@@ -474,6 +562,10 @@ RenderableChunk::SyncChunkFromDirection( RenderableChunk* other, int fromDir, bo
     if ( m_EmptySlot == 0 )
     {
         m_NearChunks[ fromDir ] = other;
+
+        // Cached mesh data was computed from the blocks of the previous neighbor
+        if ( other == nullptr || changes ) EraseCachedMeshData( );
+
         if ( other == nullptr )
         {
             // Logger::getInstance( ).LogLine( Logger::LogType::eVerbose, GetCoordinate( ), "are now incomplete chunks" );
@@ -481,7 +573,8 @@ RenderableChunk::SyncChunkFromDirection( RenderableChunk* other, int fromDir, bo
 
         } else if ( changes )   // not necessarily, but performance tho
         {
-            GenerateRenderBuffer( );
+            m_DirtySectionMask = AllSectionMask;
+            RequestRemesh( );
         }
     } else
     {
@@ -493,9 +586,8 @@ RenderableChunk::SyncChunkFromDirection( RenderableChunk* other, int fromDir, bo
 
         if ( m_EmptySlot == 0 )
         {
-            // Chunk surrounding completed
-            ResetRenderBuffer( );
-            RegenerateVisibleFaces( );
+            // Chunk surrounding completed, mesh data is computed per section while meshing
+            m_DirtySectionMask = AllSectionMask;
             return true;
         }
     }
@@ -517,10 +609,10 @@ RenderableChunk::UpdateFacesAmbientOcclusion( FaceVertexAmbientOcclusionData& me
 }
 
 void
-RenderableChunk::UpdateAmbientOcclusionAt( uint32_t index )
+RenderableChunk::UpdateAmbientOcclusion( CubeVertexMetaData& metaData, uint32_t neighborTransparency )
 {
 
-    if ( const auto neighborTransparency = m_NeighborTransparency[ index ] )
+    if ( neighborTransparency )
     {
         // for ambient occlusion
 #define ToNotBoolArray( A, B, C, D, E, F, G, H )                                                       \
@@ -539,7 +631,7 @@ RenderableChunk::UpdateAmbientOcclusionAt( uint32_t index )
                     neighborTransparency& Dir##D8##Bit )
 
 #define Update( Dir, D1, D2, D3, D4, D5, D6, D7, D8 ) \
-    m_VertexMetaData[ index ].faceVertexMetaData[ Dir ].SetQuadFlipped( UpdateFacesAmbientOcclusion( m_VertexMetaData[ index ].faceVertexMetaData[ Dir ].ambientOcclusionData, PassNeighborTransparency( D1, D2, D3, D4, D5, D6, D7, D8 ) ) );
+    metaData.faceVertexMetaData[ Dir ].SetQuadFlipped( UpdateFacesAmbientOcclusion( metaData.faceVertexMetaData[ Dir ].ambientOcclusionData, PassNeighborTransparency( D1, D2, D3, D4, D5, D6, D7, D8 ) ) );
 
 
         if ( neighborTransparency & DirFrontBit )
@@ -562,236 +654,248 @@ RenderableChunk::UpdateAmbientOcclusionAt( uint32_t index )
 }
 
 
-void
-RenderableChunk::UpdateMetaDataAt( uint32_t index )
+CubeVertexMetaData
+RenderableChunk::ComputeCubeVertexMetaData( uint32_t index, uint32_t neighborTransparency )
 {
-    UpdateAmbientOcclusionAt( index );
+    CubeVertexMetaData metaData;
+    UpdateAmbientOcclusion( metaData, neighborTransparency );
 
     // For greedy meshing
-    const auto& textureIndices = Minecraft::GetInstance( ).GetBlockTextures( ).GetTextureIndices( m_Blocks[ index ] );
+    const auto& textureIndices = Minecraft::GetInstance( ).GetBlockTextures( ).GetTextureIndices( At( index ) );
     for ( int i = 0; i < CubeDirection::DirSize; ++i )
     {
         assert( textureIndices[ i ] <= FaceVertexMetaData::GetMaxTextureIDSupported( ) );
-        m_VertexMetaData[ index ].faceVertexMetaData[ i ].SetTextureID( (FaceVertexMetaData::TextureIDTy) textureIndices[ i ] );
+        metaData.faceVertexMetaData[ i ].SetTextureID( (FaceVertexMetaData::TextureIDTy) textureIndices[ i ] );
     }
+
+    return metaData;
 }
 
+namespace
+{
 /*
  *
- * From https://github.com/roboleary/GreedyMesh/blob/master/src/mygame/Main.java
- * with multiple bug fixes
+ * Rows of 64-bit masks, a row may span multiple words when running along y
  *
  * */
-std::array<std::unordered_map<FaceVertexMetaData, GreedyMeshCollection>, CubeDirection::DirSize>
-RenderableChunk::GenerateGreedyMesh( )
+inline int
+FindNextSetBit( const uint64_t* row, int from, int size )
 {
-    static constexpr std::array<int, 3> dims { SectionUnitLength, ChunkMaxHeight, SectionUnitLength };
+    for ( int word = from >> 6; ( word << 6 ) < size; ++word )
+    {
+        const uint64_t bits = row[ word ] & ( ~0ULL << ( from & 63 ) );
+        if ( bits != 0 ) return ( word << 6 ) + std::countr_zero( bits );
 
-    std::array<std::unordered_map<FaceVertexMetaData, GreedyMeshCollection>, CubeDirection::DirSize> faces;
+        from = ( word + 1 ) << 6;
+    }
 
-    /*
-     * These are just working variables for the algorithm - almost all taken
-     * directly from Mikola Lysenko's javascript implementation.
-     */
-    int i, j, k, l, w, h, u, v, n, side = 0;
+    return size;
+}
 
-    glm::ivec3 x { 0, 0, 0 };
-    glm::ivec3 q { 0, 0, 0 };
-    glm::ivec3 du { 0, 0, 0 };
-    glm::ivec3 dv { 0, 0, 0 };
+inline bool
+TestBit( const uint64_t* row, int index )
+{
+    return ( row[ index >> 6 ] >> ( index & 63 ) ) & 1;
+}
+
+inline uint64_t
+WordRangeMask( int word, int begin, int end )
+{
+    const int wordBegin = std::max( begin - ( word << 6 ), 0 );
+    const int wordEnd   = std::min( end - ( word << 6 ), 64 );
+
+    return ( wordEnd == 64 ? ~0ULL : ( 1ULL << wordEnd ) - 1 ) & ( ~0ULL << wordBegin );
+}
+
+inline bool
+TestRange( const uint64_t* row, int begin, int end )
+{
+    for ( int word = begin >> 6; ( word << 6 ) < end; ++word )
+        if ( const auto mask = WordRangeMask( word, begin, end ); ( row[ word ] & mask ) != mask ) return false;
+
+    return true;
+}
+
+inline void
+ClearRange( uint64_t* row, int begin, int end )
+{
+    for ( int word = begin >> 6; ( word << 6 ) < end; ++word )
+        row[ word ] &= ~WordRangeMask( word, begin, end );
+}
+
+// Sweep axis of each side, 0 for x, 1 for y, 2 for z
+constexpr std::array<int, CubeDirection::DirSize> sideAxis = [] {
+    std::array<int, CubeDirection::DirSize> result { };
+    result[ DirFront ] = result[ DirBack ] = 0;
+    result[ DirUp ] = result[ DirDown ] = 1;
+    result[ DirRight ] = result[ DirLeft ] = 2;
+    return result;
+}( );
+
+// Same side order as the original mask sweeping greedy mesher, keep quad order
+constexpr std::array<CubeDirection, CubeDirection::DirSize> sideOrder { DirBack, DirDown, DirLeft, DirFront, DirUp, DirRight };
+
+constexpr std::array<int, 3> axisIndexStride { 1, SectionSurfaceSize, SectionUnitLength };
+}   // namespace
+
+/*
+ *
+ * Binary greedy meshing, faces of each side and layer are 64-bit row masks built from the neighbor transparency
+ * Empty cells are skipped with ctz, rectangles grow and get cleared with word masks
+ *
+ * Quads are the same as the mask sweeping mesher from https://github.com/roboleary/GreedyMesh/blob/master/src/mygame/Main.java
+ * merging along u first, then v, for each layer of each side in order
+ *
+ * */
+std::vector<GreedyMeshFace>
+RenderableChunk::GenerateGreedyMesh( const uint32_t* neighborTransparency, const CubeVertexMetaData* vertexMetaData, uint32_t sectionBegin, uint32_t sectionEnd )
+{
+    std::vector<GreedyMeshFace> faces;
 
     /*
-     * We create a mask - this will contain the groups of matching voxel faces
-     * as we proceed through the chunk in 6 directions - once for each face.
+     * Only sweep the vertical range with sections that can have faces
      */
-    static constexpr auto                 EmptyTexture = FaceVertexMetaData::GetMaxTextureIDSupported( );
-    static constexpr FaceVertexMetaData   emptyFace { .textureID_quadFlipped = EmptyTexture };
-    std::unique_ptr<FaceVertexMetaData[]> mask = std::make_unique<FaceVertexMetaData[]>( SectionUnitLength * ChunkMaxHeight );
+    assert( sectionBegin < sectionEnd && sectionEnd <= MaxSectionInChunk );
 
-    /**
-     * We start with the lesser-spotted boolean for-loop (also known as the old flippy floppy).
-     *
-     * The variable backFace will be TRUE on the first iteration and FALSE on the second - this allows
-     * us to track which direction the indices should run during creation of the quad.
-     *
-     * This loop runs twice, and the inner loop 3 times - totally 6 iterations - one for each
-     * voxel face.
+    std::array<bool, MaxSectionInChunk> sectionFaceless;
+    int                                 faceSectionBegin = MaxSectionInChunk, faceSectionEnd = 0;
+    for ( int sectionIndex = (int) sectionBegin; sectionIndex < (int) sectionEnd; ++sectionIndex )
+        if ( !( sectionFaceless[ sectionIndex ] = IsSectionFaceless( sectionIndex ) ) )
+        {
+            faceSectionBegin = std::min( faceSectionBegin, sectionIndex );
+            faceSectionEnd   = sectionIndex + 1;
+        }
+
+    if ( faceSectionBegin >= faceSectionEnd ) return faces;
+
+    const std::array<int, 3> sweepBegin { 0, faceSectionBegin << SectionUnitLengthBinaryOffset, 0 };
+    const std::array<int, 3> sweepSize { SectionUnitLength, ( faceSectionEnd - faceSectionBegin ) << SectionUnitLengthBinaryOffset, SectionUnitLength };
+
+    /*
+     * Layout of each side, [layer][v][u] with u packed in words
      */
-    for ( bool backFace = true, b = false; b != backFace; backFace = backFace && b, b = !b )
+    struct SideMaskLayout {
+        int d, u, v;
+        int wordsPerRow, rowsPerLayer;
+        int offset;
+    };
+
+    std::array<SideMaskLayout, CubeDirection::DirSize> layouts;
+    int                                                totalWords = 0;
+    for ( int side = 0; side < CubeDirection::DirSize; ++side )
     {
+        auto& layout = layouts[ side ];
 
-        /*
-         * We sweep over the 3 dimensions - most of what follows is well described by Mikola Lysenko
-         * in his post - and is ported from his Javascript implementation.  Where this implementation
-         * diverges, I've added commentary.
-         */
-        for ( int d = 0; d < 3; d++ )
-        {
+        layout.d            = sideAxis[ side ];
+        layout.u            = ( layout.d + 1 ) % 3;
+        layout.v            = ( layout.d + 2 ) % 3;
+        layout.wordsPerRow  = ( sweepSize[ layout.u ] + 63 ) >> 6;
+        layout.rowsPerLayer = sweepSize[ layout.v ];
+        layout.offset       = totalWords;
 
-            u = ( d + 1 ) % 3;
-            v = ( d + 2 ) % 3;
+        totalWords += sweepSize[ layout.d ] * layout.rowsPerLayer * layout.wordsPerRow;
+    }
 
-            x[ 0 ] = 0;
-            x[ 1 ] = 0;
-            x[ 2 ] = 0;
+    // reused by every mesh generated on the thread
+    thread_local std::vector<uint64_t> masks;
+    masks.assign( totalWords, 0 );
 
-            // Move along d axis
-            q[ 0 ] = 0;
-            q[ 1 ] = 0;
-            q[ 2 ] = 0;
-            q[ d ] = 1;
+    const int meshDataBegin = (int) sectionBegin << SectionVolumeBinaryOffset;
 
-            /*
-             * Here we're keeping track of the side that we're meshing.
-             */
-            if ( d == 0 )
-            {
-                side = backFace ? DirBack : DirFront;
+    /*
+     * Scatter visible faces of every block into the masks
+     */
+    for ( int sectionIndex = faceSectionBegin; sectionIndex < faceSectionEnd; ++sectionIndex )
+    {
+        if ( sectionFaceless[ sectionIndex ] ) continue;
 
-            } else if ( d == 1 )
-            {
-                side = backFace ? DirDown : DirUp;
+        const int sectionBegin = sectionIndex << SectionVolumeBinaryOffset;
+        for ( int i = 0; i < SectionVolume; ++i )
+        {
+            auto visibleFaces = neighborTransparency[ sectionBegin - meshDataBegin + i ] & DirFaceMask;
+            if ( visibleFaces == 0 ) continue;
 
-            } else if ( d == 2 )
-            {
-                side = backFace ? DirLeft : DirRight;
-            }
+            const std::array<int, 3> coordinate { i & ( SectionUnitLength - 1 ),
+                                                  ( ( sectionBegin + i ) >> SectionSurfaceSizeBinaryOffset ) - sweepBegin[ 1 ],
+                                                  ( i >> SectionUnitLengthBinaryOffset ) & ( SectionUnitLength - 1 ) };
 
-            /*
-             * We move through the dimension from front to back
-             */
-            for ( x[ d ] = -1; x[ d ] < dims[ d ]; )
+            do
             {
+                const int   side   = std::countr_zero( visibleFaces );
+                const auto& layout = layouts[ side ];
+                visibleFaces &= visibleFaces - 1;
 
-                /*
-                 * -------------------------------------------------------------------
-                 *   We compute the mask
-                 * -------------------------------------------------------------------
-                 */
-                n = 0;
+                auto* row = masks.data( ) + layout.offset + ( coordinate[ layout.d ] * layout.rowsPerLayer + coordinate[ layout.v ] ) * layout.wordsPerRow;
+                row[ coordinate[ layout.u ] >> 6 ] |= 1ULL << ( coordinate[ layout.u ] & 63 );
+            } while ( visibleFaces != 0 );
+        }
+    }
 
-                for ( x[ v ] = 0; x[ v ] < dims[ v ]; x[ v ]++ )
-                {
+    /*
+     * Merge rectangles
+     */
+    for ( const auto side : sideOrder )
+    {
+        const auto& layout      = layouts[ side ];
+        const int   d           = layout.d;
+        const int   u           = layout.u;
+        const int   v           = layout.v;
+        const int   wordsPerRow = layout.wordsPerRow;
+        const int   rows        = layout.rowsPerLayer;
+        const int   sizeU       = sweepSize[ u ];
+
+        for ( int layer = 0; layer < sweepSize[ d ]; ++layer )
+        {
+            if ( d == 1 && sectionFaceless[ ( layer + sweepBegin[ d ] ) >> SectionUnitLengthBinaryOffset ] ) continue;
 
-                    for ( x[ u ] = 0; x[ u ] < dims[ u ]; x[ u ]++ )
-                    {
+            auto*     layerMask  = masks.data( ) + layout.offset + layer * rows * wordsPerRow;
+            const int layerIndex = ( layer + sweepBegin[ d ] ) * axisIndexStride[ d ] + sweepBegin[ u ] * axisIndexStride[ u ] + sweepBegin[ v ] * axisIndexStride[ v ] - meshDataBegin;
 
-                        /*
-                         * Here we retrieve two voxel faces for comparison.
-                         */
+            const auto metaAt = [ & ]( int i, int j ) -> const FaceVertexMetaData& {
+                return vertexMetaData[ layerIndex + i * axisIndexStride[ u ] + j * axisIndexStride[ v ] ].faceVertexMetaData[ side ];
+            };
 
-                        const BlockCoordinate block1Coordinate = MakeMinecraftCoordinate( x[ 0 ], x[ 1 ], x[ 2 ] );
-                        const BlockCoordinate block2Coordinate = MakeMinecraftCoordinate( x[ 0 ] + q[ 0 ], x[ 1 ] + q[ 1 ], x[ 2 ] + q[ 2 ] );
+            for ( int j = 0; j < rows; ++j )
+            {
+                auto* row = layerMask + j * wordsPerRow;
+                for ( int i = FindNextSetBit( row, 0, sizeU ); i < sizeU; )
+                {
+                    const auto& metaData = metaAt( i, j );
 
-                        const auto block1 = GetBlockIndex( block1Coordinate );
-                        const auto block2 = GetBlockIndex( block2Coordinate );
+                    int w = 1;
+                    while ( i + w < sizeU && TestBit( row, i + w ) && metaAt( i + w, j ) == metaData )
+                        ++w;
 
-                        bool face1Visible = x[ d ] >= 0 && m_NeighborTransparency[ block1 ] & ( 1 << side );
-                        bool face2Visible = x[ d ] < dims[ d ] - 1 && m_NeighborTransparency[ block2 ] & ( 1 << side );
+                    int h = 1;
+                    for ( ; j + h < rows; ++h )
+                    {
+                        if ( !TestRange( row + h * wordsPerRow, i, i + w ) ) break;
 
-                        if ( !backFace && face1Visible )
-                            mask[ n++ ] = m_VertexMetaData[ block1 ].faceVertexMetaData[ side ];
-                        else if ( backFace && face2Visible )
-                            mask[ n++ ] = m_VertexMetaData[ block2 ].faceVertexMetaData[ side ];
-                        else
-                            mask[ n++ ] = emptyFace;   // face covered, ont visible
+                        int k = 0;
+                        while ( k < w && metaAt( i + k, j + h ) == metaData )
+                            ++k;
+                        if ( k != w ) break;
                     }
-                }
 
-                x[ d ]++;
+                    glm::ivec3 offset { 0, 0, 0 };
+                    offset[ d ] = layer + sweepBegin[ d ];
+                    offset[ u ] = i + sweepBegin[ u ];
+                    offset[ v ] = j + sweepBegin[ v ];
 
-                /*
-                 * Now we generate the mesh for the mask
-                 */
-                n = 0;
+                    glm::ivec3 scale { 0, 0, 0 };
+                    scale[ d ] = 1;
+                    scale[ u ] = w;
+                    scale[ v ] = h;
 
-                for ( j = 0; j < dims[ v ]; j++ )
-                {
+                    glm::ivec2 textureScale { w, h };
+                    if ( d == 0 ) std::swap( textureScale[ 0 ], textureScale[ 1 ] );
 
-                    for ( i = 0; i < dims[ u ]; )
-                    {
+                    faces.emplace_back( offset, scale, textureScale, metaData, side );
 
-                        if ( mask[ n ].GetTextureID( ) != emptyFace.GetTextureID( ) )
-                        {
-
-                            /*
-                             * We compute the width
-                             */
-                            for ( w = 1; i + w < dims[ u ] && mask[ n + w ].GetTextureID( ) != EmptyTexture && mask[ n + w ] == mask[ n ]; w++ ) { }
-
-                            /*
-                             * Then we compute height
-                             */
-                            {
-                                for ( h = 1; j + h < dims[ v ]; h++ )
-                                {
-
-                                    for ( k = 0; k < w; k++ )
-                                    {
-
-                                        if ( mask[ n + k + h * dims[ u ] ].GetTextureID( ) == EmptyTexture || mask[ n + k + h * dims[ u ] ] != mask[ n ] )
-                                        {
-                                            goto compute_height_finish;
-                                        }
-                                    }
-                                }
-
-                            compute_height_finish:;
-                            }
-
-                            /*
-                             * Add quad
-                             */
-                            x[ u ] = i;
-                            x[ v ] = j;
-
-                            du[ 0 ] = 0;
-                            du[ 1 ] = 0;
-                            du[ 2 ] = 0;
-                            du[ u ] = w;
-
-                            dv[ 0 ] = 0;
-                            dv[ 1 ] = 0;
-                            dv[ 2 ] = 0;
-                            dv[ v ] = h;
-
-                            glm::ivec3 offset = x;
-                            if ( !backFace ) offset[ d ] -= 1; /* Counter for the cube vertex offset, this algorithm assume all faces starts at [0,0,0] */
-
-                            glm::ivec3 scale = du + dv;
-                            scale[ d ]       = 1;
-
-                            glm::ivec2 textureScale { w, h };
-                            if ( d == 0 ) std::swap( textureScale[ 0 ], textureScale[ 1 ] );
-
-                            /* Save face */
-                            faces[ side ][ mask[ n ] ].faces.emplace_back( offset, scale, textureScale );
-
-                            /*
-                             * We zero out the mask
-                             */
-                            for ( l = 0; l < h; ++l )
-                            {
-
-                                for ( k = 0; k < w; ++k )
-                                {
-                                    mask[ n + k + l * dims[ u ] ].SetTextureID( EmptyTexture );
-                                }
-                            }
-
-                            /*
-                             * And then finally increment the counters and continue
-                             */
-                            i += w;
-                            n += w;
-
-                        } else
-                        {
-
-                            i++;
-                            n++;
-                        }
-                    }
+                    for ( int l = 0; l < h; ++l )
+                        ClearRange( row + l * wordsPerRow, i, i + w );
+
+                    i = FindNextSetBit( row, i + w, sizeU );
                 }
             }
         }
@@ -803,28 +907,44 @@ RenderableChunk::GenerateGreedyMesh( )
 size_t
 RenderableChunk::GetObjectSize( ) const
 {
-    return Chunk::GetObjectSize( ) + sizeof( RenderableChunk ) + ( m_NeighborTransparency ? sizeof( m_NeighborTransparency[ 0 ] ) * ChunkVolume : 0 ) + ( m_VertexMetaData ? sizeof( m_VertexMetaData[ 0 ] ) * ChunkVolume : 0 );
+    // Mesh data is not resident, see SectionMeshData
+    return Chunk::GetObjectSize( ) + sizeof( RenderableChunk );
 }
 
 RenderableChunk::~RenderableChunk( )
 {
-    DeleteCache( );
+    // wait for a running remesh, nothing else can request this chunk by now
+    if ( m_World != nullptr ) m_World->GetChunkPool( ).GetRemeshQueue( ).Cancel( this );
+
+    EraseCachedMeshData( );
 
-    if ( m_BufferAllocation.targetChunk != nullptr )
     {
-        ChunkSolidBuffer::GetInstance( ).DelayedDeleteBuffer( m_BufferAllocation );
+        std::lock_guard<std::mutex> lock( ChunkSolidBuffer::GetInstance( ).GetAllocationOwnerLock( ) );
+        for ( const auto& allocation : m_SectionAllocations )
+            if ( allocation.targetChunk != nullptr )
+                ChunkSolidBuffer::GetInstance( ).DelayedDeleteBuffer( allocation );
     }
 
-    std::stringstream ss;
+    // already unlinked if the chunk was retired by ChunkPool
+    UnlinkNearChunks( );
+
+    LOGL_VERB( "Chunk deleted from", GetChunkCoordinate( ), this )
+}
+
+void
+RenderableChunk::UnlinkNearChunks( )
+{
     for ( int i = 0; i < EightWayDirectionSize; ++i )
     {
-        if ( m_NearChunks[ i ] != nullptr )
+        auto* nearChunk = m_NearChunks[ i ];
+        if ( nearChunk == nullptr ) continue;
+
         {
-            const auto otherCoordinate = GetChunkCoordinate( ) + ChunkPool::NearChunkDirection[ i ];
-            ss << " " << otherCoordinate << " " << m_NearChunks[ i ];
-            m_NearChunks[ i ]->SyncChunkFromDirection( nullptr, static_cast<EightWayDirection>( i ^ 0b1 ) );
+            // near chunk could be linked to a newer chunk at this coordinate
+            std::lock_guard<std::recursive_mutex> lock( nearChunk->m_SyncMutex );
+            if ( nearChunk->m_NearChunks[ i ^ 0b1 ] == this ) nearChunk->SyncChunkFromDirection( nullptr, static_cast<EightWayDirection>( i ^ 0b1 ) );
         }
-    }
 
-    LOGL_VERB( ss.str( ), "deleted from", GetChunkCoordinate( ), this )
+        SyncChunkFromDirection( nullptr, static_cast<EightWayDirection>( i ) );
+    }
 }
@@ -16,8 +16,9 @@
 #include <Graphic/Vulkan/VulkanAPI.hpp>
 
 #include <unordered_map>
+#include <vector>
 
-using ChunkSolidBuffer = ChunkRenderBuffers<DataType::TexturedVertex, IndexBufferType>;
+using ChunkSolidBuffer = ChunkRenderBuffers<DataType::PackedChunkVertex, IndexBufferType>;
 
 using FaceVertexAmbientOcclusionData = uint8_t;
 // union FaceVertexAmbientOcclusionData
@@ -92,54 +93,45 @@ struct CubeVertexMetaData {
     FaceVertexMetaData faceVertexMetaData[ CubeDirection::DirSize ];
 };
 
+/*
+ *
+ * Neighbor transparency and vertex meta data of every block in a section, indexed from the first block of the section
+ * Meta data is only filled for blocks with a visible face
+ *
+ * Computed while the section is meshed, into thread local scratch, or kept in ChunkMeshCache for recently edited chunks
+ *
+ * */
+struct SectionMeshData {
+    std::array<uint32_t, SectionVolume>           neighborTransparency;
+    std::array<CubeVertexMetaData, SectionVolume> vertexMetaData;
+};
+
 struct GreedyMeshFace {
 
     glm::ivec3 offset, scale;
     glm::ivec2 textureScale;
 
-    GreedyMeshFace( glm::ivec3 offset, glm::ivec3 scale, glm::ivec2 textureScale )
+    FaceVertexMetaData metaData;
+    CubeDirection      direction;
+
+    GreedyMeshFace( glm::ivec3 offset, glm::ivec3 scale, glm::ivec2 textureScale, FaceVertexMetaData metaData, CubeDirection direction )
         : offset( offset )
         , scale( scale )
         , textureScale( textureScale )
+        , metaData( metaData )
+        , direction( direction )
     { }
-};
-
-struct GreedyMeshCollection {
 
-    std::vector<GreedyMeshFace> faces;
-};
-
-namespace std
-{
-
-template <>
-struct hash<FaceVertexMetaData> {
-    std::size_t operator( )( const FaceVertexMetaData& k ) const
+    inline bool operator==( const GreedyMeshFace& other ) const
     {
-        // Compute individual hash values for first,
-        // second and third and combine them using XOR
-        // and bit shifting:
-
-        return ( (std::size_t) k.textureID_quadFlipped << sizeof( FaceVertexAmbientOcclusionData ) )
-            + k.ambientOcclusionData;
+        return offset == other.offset && scale == other.scale && textureScale == other.textureScale && metaData == other.metaData && direction == other.direction;
     }
 };
 
-}   // namespace std
-
 class RenderableChunk : public Chunk
 {
 protected:
-    /*
-     *
-     * Chunk detail
-     *
-     * */
-    uint32_t* m_NeighborTransparency { };
-    static_assert( IntLog<DirBitSize - 1, 2>::value < ( sizeof( std::remove_pointer_t<decltype( m_NeighborTransparency )> ) << 3 ) );
-
-    int                 m_VisibleFacesCount = 0;
-    CubeVertexMetaData* m_VertexMetaData { };
+    static_assert( IntLog<DirBitSize - 1, 2>::value < ( sizeof( SectionMeshData::neighborTransparency[ 0 ] ) << 3 ) );
 
     std::array<RenderableChunk*, EightWayDirectionSize> m_NearChunks { };
     uint8_t                                             m_EmptySlot = ( 1 << EightWayDirectionSize ) - 1;
@@ -154,12 +146,24 @@ protected:
 
     /*
      *
-     * Render buffer
+     * Render buffer, each section is meshed into an allocation of its own
+     * so a block edit only remeshes and uploads the sections it reaches
      *
      * */
+    static constexpr uint32_t AllSectionMask = ( 1U << MaxSectionInChunk ) - 1;
+    static_assert( MaxSectionInChunk < 32 );
+
     uint32_t m_IndexBufferSize { };
+    uint32_t m_DirtySectionMask = AllSectionMask;
 
-    ChunkSolidBuffer::SuitableAllocation m_BufferAllocation;
+    // Dirtied by SetBlock, their mesh data is kept in ChunkMeshCache when meshed
+    uint32_t m_EditedSectionMask = 0;
+
+    std::array<ChunkSolidBuffer::SuitableAllocation, MaxSectionInChunk> m_SectionAllocations;
+    std::array<uint32_t, MaxSectionInChunk>                             m_SectionIndexBufferSize { };
+
+    // Packed quads of a section, relative to the section origin
+    std::vector<DataType::PackedChunkVertex> GenerateSectionVertices( uint32_t sectionIndex, bool keepMeshData );
 
     /*
      *
@@ -168,13 +172,27 @@ protected:
      * */
 
     // return true if quad needed to be flipped for better viewing
-    bool UpdateFacesAmbientOcclusion( FaceVertexAmbientOcclusionData& metaData, std::array<bool, 8> sideTransparency );
-    void UpdateAmbientOcclusionAt( uint32_t index );
-    void UpdateMetaDataAt( uint32_t index );
-    void UpdateNeighborAt( uint32_t index );
-    void RegenerateVisibleFaces( );
+    static bool UpdateFacesAmbientOcclusion( FaceVertexAmbientOcclusionData& metaData, std::array<bool, 8> sideTransparency );
+    static void UpdateAmbientOcclusion( CubeVertexMetaData& metaData, uint32_t neighborTransparency );
+
+    void FillSectionMeshData( uint32_t sectionIndex, SectionMeshData& meshData );
+    void UpdateMeshDataAt( SectionMeshData& meshData, uint32_t index );
 
-    std::array<std::unordered_map<FaceVertexMetaData, GreedyMeshCollection>, CubeDirection::DirSize> GenerateGreedyMesh( );
+    // Patch the cached mesh data of the block's section, if any, after a block within reach changed
+    void UpdateCachedMeshDataAt( uint32_t index );
+    void EraseCachedMeshData( );
+
+    // Empty or buried by opaque sections, no block inside can have a visible face
+    [[nodiscard]] bool IsSectionFaceless( uint32_t sectionIndex ) const;
+
+    /*
+     *
+     * Faces of blocks in [sectionBegin, sectionEnd), quads do not cross the range
+     * Mesh data is indexed from the first block of sectionBegin
+     *
+     * */
+    std::vector<GreedyMeshFace> GenerateGreedyMesh( const uint32_t* neighborTransparency, const CubeVertexMetaData* vertexMetaData,
+                                                    uint32_t sectionBegin = 0, uint32_t sectionEnd = MaxSectionInChunk );
 
 public:
     explicit RenderableChunk( class MinecraftWorld* world )
@@ -186,13 +204,20 @@ public:
     bool initialized  = false;
     bool initializing = false;
 
-    void ResetRenderBuffer( );
+    // Remesh the sections marked dirty, all of them once the surrounding is completed
+    // Runs on remesh workers, use RequestRemesh from anywhere else
     void GenerateRenderBuffer( );
 
+    // Queue GenerateRenderBuffer on ChunkRemeshQueue, requests made before it runs are coalesced
+    void RequestRemesh( );
+
     // return true if target chunk become complete
     std::recursive_mutex m_SyncMutex { };
     bool                 SyncChunkFromDirection( RenderableChunk* other, int fromDir, bool changes = false );
 
+    // Unlink both ways, called once the chunk is unloaded so a chunk loaded again at the same coordinate can take its place
+    void UnlinkNearChunks( );
+
     /*
      *
      * Access tools
@@ -200,30 +225,13 @@ public:
      * */
     bool SetBlock( const BlockCoordinate& blockCoordinate, const Block& block );
 
-    inline auto GetNeighborTransparency( uint32_t index ) const
-    {
-        assert( m_NeighborTransparency != nullptr );
-        return m_NeighborTransparency[ index ];
-    }
-
-    inline const auto& GetCubeVertexMetaData( uint32_t index ) const
-    {
-        assert( m_VertexMetaData != nullptr );
-        return m_VertexMetaData[ index ];
-    }
-
-    inline bool IsCacheReady( ) { return m_NeighborTransparency != nullptr && m_VertexMetaData != nullptr; }
-
-    inline void DeleteCache( )
-    {
-        delete[] m_NeighborTransparency;
-        m_NeighborTransparency = nullptr;
-
-        delete[] m_VertexMetaData;
-        m_VertexMetaData = nullptr;
-
-        m_VisibleFacesCount = 0;
-    }
+    /*
+     *
+     * Mesh data of a single block, computed on call, the surrounding must be completed
+     *
+     * */
+    uint32_t           ComputeNeighborTransparency( uint32_t index );
+    CubeVertexMetaData ComputeCubeVertexMetaData( uint32_t index, uint32_t neighborTransparency );
 
     inline bool     NeighborCompleted( ) const { return m_EmptySlot == 0; }
     inline uint32_t GetIndexBufferSize( ) const { return m_IndexBufferSize; }
@@ -3,6 +3,8 @@
 //
 
 #include "WorldChunk.hpp"
+#include "ChunkPayloadPool.hpp"
+#include "ChunkPool.hpp"
 
 #include <Minecraft/World/Generation/Structure/StructureAbandonedHouse.hpp>
 #include <Minecraft/World/Generation/Structure/StructureTree.hpp>
@@ -10,14 +12,69 @@
 
 #include <Minecraft/Internet/MinecraftServer/MinecraftServer.hpp>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+
 namespace
 {
 inline void
-ResetHeightMap( std::unique_ptr<int32_t[]>& map )
+ResetHeightMap( SlabPoolArray<int32_t>& map )
 {
+    // kept when the chunk is regenerated
+    if ( map == nullptr ) map = MakeSlabPoolArray<int32_t>( ChunkPayloadPool::GetHeightMaps( ), SectionSurfaceSize );
+
     for ( int i = 0; i < SectionSurfaceSize; ++i )
         map[ i ] = -1;
 }
+
+inline bool
+IsNoiseOffsetSaturated( float offset )
+{
+    return offset == -1 || offset == 1;
+}
+
+/*
+ *
+ * Sparse terrain sampling, noise is evaluated every 4x8x4 blocks
+ * Lattice points on chunk border are shared with the neighbour, so chunks stay seamless
+ *
+ * */
+constexpr int SparseCellWidth        = 4;
+constexpr int SparseCellHeight       = 8;
+constexpr int SparseLatticeWidth     = SectionUnitLength / SparseCellWidth + 1;
+constexpr int SparseLatticeHeight    = ChunkMaxHeight / SparseCellHeight + 1;
+constexpr int SparseLatticeLevelSize = SparseLatticeWidth * SparseLatticeWidth;
+static_assert( SectionUnitLength % SparseCellWidth == 0 && ChunkMaxHeight % SparseCellHeight == 0 );
+
+void
+InterpolateSparseLevel( const float* lattice, int level, float* output )
+{
+    const float* lower = lattice + ( level / SparseCellHeight ) * SparseLatticeLevelSize;
+    const float* upper = lower + SparseLatticeLevelSize;
+    const float  ty    = static_cast<float>( level % SparseCellHeight ) / SparseCellHeight;
+
+    // vertical first, then bilinear on the level
+    std::array<float, SparseLatticeLevelSize> levelLattice;
+    for ( int i = 0; i < SparseLatticeLevelSize; ++i )
+        levelLattice[ i ] = std::lerp( lower[ i ], upper[ i ], ty );
+
+    for ( int k = 0; k < SectionUnitLength; ++k )
+    {
+        const float* nearRow = levelLattice.data( ) + ( k / SparseCellWidth ) * SparseLatticeWidth;
+        const float* farRow  = nearRow + SparseLatticeWidth;
+        const float  tz      = static_cast<float>( k % SparseCellWidth ) / SparseCellWidth;
+
+        for ( int j = 0; j < SectionUnitLength; ++j, ++output )
+        {
+            const int   cellX = j / SparseCellWidth;
+            const float tx    = static_cast<float>( j % SparseCellWidth ) / SparseCellWidth;
+
+            *output = std::lerp( std::lerp( nearRow[ cellX ], nearRow[ cellX + 1 ], tx ), std::lerp( farRow[ cellX ], farRow[ cellX + 1 ], tx ), tz );
+        }
+    }
+}
 }   // namespace
 
 void
@@ -33,20 +90,23 @@ WorldChunk::FillTerrain( const MinecraftNoise& generator )
     auto xCoordinate = GetMinecraftX( m_WorldCoordinate );
     auto zCoordinate = GetMinecraftZ( m_WorldCoordinate );
 
-    const auto& noiseOffset = MinecraftServer::GetInstance( ).GetWorld( ).GetTerrainNoiseOffset( );
+    const auto& world          = MinecraftServer::GetInstance( ).GetWorld( );
+    const auto& noiseOffset    = world.GetTerrainNoiseOffset( );
+    const bool  sparseSampling = world.GetTerrainSampling( ) == MinecraftWorld::eSparseTerrainSampling;
 
-    m_HeightMap = std::make_unique<int32_t[]>( SectionSurfaceSize );
     ResetHeightMap( m_HeightMap );
     for ( auto& height : m_StatusHeightMap )
-        ResetHeightMap( height = std::make_unique<int32_t[]>( SectionSurfaceSize ) );
+        ResetHeightMap( height );
 
-    m_Blocks = std::make_unique<Block[]>( ChunkVolume );
+    // Generate uncompressed, then compress into sections once
+    // Every block is written below, so the buffer is reused by each chunk generated on this thread
+    thread_local const auto blocks = std::make_unique<Block[]>( ChunkVolume );
 
 #if GENERATE_DEBUG_CHUNK
 
     // the following code are for debug purpose
     for ( int i = 0; i < ChunkVolume; ++i )
-        m_Blocks[ i ] = BlockID::Air;
+        blocks[ i ] = BlockID::Air;
 
     if ( ManhattanDistance( { 0, 0 } ) == 0 )
     {
@@ -59,33 +119,63 @@ WorldChunk::FillTerrain( const MinecraftNoise& generator )
 
                     } else
                     {
-                        m_Blocks[ Chunk::GetBlockIndex( MakeMinecraftCoordinate( i, k, j ) ) ] = BlockID::DebugBlock;
+                        blocks[ Chunk::GetBlockIndex( MakeMinecraftCoordinate( i, k, j ) ) ] = BlockID::DebugBlock;
                     }
                 }
     }
 
-
+    LoadBlocks( blocks.get( ) );
     return;
 
 #endif
 
     // terrain
-    auto*    blocksPtr          = m_Blocks.get( );
+    auto*    blocksPtr          = blocks.get( );
     uint32_t horizontalMapIndex = 0;
+
+    // Lattice level is only sampled if any level in the cell above or below is not saturated, others are never read
+    std::array<float, SparseLatticeHeight * SparseLatticeLevelSize> sparseLattice;
+    if ( sparseSampling )
+    {
+        for ( int latticeY = 0; latticeY < SparseLatticeHeight; ++latticeY )
+        {
+            bool required = false;
+            for ( int i = std::max( 0, ( latticeY - 1 ) * SparseCellHeight ); !required && i < std::min( ChunkMaxHeight, ( latticeY + 1 ) * SparseCellHeight ); ++i )
+                required = !IsNoiseOffsetSaturated( noiseOffset[ i ] );
+
+            if ( !required ) continue;
+
+            auto* latticePtr = sparseLattice.data( ) + latticeY * SparseLatticeLevelSize;
+            for ( int latticeZ = 0; latticeZ < SparseLatticeWidth; ++latticeZ )
+                for ( int latticeX = 0; latticeX < SparseLatticeWidth; ++latticeX )
+                    *latticePtr++ = generator.GetNoiseInt( xCoordinate + latticeX * SparseCellWidth, latticeY * SparseCellHeight, zCoordinate + latticeZ * SparseCellWidth );
+        }
+    }
+
+    std::array<float, SectionSurfaceSize> levelNoise;
     for ( int i = 0; i < ChunkMaxHeight; ++i )
     {
+        const bool saturated = IsNoiseOffsetSaturated( noiseOffset[ i ] );
+        if ( !saturated )
+        {
+            if ( sparseSampling )
+                InterpolateSparseLevel( sparseLattice.data( ), i, levelNoise.data( ) );
+            else
+                generator.FillNoiseGrid( levelNoise.data( ), xCoordinate, i, zCoordinate, SectionUnitLength, 1, SectionUnitLength );
+        }
+
         horizontalMapIndex = 0;
         for ( int k = 0; k < SectionUnitLength; ++k )
             for ( int j = 0; j < SectionUnitLength; ++j, ++horizontalMapIndex )
             {
                 auto noiseValue = noiseOffset[ i ];
 
-                if ( noiseValue != -1 && noiseValue != 1 )
+                if ( !saturated )
                 {
-                    noiseValue += generator.GetNoiseInt( xCoordinate + j, i, zCoordinate + k );
+                    noiseValue += levelNoise[ horizontalMapIndex ];
                 }
 
-                assert( blocksPtr + horizontalMapIndex - m_Blocks.get( ) < ChunkVolume );
+                assert( blocksPtr + horizontalMapIndex - blocks.get( ) < ChunkVolume );
                 blocksPtr[ horizontalMapIndex ] = noiseValue > 0 ? BlockID::Air : BlockID::Stone;
                 if ( !blocksPtr[ horizontalMapIndex ].Transparent( ) ) m_HeightMap[ horizontalMapIndex ] = i;
             }
@@ -94,14 +184,14 @@ WorldChunk::FillTerrain( const MinecraftNoise& generator )
     }
 
     // surface block
-    blocksPtr = m_Blocks.get( );
+    blocksPtr = blocks.get( );
     for ( int i = 0; i < ChunkMaxHeight; ++i )
     {
         horizontalMapIndex = 0;
         for ( int k = 0; k < SectionUnitLength; ++k )
             for ( int j = 0; j < SectionUnitLength; ++j, ++horizontalMapIndex )
             {
-                assert( blocksPtr + horizontalMapIndex - m_Blocks.get( ) < ChunkVolume );
+                assert( blocksPtr + horizontalMapIndex - blocks.get( ) < ChunkVolume );
 
                 if ( i > m_HeightMap[ horizontalMapIndex ] - 3 )
                 {
@@ -127,6 +217,8 @@ WorldChunk::FillTerrain( const MinecraftNoise& generator )
 
         blocksPtr += SectionSurfaceSize;
     }
+
+    LoadBlocks( blocks.get( ) );
 }
 
 void
@@ -135,7 +227,7 @@ WorldChunk::FillBedRock( const MinecraftNoise& generator )
     auto xCoordinate = GetMinecraftX( m_WorldCoordinate );
     auto zCoordinate = GetMinecraftZ( m_WorldCoordinate );
 
-    auto blackRockHeightMap = std::make_unique<int[]>( SectionSurfaceSize );
+    std::array<int, SectionSurfaceSize> blackRockHeightMap;
 
     int horizontalMapIndex = 0;
     for ( int k = 0; k < SectionUnitLength; ++k )
@@ -146,7 +238,7 @@ WorldChunk::FillBedRock( const MinecraftNoise& generator )
             blackRockHeightMap[ horizontalMapIndex ] = static_cast<int>( noiseValue * 2 + 1 );
 
             for ( int i = 0; i < blackRockHeightMap[ horizontalMapIndex ]; ++i )
-                At( horizontalMapIndex + SectionSurfaceSize * i ) = BlockID ::BedRock;
+                StoreBlock( horizontalMapIndex + SectionSurfaceSize * i, BlockID ::BedRock );
 
             ++horizontalMapIndex;
         }
@@ -157,12 +249,16 @@ WorldChunk::UpgradeChunk( ChunkStatus targetStatus )
 {
     assert( targetStatus <= ChunkStatus::eFull );
 
-    // already fulfilled
-    if ( targetStatus <= m_Status ) return;
-
-    for ( ; !IsChunkStatusAtLeast( targetStatus ); ++m_Status )
+    // only this job writes the status while it runs
+    const auto scheduledStatus = m_Status.load( std::memory_order_relaxed );
+    for ( auto status = scheduledStatus; status < targetStatus; ++status )
     {
-        switch ( m_Status )
+        // ChunkPool only resolved the dependency of the first stage, later ones wait for it to reschedule the chunk
+        if ( status != scheduledStatus && GetUpgradeDependency( status ).range != 0 ) return;
+
+        const auto startTime = std::chrono::steady_clock::now( );
+
+        switch ( status )
         {
         case eEmpty:
             if ( !AttemptCompleteStatus<eStructureStart>( ) ) return;
@@ -180,6 +276,13 @@ WorldChunk::UpgradeChunk( ChunkStatus targetStatus )
             break;
         case eFeature: break;
         }
+
+        // Published after the writes of the stage, readers acquire it before touching this chunk's data
+        const auto completedStatus = status + 1;
+        m_Status.store( completedStatus, std::memory_order_release );
+
+        Statistics.completed[ completedStatus ].fetch_add( 1, std::memory_order_relaxed );
+        Statistics.nanoseconds[ completedStatus ].fetch_add( std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now( ) - startTime ).count( ), std::memory_order_relaxed );
     }
 }
 
@@ -191,26 +294,23 @@ WorldChunk::SetCoordinate( const ChunkCoordinate& coordinate )
     m_ChunkNoise = GenerateChunkNoise( *MinecraftServer::GetInstance( ).GetWorld( ).GetTerrainNoise( ) );
 }
 
-std::weak_ptr<WorldChunk>&
+WorldChunk*
 WorldChunk::GetChunkReference( uint32_t index, const ChunkCoordinate& worldCoordinate )
 {
-    if ( auto& chunkPtr = m_ChunkReferencesSaves[ index ]; !chunkPtr.expired( ) )
+    if ( auto* chunk = TryGetChunkReference( index ); chunk != nullptr )
     {
-        return chunkPtr;
+        return chunk;
     }
 
-    return m_ChunkReferencesSaves[ index ] = m_World->GetChunkCacheUnsafe( worldCoordinate );
+    auto* chunk                     = m_World->GetChunkCacheSafe( worldCoordinate );
+    m_ChunkReferencesSaves[ index ] = chunk != nullptr ? chunk->GetHandle( ) : ChunkHandle { };
+    return chunk;
 }
 
-std::weak_ptr<WorldChunk>
+WorldChunk*
 WorldChunk::TryGetChunkReference( uint32_t index ) const
 {
-    if ( auto& chunkPtr = m_ChunkReferencesSaves[ index ]; !chunkPtr.expired( ) )
-    {
-        return chunkPtr;
-    }
-
-    return { };
+    return m_World->GetChunkPool( ).ResolveChunk( m_ChunkReferencesSaves[ index ] );
 }
 
 bool
@@ -218,51 +318,28 @@ WorldChunk::UpgradeStatusAtLeastInRange( ChunkStatus targetStatus, int range )
 {
     assert( range <= ChunkReferenceRange );
 
-    std::vector<ChunkCoordinate> missingChunk;
-
-    {
-        for ( int dz = -range; dz <= range; ++dz )
-            for ( int dx = -range; dx <= range; ++dx )
-            {
-                const auto chunkCoordinate = m_Coordinate + MakeMinecraftChunkCoordinate( dx, dz );
-                if ( auto chunkCache = GetChunkReference( GetRefIndexFromCenter( dx, dz ), chunkCoordinate );
-                     chunkCache.expired( ) || !chunkCache.lock( )->IsChunkStatusAtLeast( targetStatus ) )
-                    missingChunk.push_back( chunkCoordinate );
-            }
-    }
-
-    for ( const auto& chunkCoordinate : missingChunk )
-    {
-        auto& oldTarget = m_MissingEssentialChunks[ chunkCoordinate ];
-        oldTarget       = std::max( oldTarget, (ChunkStatusTy) targetStatus );
-    }
-
-    return missingChunk.empty( );
-}
-
-bool
-WorldChunk::IsSavedChunksStatusAtLeastInRange( ChunkStatus targetStatus, int range ) const
-{
-    assert( range <= ChunkReferenceRange );
-
+    // missing chunks are introduced by ChunkPool when the job is rescheduled
     for ( int dz = -range; dz <= range; ++dz )
         for ( int dx = -range; dx <= range; ++dx )
-            if ( auto chunkCache = TryGetChunkReference( GetRefIndexFromCenter( dx, dz ) );
-                 !chunkCache.expired( ) && !chunkCache.lock( )->IsChunkStatusAtLeast( targetStatus ) ) return false;
-
+        {
+            const auto chunkCoordinate = m_Coordinate + MakeMinecraftChunkCoordinate( dx, dz );
+            if ( auto* chunkCache = GetChunkReference( GetRefIndexFromCenter( dx, dz ), chunkCoordinate );
+                 chunkCache == nullptr || !chunkCache->IsChunkStatusAtLeast( targetStatus ) )
+                return false;
+        }
 
     return true;
 }
 
-std::vector<std::weak_ptr<WorldChunk>>
+std::vector<ChunkHandle>
 WorldChunk::GetChunkRefInRange( int range ) const
 {
     assert( range <= ChunkReferenceRange );
 
-    std::vector<std::weak_ptr<WorldChunk>> chunks;
+    std::vector<ChunkHandle> chunks;
     for ( int dz = -range; dz <= range; ++dz )
         for ( int dx = -range; dx <= range; ++dx )
-            chunks.push_back( TryGetChunkReference( GetRefIndexFromCenter( dx, dz ) ) );
+            chunks.push_back( m_ChunkReferencesSaves[ GetRefIndexFromCenter( dx, dz ) ] );
 
     return chunks;
 }
@@ -273,37 +350,26 @@ WorldChunk::GetHeight( uint32_t index, HeightMapStatus status ) const
     return m_StatusHeightMap[ status ][ index ];
 }
 
-bool
-WorldChunk::StatusUpgradeAllSatisfied( ) const
+void*
+WorldChunk::operator new( size_t size )
 {
-    assert( m_RequiredStatus <= ChunkStatus::eFull );
-
-    // already fulfilled
-    if ( m_RequiredStatus <= m_Status ) return true;
-
-    auto temStatus = m_Status;
-    while ( temStatus < m_RequiredStatus && UpgradeSatisfied( temStatus++ ) )
-    { }
-
-    return temStatus == m_RequiredStatus;
+    // a derived type of another size is not pooled
+    if ( size != sizeof( WorldChunk ) ) return ::operator new( size );
+    return ChunkPayloadPool::GetChunkObjects( sizeof( WorldChunk ), alignof( WorldChunk ) ).Allocate( );
 }
 
-bool
-WorldChunk::NextStatusUpgradeSatisfied( ) const
+void
+WorldChunk::operator delete( void* chunk, size_t size )
 {
-    assert( m_RequiredStatus <= ChunkStatus::eFull );
-
-    // already fulfilled
-    if ( m_RequiredStatus <= m_Status ) return true;
-
-    return UpgradeSatisfied( m_Status );
+    if ( size != sizeof( WorldChunk ) ) return ::operator delete( chunk );
+    ChunkPayloadPool::GetChunkObjects( sizeof( WorldChunk ), alignof( WorldChunk ) ).Free( chunk );
 }
 
 size_t
 WorldChunk::GetObjectSize( ) const
 {
 
-    size_t result = RenderableChunk::GetObjectSize( ) + sizeof( WorldChunk ) + m_RequiredBy.capacity( ) * sizeof( m_RequiredBy[ 0 ] ) + m_StructureStarts.capacity( ) * sizeof( m_StructureStarts[ 0 ] ) + m_StructureReferences.size( ) * sizeof( m_StructureReferences.front( ) );
+    size_t result = RenderableChunk::GetObjectSize( ) + sizeof( WorldChunk ) + m_StructureStarts.capacity( ) * sizeof( m_StructureStarts[ 0 ] ) + m_StructureReferences.size( ) * sizeof( m_StructureReferences.front( ) );
 
     for ( const auto& ss : m_StructureStarts )
         result += ss->GetObjectSize( );
@@ -7,24 +7,26 @@
 
 #define GENERATE_DEBUG_CHUNK false
 
+#include <atomic>
 #include <list>
 #include <vector>
 
+#include "ChunkSlotTable.hpp"
 #include "RenderableChunk.hpp"
 
 class WorldChunk : public RenderableChunk
 {
 private:
-    std::unordered_map<ChunkCoordinate, ChunkStatusTy> m_MissingEssentialChunks;
-
     MinecraftNoise m_ChunkNoise;
 
     // TODO: to not use shared & weak ptr
     std::vector<std::shared_ptr<Structure>> m_StructureStarts;
     std::list<std::weak_ptr<Structure>>     m_StructureReferences;
 
-    ChunkStatus                                             m_Status = ChunkStatus::eEmpty;
-    std::array<std::unique_ptr<int32_t[]>, eFullHeight + 1> m_StatusHeightMap { };
+    // Written by the job upgrading the chunk, once the writes of the completed status are done
+    // Other workers and the update thread read it, an acquire load also makes those writes visible
+    std::atomic<ChunkStatus>                            m_Status { ChunkStatus::eEmpty };
+    std::array<SlabPoolArray<int32_t>, eFullHeight + 1> m_StatusHeightMap { };
 
     inline void CopyHeightMapTo( HeightMapStatus status )
     {
@@ -33,7 +35,7 @@ private:
 
     inline void ResetChunk( )
     {
-        m_Status = ChunkStatus::eEmpty;
+        m_Status.store( ChunkStatus::eEmpty, std::memory_order_release );
 
         m_StructureStarts.clear( );
         m_StructureReferences.clear( );
@@ -41,18 +43,13 @@ private:
 
     // return true if all chunk are upgraded
     bool UpgradeStatusAtLeastInRange( ChunkStatus targetStatus, int range );
-    bool IsSavedChunksStatusAtLeastInRange( ChunkStatus targetStatus, int range ) const;
 
+    // Stops before any later stage that has a dependency
     void UpgradeChunk( ChunkStatus targetStatus );
 
-    template <ChunkStatus status>
-    [[nodiscard]] inline bool StatusCompletable( ) const;
-
     template <ChunkStatus status>
     inline bool AttemptCompleteStatus( );
 
-    inline bool UpgradeSatisfied( ChunkStatus status ) const;
-
     /*
      *
      * Generation
@@ -64,56 +61,48 @@ private:
     /*
      *
      * Return and update the chunk reference
+     * Chunks returned are only valid inside an EpochGuard, chunk jobs run inside one
      *
      * */
-    static inline int                                    GetRefIndexFromCenter( int dx, int dy ) { return ChunkReferenceRange * ( StructureReferenceStatusRange + dy ) + StructureReferenceStatusRange + dx; }
-    std::weak_ptr<WorldChunk>                            TryGetChunkReference( uint32_t index ) const;
-    std::weak_ptr<WorldChunk>&                           GetChunkReference( uint32_t index, const ChunkCoordinate& worldCoordinate );
-    [[nodiscard]] std::vector<std::weak_ptr<WorldChunk>> GetChunkRefInRange( int range ) const;
+    static inline int                      GetRefIndexFromCenter( int dx, int dy ) { return ChunkReferenceRange * ( StructureReferenceStatusRange + dy ) + StructureReferenceStatusRange + dx; }
+    WorldChunk*                            TryGetChunkReference( uint32_t index ) const;
+    WorldChunk*                            GetChunkReference( uint32_t index, const ChunkCoordinate& worldCoordinate );
+    [[nodiscard]] std::vector<ChunkHandle> GetChunkRefInRange( int range ) const;
 
     /*
      *
      * Generation dependencies
      *
      * */
-    ChunkStatus                            m_RequiredStatus = ChunkStatus::eFull;
-    uint32_t                               m_EmergencyLevel = std::numeric_limits<uint32_t>::max( );
-    std::vector<std::weak_ptr<WorldChunk>> m_RequiredBy;
+    std::atomic<ChunkStatus> m_RequiredStatus { ChunkStatus::eFull };
 
-    static constexpr auto                                     ChunkReferenceRange = StructureReferenceStatusRange * 2 + 1;
-    static constexpr auto                                     ChunkReferenceSize  = ChunkReferenceRange * ChunkReferenceRange;
-    std::array<std::weak_ptr<WorldChunk>, ChunkReferenceSize> m_ChunkReferencesSaves;
+    // Own slot in the ChunkPool slot table
+    ChunkHandle m_Handle;
+
+    static constexpr auto                       ChunkReferenceRange = StructureReferenceStatusRange * 2 + 1;
+    static constexpr auto                       ChunkReferenceSize  = ChunkReferenceRange * ChunkReferenceRange;
+    std::array<ChunkHandle, ChunkReferenceSize> m_ChunkReferencesSaves { };
 
 public:
     explicit WorldChunk( class MinecraftWorld* world )
         : RenderableChunk( world )
     { }
 
+    // Chunk objects are recycled through ChunkPayloadPool instead of the global heap
+    static void* operator new( size_t size );
+    static void  operator delete( void* chunk, size_t size );
+
     void        RegenerateChunk( ChunkStatus status );
-    inline void TryUpgradeChunk( ) { UpgradeChunk( m_RequiredStatus ); }
+    inline void TryUpgradeChunk( ) { UpgradeChunk( GetTargetStatus( ) ); }
 
     void SetCoordinate( const ChunkCoordinate& coordinate );
 
     CoordinateType GetHeight( uint32_t index, HeightMapStatus status = eFullHeight ) const;
 
-    inline void SetExpectedStatus( ChunkStatus status ) { m_RequiredStatus = status; }
-    inline void SetEmergencyLevel( uint32_t newEmergencyLevel ) { m_EmergencyLevel = newEmergencyLevel; }
+    inline void SetExpectedStatus( ChunkStatus status ) { m_RequiredStatus.store( status, std::memory_order_relaxed ); }
 
-    /*
-     *
-     * The lower, the more emergent
-     *
-     * */
-    inline uint32_t GetEmergencyLevel( ) const
-    {
-        uint32_t emergencyLevel = m_EmergencyLevel;
-        for ( auto& parent : m_RequiredBy )
-            // chunk has not been deleted for whatever reason
-            if ( !parent.expired( ) )
-                emergencyLevel = std::min( emergencyLevel, parent.lock( )->GetEmergencyLevel( ) + 1 );
-
-        return emergencyLevel;
-    }
+    inline void               SetHandle( ChunkHandle handle ) { m_Handle = handle; }
+    inline const ChunkHandle& GetHandle( ) const { return m_Handle; }
 
     inline const auto& GetStructureStarts( ) const { return m_StructureStarts; }
 
@@ -131,22 +120,44 @@ public:
         return MinecraftNoise { noiseSeed };
     }
 
-    bool StatusUpgradeAllSatisfied( ) const;
-    bool NextStatusUpgradeSatisfied( ) const;
+    struct StatusDependency {
+        ChunkStatus status;   // minimum status of every chunk in range
+        int         range;    // 0 if upgrading has no dependency
+    };
 
-    inline const auto& GetStatus( ) const { return m_Status; }
-    inline const auto& GetTargetStatus( ) const { return m_RequiredStatus; }
-    inline const bool  IsAtLeastTargetStatus( ) const { return GetTargetStatus( ) <= m_Status; }
-    inline bool        IsChunkStatusAtLeast( ChunkStatus status ) const { return m_Status >= status; }
-
-    inline auto ExtractMissingEssentialChunks( )
+    /*
+     *
+     * What surrounding chunks need before upgrading from status, must agree with the range checks in AttemptCompleteStatus
+     *
+     * */
+    static constexpr StatusDependency GetUpgradeDependency( ChunkStatus status )
     {
-        auto backup = m_MissingEssentialChunks;
-        m_MissingEssentialChunks.clear( );
-        return backup;
+        switch ( status )
+        {
+        case eStructureStart: return { eStructureStart, StructureReferenceStatusRange };
+        case eNoise: return { eNoise, FeatureStatusRange };
+        default: return { eEmpty, 0 };
+        }
     }
 
+    inline ChunkStatus GetStatus( ) const { return m_Status.load( std::memory_order_acquire ); }
+    inline ChunkStatus GetTargetStatus( ) const { return m_RequiredStatus.load( std::memory_order_relaxed ); }
+    inline bool        IsAtLeastTargetStatus( ) const { return GetTargetStatus( ) <= GetStatus( ); }
+    inline bool        IsChunkStatusAtLeast( ChunkStatus status ) const { return GetStatus( ) >= status; }
+
     size_t GetObjectSize( ) const;
+
+    /*
+     *
+     * Accumulated over all chunks, indexed by the status completed
+     *
+     * */
+    struct GenerationStatistics {
+        std::array<std::atomic<uint64_t>, ChunkStatusSize> completed { };
+        std::array<std::atomic<uint64_t>, ChunkStatusSize> nanoseconds { };
+    };
+
+    static inline GenerationStatistics Statistics { };
 };
 
 #include "WorldChunk_Impl.hpp"
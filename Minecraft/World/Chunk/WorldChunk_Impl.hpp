@@ -9,34 +9,6 @@
 #include <Minecraft/World/Biome/BiomeSettings.hpp>
 #include <Minecraft/World/MinecraftWorld.hpp>
 
-template <>
-inline bool
-WorldChunk::StatusCompletable<eStructureStart>( ) const
-{
-    return true;
-}
-
-template <>
-inline bool
-WorldChunk::StatusCompletable<eStructureReference>( ) const
-{
-    return IsSavedChunksStatusAtLeastInRange( ChunkStatus::eStructureStart, StructureReferenceStatusRange );
-}
-
-template <>
-inline bool
-WorldChunk::StatusCompletable<eNoise>( ) const
-{
-    return true;
-}
-
-template <>
-inline bool
-WorldChunk::StatusCompletable<eFeature>( ) const
-{
-    return IsSavedChunksStatusAtLeastInRange( ChunkStatus::eNoise, FeatureStatusRange );
-}
-
 template <>
 inline bool
 WorldChunk::AttemptCompleteStatus<eStructureStart>( )
@@ -57,15 +29,20 @@ WorldChunk::AttemptCompleteStatus<eStructureReference>( )
     if ( !UpgradeStatusAtLeastInRange( ChunkStatus::eStructureStart, StructureReferenceStatusRange ) ) return false;
 
     {
-        // chunk cache will not be modified until all thread has finished, mutex can be avoided
-        // std::lock_guard<std::recursive_mutex> lock( m_World->GetChunkPool( ).GetChunkCacheLock( ) );
+        // chunk cache can be modified while this job is running, chunks resolved stay alive until the job leaves its EpochGuard
         for ( int index = 0, dx = -StructureReferenceStatusRange; dx <= StructureReferenceStatusRange; ++dx )
         {
             for ( int dz = -StructureReferenceStatusRange; dz <= StructureReferenceStatusRange; ++dz, ++index )
             {
-                const auto                  worldCoordinate = m_Coordinate + MakeMinecraftChunkCoordinate( dx, dz );
-                const auto                  weakChunkCache  = GetChunkReference( index, worldCoordinate );
-                std::shared_ptr<WorldChunk> chunkCache      = weakChunkCache.lock( );
+                const auto  worldCoordinate = m_Coordinate + MakeMinecraftChunkCoordinate( dx, dz );
+                const auto* chunkCache      = GetChunkReference( index, worldCoordinate );
+
+                // removed after the range check, retry later
+                if ( chunkCache == nullptr )
+                {
+                    m_StructureReferences.clear( );
+                    return false;
+                }
 
                 const auto& chunkReferenceStarts = chunkCache->GetStructureStarts( );
                 // m_StructureReferences.reserve( m_StructureReferences.size( ) + chunkReferenceStarts.size( ) );
@@ -125,20 +102,4 @@ WorldChunk::AttemptCompleteStatus<eFeature>( )
     return true;
 }
 
-
-inline bool
-WorldChunk::UpgradeSatisfied( ChunkStatus status ) const
-{
-    switch ( m_Status )
-    {
-    case eEmpty: return StatusCompletable<eStructureStart>( );
-    case eStructureStart: return StatusCompletable<eStructureReference>( );
-    case eStructureReference: return StatusCompletable<eNoise>( );
-    case eNoise: return StatusCompletable<eFeature>( );
-    case eFeature: return true;   // ???
-    }
-
-    throw std::runtime_error( "Unknown chunk status: " + std::to_string( status ) );
-}
-
 #endif   // MINECRAFT_VK_WORLDCHUNK_IMPL_HPP
\ No newline at end of file
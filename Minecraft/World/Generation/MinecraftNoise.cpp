@@ -3,3 +3,402 @@
 //
 
 #include "MinecraftNoise.hpp"
+
+#include <algorithm>
+
+#if defined( __x86_64__ ) || defined( _M_X64 ) || defined( __i386__ ) || defined( _M_IX86 )
+#    define MINECRAFT_NOISE_X86 1
+#    include <immintrin.h>
+#    if defined( _MSC_VER ) && !defined( __clang__ )
+#        include <intrin.h>
+#        define NOISE_TARGET( ISA )
+#    else
+#        define NOISE_TARGET( ISA ) __attribute__( ( target( ISA ) ) )
+#    endif
+#else
+#    define MINECRAFT_NOISE_X86 0
+#endif
+
+namespace
+{
+
+constexpr int   GridPrimeX       = 501125321;
+constexpr int   GridPrimeY       = 1136930381;
+constexpr int   GridPrimeZ       = 1720413743;
+constexpr int   GridHashMask     = 63 << 2;
+constexpr int   GridHashMultiply = 0x27d4eb2d;
+constexpr float GridPerlinScale  = 0.964921414852142333984375f;
+
+struct GridParameter {
+    int          seed;
+    int          octaves;
+    bool         fractal;
+    float        frequency;
+    float        lacunarity;
+    float        gain;
+    float        weightedStrength;
+    float        fractalBounding;
+    const float* gradients;
+};
+
+#if MINECRAFT_NOISE_X86
+
+/*
+ *
+ * Every lane follow FastNoiseLite::GenFractalFBm / SinglePerlin operation by operation,
+ * multiply and add are never fused so the result round exactly like the scalar path
+ *
+ * */
+
+/*
+ *
+ * AVX2, 8 lanes
+ *
+ * */
+NOISE_TARGET( "avx2" ) inline __m256
+LerpAVX2( __m256 a, __m256 b, __m256 t )
+{
+    return _mm256_add_ps( a, _mm256_mul_ps( t, _mm256_sub_ps( b, a ) ) );
+}
+
+NOISE_TARGET( "avx2" ) inline __m256
+InterpQuinticAVX2( __m256 t )
+{
+    const __m256 cubic = _mm256_mul_ps( _mm256_mul_ps( t, t ), t );
+    const __m256 inner = _mm256_add_ps( _mm256_mul_ps( t, _mm256_sub_ps( _mm256_mul_ps( t, _mm256_set1_ps( 6 ) ), _mm256_set1_ps( 15 ) ) ), _mm256_set1_ps( 10 ) );
+    return _mm256_mul_ps( cubic, inner );
+}
+
+NOISE_TARGET( "avx2" ) inline __m256i
+FastFloorAVX2( __m256 f )
+{
+    // f >= 0 ? (int) f : (int) f - 1, mask is -1 where f is not >= 0
+    const __m256i notPositive = _mm256_castps_si256( _mm256_cmp_ps( f, _mm256_setzero_ps( ), _CMP_NGE_UQ ) );
+    return _mm256_add_epi32( _mm256_cvttps_epi32( f ), notPositive );
+}
+
+NOISE_TARGET( "avx2" ) inline __m256
+GradCoordAVX2( const float* gradients, __m256i seed, __m256i xPrimed, __m256i yPrimed, __m256i zPrimed, __m256 xd, __m256 yd, __m256 zd )
+{
+    __m256i hash = _mm256_xor_si256( _mm256_xor_si256( seed, xPrimed ), _mm256_xor_si256( yPrimed, zPrimed ) );
+    hash         = _mm256_mullo_epi32( hash, _mm256_set1_epi32( GridHashMultiply ) );
+    hash         = _mm256_xor_si256( hash, _mm256_srai_epi32( hash, 15 ) );
+    hash         = _mm256_and_si256( hash, _mm256_set1_epi32( GridHashMask ) );
+
+    const __m256 xg = _mm256_i32gather_ps( gradients, hash, 4 );
+    const __m256 yg = _mm256_i32gather_ps( gradients + 1, hash, 4 );
+    const __m256 zg = _mm256_i32gather_ps( gradients + 2, hash, 4 );
+
+    return _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( xd, xg ), _mm256_mul_ps( yd, yg ) ), _mm256_mul_ps( zd, zg ) );
+}
+
+NOISE_TARGET( "avx2" ) inline __m256
+SinglePerlinAVX2( const float* gradients, int seed, __m256 x, __m256 y, __m256 z )
+{
+    __m256i x0 = FastFloorAVX2( x );
+    __m256i y0 = FastFloorAVX2( y );
+    __m256i z0 = FastFloorAVX2( z );
+
+    const __m256 one = _mm256_set1_ps( 1 );
+    const __m256 xd0 = _mm256_sub_ps( x, _mm256_cvtepi32_ps( x0 ) );
+    const __m256 yd0 = _mm256_sub_ps( y, _mm256_cvtepi32_ps( y0 ) );
+    const __m256 zd0 = _mm256_sub_ps( z, _mm256_cvtepi32_ps( z0 ) );
+    const __m256 xd1 = _mm256_sub_ps( xd0, one );
+    const __m256 yd1 = _mm256_sub_ps( yd0, one );
+    const __m256 zd1 = _mm256_sub_ps( zd0, one );
+
+    const __m256 xs = InterpQuinticAVX2( xd0 );
+    const __m256 ys = InterpQuinticAVX2( yd0 );
+    const __m256 zs = InterpQuinticAVX2( zd0 );
+
+    x0               = _mm256_mullo_epi32( x0, _mm256_set1_epi32( GridPrimeX ) );
+    y0               = _mm256_mullo_epi32( y0, _mm256_set1_epi32( GridPrimeY ) );
+    z0               = _mm256_mullo_epi32( z0, _mm256_set1_epi32( GridPrimeZ ) );
+    const __m256i x1 = _mm256_add_epi32( x0, _mm256_set1_epi32( GridPrimeX ) );
+    const __m256i y1 = _mm256_add_epi32( y0, _mm256_set1_epi32( GridPrimeY ) );
+    const __m256i z1 = _mm256_add_epi32( z0, _mm256_set1_epi32( GridPrimeZ ) );
+
+    const __m256i seeds = _mm256_set1_epi32( seed );
+
+    const __m256 xf00 = LerpAVX2( GradCoordAVX2( gradients, seeds, x0, y0, z0, xd0, yd0, zd0 ), GradCoordAVX2( gradients, seeds, x1, y0, z0, xd1, yd0, zd0 ), xs );
+    const __m256 xf10 = LerpAVX2( GradCoordAVX2( gradients, seeds, x0, y1, z0, xd0, yd1, zd0 ), GradCoordAVX2( gradients, seeds, x1, y1, z0, xd1, yd1, zd0 ), xs );
+    const __m256 xf01 = LerpAVX2( GradCoordAVX2( gradients, seeds, x0, y0, z1, xd0, yd0, zd1 ), GradCoordAVX2( gradients, seeds, x1, y0, z1, xd1, yd0, zd1 ), xs );
+    const __m256 xf11 = LerpAVX2( GradCoordAVX2( gradients, seeds, x0, y1, z1, xd0, yd1, zd1 ), GradCoordAVX2( gradients, seeds, x1, y1, z1, xd1, yd1, zd1 ), xs );
+
+    const __m256 yf0 = LerpAVX2( xf00, xf10, ys );
+    const __m256 yf1 = LerpAVX2( xf01, xf11, ys );
+
+    return _mm256_mul_ps( LerpAVX2( yf0, yf1, zs ), _mm256_set1_ps( GridPerlinScale ) );
+}
+
+// Return number of element filled, always multiple of 8
+NOISE_TARGET( "avx2" ) int32_t
+FillRowAVX2( const GridParameter& parameter, float* output, int32_t x, int32_t y, int32_t z, int32_t count )
+{
+    const __m256  frequency = _mm256_set1_ps( parameter.frequency );
+    const __m256i laneIndex = _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7 );
+    const __m256  yf        = _mm256_mul_ps( _mm256_set1_ps( (float) y ), frequency );
+    const __m256  zf        = _mm256_mul_ps( _mm256_set1_ps( (float) z ), frequency );
+
+    int32_t filled = 0;
+    for ( ; filled + 8 <= count; filled += 8 )
+    {
+        __m256 xs = _mm256_cvtepi32_ps( _mm256_add_epi32( _mm256_set1_epi32( x + filled ), laneIndex ) );
+        __m256 ys = yf;
+        __m256 zs = zf;
+        xs        = _mm256_mul_ps( xs, frequency );
+
+        if ( !parameter.fractal )
+        {
+            _mm256_storeu_ps( output + filled, SinglePerlinAVX2( parameter.gradients, parameter.seed, xs, ys, zs ) );
+            continue;
+        }
+
+        int    seed = parameter.seed;
+        __m256 sum  = _mm256_setzero_ps( );
+        __m256 amp  = _mm256_set1_ps( parameter.fractalBounding );
+
+        for ( int i = 0; i < parameter.octaves; i++ )
+        {
+            const __m256 noise = SinglePerlinAVX2( parameter.gradients, seed++, xs, ys, zs );
+            sum                = _mm256_add_ps( sum, _mm256_mul_ps( noise, amp ) );
+            amp                = _mm256_mul_ps( amp, LerpAVX2( _mm256_set1_ps( 1 ), _mm256_mul_ps( _mm256_add_ps( noise, _mm256_set1_ps( 1 ) ), _mm256_set1_ps( 0.5f ) ), _mm256_set1_ps( parameter.weightedStrength ) ) );
+
+            xs  = _mm256_mul_ps( xs, _mm256_set1_ps( parameter.lacunarity ) );
+            ys  = _mm256_mul_ps( ys, _mm256_set1_ps( parameter.lacunarity ) );
+            zs  = _mm256_mul_ps( zs, _mm256_set1_ps( parameter.lacunarity ) );
+            amp = _mm256_mul_ps( amp, _mm256_set1_ps( parameter.gain ) );
+        }
+
+        _mm256_storeu_ps( output + filled, sum );
+    }
+
+    return filled;
+}
+
+/*
+ *
+ * SSE4.1, 4 lanes, no gather
+ *
+ * */
+NOISE_TARGET( "sse4.1" ) inline __m128
+LerpSSE41( __m128 a, __m128 b, __m128 t )
+{
+    return _mm_add_ps( a, _mm_mul_ps( t, _mm_sub_ps( b, a ) ) );
+}
+
+NOISE_TARGET( "sse4.1" ) inline __m128
+InterpQuinticSSE41( __m128 t )
+{
+    const __m128 cubic = _mm_mul_ps( _mm_mul_ps( t, t ), t );
+    const __m128 inner = _mm_add_ps( _mm_mul_ps( t, _mm_sub_ps( _mm_mul_ps( t, _mm_set1_ps( 6 ) ), _mm_set1_ps( 15 ) ) ), _mm_set1_ps( 10 ) );
+    return _mm_mul_ps( cubic, inner );
+}
+
+NOISE_TARGET( "sse4.1" ) inline __m128i
+FastFloorSSE41( __m128 f )
+{
+    const __m128i notPositive = _mm_castps_si128( _mm_cmpnge_ps( f, _mm_setzero_ps( ) ) );
+    return _mm_add_epi32( _mm_cvttps_epi32( f ), notPositive );
+}
+
+NOISE_TARGET( "sse4.1" ) inline __m128
+GatherSSE41( const float* base, __m128i index )
+{
+    alignas( 16 ) int32_t indices[ 4 ];
+    _mm_store_si128( reinterpret_cast<__m128i*>( indices ), index );
+    return _mm_setr_ps( base[ indices[ 0 ] ], base[ indices[ 1 ] ], base[ indices[ 2 ] ], base[ indices[ 3 ] ] );
+}
+
+NOISE_TARGET( "sse4.1" ) inline __m128
+GradCoordSSE41( const float* gradients, __m128i seed, __m128i xPrimed, __m128i yPrimed, __m128i zPrimed, __m128 xd, __m128 yd, __m128 zd )
+{
+    __m128i hash = _mm_xor_si128( _mm_xor_si128( seed, xPrimed ), _mm_xor_si128( yPrimed, zPrimed ) );
+    hash         = _mm_mullo_epi32( hash, _mm_set1_epi32( GridHashMultiply ) );
+    hash         = _mm_xor_si128( hash, _mm_srai_epi32( hash, 15 ) );
+    hash         = _mm_and_si128( hash, _mm_set1_epi32( GridHashMask ) );
+
+    const __m128 xg = GatherSSE41( gradients, hash );
+    const __m128 yg = GatherSSE41( gradients + 1, hash );
+    const __m128 zg = GatherSSE41( gradients + 2, hash );
+
+    return _mm_add_ps( _mm_add_ps( _mm_mul_ps( xd, xg ), _mm_mul_ps( yd, yg ) ), _mm_mul_ps( zd, zg ) );
+}
+
+NOISE_TARGET( "sse4.1" ) inline __m128
+SinglePerlinSSE41( const float* gradients, int seed, __m128 x, __m128 y, __m128 z )
+{
+    __m128i x0 = FastFloorSSE41( x );
+    __m128i y0 = FastFloorSSE41( y );
+    __m128i z0 = FastFloorSSE41( z );
+
+    const __m128 one = _mm_set1_ps( 1 );
+    const __m128 xd0 = _mm_sub_ps( x, _mm_cvtepi32_ps( x0 ) );
+    const __m128 yd0 = _mm_sub_ps( y, _mm_cvtepi32_ps( y0 ) );
+    const __m128 zd0 = _mm_sub_ps( z, _mm_cvtepi32_ps( z0 ) );
+    const __m128 xd1 = _mm_sub_ps( xd0, one );
+    const __m128 yd1 = _mm_sub_ps( yd0, one );
+    const __m128 zd1 = _mm_sub_ps( zd0, one );
+
+    const __m128 xs = InterpQuinticSSE41( xd0 );
+    const __m128 ys = InterpQuinticSSE41( yd0 );
+    const __m128 zs = InterpQuinticSSE41( zd0 );
+
+    x0               = _mm_mullo_epi32( x0, _mm_set1_epi32( GridPrimeX ) );
+    y0               = _mm_mullo_epi32( y0, _mm_set1_epi32( GridPrimeY ) );
+    z0               = _mm_mullo_epi32( z0, _mm_set1_epi32( GridPrimeZ ) );
+    const __m128i x1 = _mm_add_epi32( x0, _mm_set1_epi32( GridPrimeX ) );
+    const __m128i y1 = _mm_add_epi32( y0, _mm_set1_epi32( GridPrimeY ) );
+    const __m128i z1 = _mm_add_epi32( z0, _mm_set1_epi32( GridPrimeZ ) );
+
+    const __m128i seeds = _mm_set1_epi32( seed );
+
+    const __m128 xf00 = LerpSSE41( GradCoordSSE41( gradients, seeds, x0, y0, z0, xd0, yd0, zd0 ), GradCoordSSE41( gradients, seeds, x1, y0, z0, xd1, yd0, zd0 ), xs );
+    const __m128 xf10 = LerpSSE41( GradCoordSSE41( gradients, seeds, x0, y1, z0, xd0, yd1, zd0 ), GradCoordSSE41( gradients, seeds, x1, y1, z0, xd1, yd1, zd0 ), xs );
+    const __m128 xf01 = LerpSSE41( GradCoordSSE41( gradients, seeds, x0, y0, z1, xd0, yd0, zd1 ), GradCoordSSE41( gradients, seeds, x1, y0, z1, xd1, yd0, zd1 ), xs );
+    const __m128 xf11 = LerpSSE41( GradCoordSSE41( gradients, seeds, x0, y1, z1, xd0, yd1, zd1 ), GradCoordSSE41( gradients, seeds, x1, y1, z1, xd1, yd1, zd1 ), xs );
+
+    const __m128 yf0 = LerpSSE41( xf00, xf10, ys );
+    const __m128 yf1 = LerpSSE41( xf01, xf11, ys );
+
+    return _mm_mul_ps( LerpSSE41( yf0, yf1, zs ), _mm_set1_ps( GridPerlinScale ) );
+}
+
+// Return number of element filled, always multiple of 4
+NOISE_TARGET( "sse4.1" ) int32_t
+FillRowSSE41( const GridParameter& parameter, float* output, int32_t x, int32_t y, int32_t z, int32_t count )
+{
+    const __m128  frequency = _mm_set1_ps( parameter.frequency );
+    const __m128i laneIndex = _mm_setr_epi32( 0, 1, 2, 3 );
+    const __m128  yf        = _mm_mul_ps( _mm_set1_ps( (float) y ), frequency );
+    const __m128  zf        = _mm_mul_ps( _mm_set1_ps( (float) z ), frequency );
+
+    int32_t filled = 0;
+    for ( ; filled + 4 <= count; filled += 4 )
+    {
+        __m128 xs = _mm_cvtepi32_ps( _mm_add_epi32( _mm_set1_epi32( x + filled ), laneIndex ) );
+        __m128 ys = yf;
+        __m128 zs = zf;
+        xs        = _mm_mul_ps( xs, frequency );
+
+        if ( !parameter.fractal )
+        {
+            _mm_storeu_ps( output + filled, SinglePerlinSSE41( parameter.gradients, parameter.seed, xs, ys, zs ) );
+            continue;
+        }
+
+        int    seed = parameter.seed;
+        __m128 sum  = _mm_setzero_ps( );
+        __m128 amp  = _mm_set1_ps( parameter.fractalBounding );
+
+        for ( int i = 0; i < parameter.octaves; i++ )
+        {
+            const __m128 noise = SinglePerlinSSE41( parameter.gradients, seed++, xs, ys, zs );
+            sum                = _mm_add_ps( sum, _mm_mul_ps( noise, amp ) );
+            amp                = _mm_mul_ps( amp, LerpSSE41( _mm_set1_ps( 1 ), _mm_mul_ps( _mm_add_ps( noise, _mm_set1_ps( 1 ) ), _mm_set1_ps( 0.5f ) ), _mm_set1_ps( parameter.weightedStrength ) ) );
+
+            xs  = _mm_mul_ps( xs, _mm_set1_ps( parameter.lacunarity ) );
+            ys  = _mm_mul_ps( ys, _mm_set1_ps( parameter.lacunarity ) );
+            zs  = _mm_mul_ps( zs, _mm_set1_ps( parameter.lacunarity ) );
+            amp = _mm_mul_ps( amp, _mm_set1_ps( parameter.gain ) );
+        }
+
+        _mm_storeu_ps( output + filled, sum );
+    }
+
+    return filled;
+}
+
+#endif
+}   // namespace
+
+MinecraftNoise::GridInstructionSet
+MinecraftNoise::GetSupportedGridInstructionSet( )
+{
+#if MINECRAFT_NOISE_X86
+
+    static const GridInstructionSet supported = [] {
+#    if defined( _MSC_VER ) && !defined( __clang__ )
+        int info[ 4 ];
+        __cpuid( info, 0 );
+        const int maxLeaf = info[ 0 ];
+
+        __cpuid( info, 1 );
+        const bool sse41 = info[ 2 ] & ( 1 << 19 );
+        const bool osAVX = ( info[ 2 ] & ( 1 << 27 ) ) && ( info[ 2 ] & ( 1 << 28 ) ) && ( _xgetbv( 0 ) & 6 ) == 6;
+
+        bool avx2 = false;
+        if ( maxLeaf >= 7 )
+        {
+            __cpuidex( info, 7, 0 );
+            avx2 = osAVX && ( info[ 1 ] & ( 1 << 5 ) );
+        }
+#    else
+        __builtin_cpu_init( );
+        const bool sse41 = __builtin_cpu_supports( "sse4.1" );
+        const bool avx2  = __builtin_cpu_supports( "avx2" );
+#    endif
+
+        return avx2 ? eAVX2 : ( sse41 ? eSSE41 : eScalar );
+    }( );
+
+    return supported;
+
+#else
+
+    return eScalar;
+
+#endif
+}
+
+void
+MinecraftNoise::FillNoiseGrid( float* output, int32_t originX, int32_t originY, int32_t originZ, int32_t sizeX, int32_t sizeY, int32_t sizeZ, GridInstructionSet instructionSet ) const
+{
+    static_assert( GridPrimeX == PrimeX && GridPrimeY == PrimeY && GridPrimeZ == PrimeZ );
+
+    // Ridged and PingPong are not vectorized, domain warp fractal types behave like no fractal in GetNoise
+    const bool vectorizable = mNoiseType == NoiseType_Perlin && mTransformType3D == TransformType3D_None && mFractalType != FractalType_Ridged && mFractalType != FractalType_PingPong;
+
+    instructionSet = vectorizable ? std::min( instructionSet, GetSupportedGridInstructionSet( ) ) : eScalar;
+
+    const GridParameter parameter {
+        .seed             = mSeed,
+        .octaves          = mOctaves,
+        .fractal          = mFractalType == FractalType_FBm,
+        .frequency        = mFrequency,
+        .lacunarity       = mLacunarity,
+        .gain             = mGain,
+        .weightedStrength = mWeightedStrength,
+        .fractalBounding  = mFractalBounding,
+        .gradients        = Lookup<float>::Gradients3D };
+
+    for ( int32_t y = 0; y < sizeY; ++y )
+        for ( int32_t z = 0; z < sizeZ; ++z, output += sizeX )
+        {
+            int32_t x = 0;
+
+#if MINECRAFT_NOISE_X86
+
+            switch ( instructionSet )
+            {
+            case eAVX2:
+                x = FillRowAVX2( parameter, output, originX, originY + y, originZ + z, sizeX );
+                break;
+            case eSSE41:
+                x = FillRowSSE41( parameter, output, originX, originY + y, originZ + z, sizeX );
+                break;
+            case eScalar:
+                break;
+            }
+
+#else
+
+            (void) parameter;
+
+#endif
+
+            // remainder
+            for ( ; x < sizeX; ++x )
+                output[ x ] = GetNoiseInt( originX + x, originY + y, originZ + z );
+        }
+}
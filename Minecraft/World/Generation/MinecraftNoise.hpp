@@ -8,6 +8,7 @@
 #include <Include/Noise/FastNoiseLite.hpp>
 #include <Utility/Singleton.hpp>
 
+#include <cstdint>
 #include <iostream>
 #include <memory>
 
@@ -59,6 +60,26 @@ public:
         return *this;
     }
 
+    enum GridInstructionSet : uint8_t {
+        eScalar,
+        eSSE41,
+        eAVX2
+    };
+
+    // Widest instruction set usable by FillNoiseGrid on this cpu
+    [[nodiscard]] static GridInstructionSet GetSupportedGridInstructionSet( );
+
+    /*
+     *
+     * Noise of a sizeX * sizeY * sizeZ grid of integer coordinates starting at origin, output is indexed by [ y ][ z ][ x ]
+     *
+     * Perlin with no fractal or FBm is vectorized along x, output is bit identical to GetNoiseInt
+     * Other settings fall back to GetNoiseInt
+     *
+     * */
+    void FillNoiseGrid( float* output, int32_t originX, int32_t originY, int32_t originZ, int32_t sizeX, int32_t sizeY, int32_t sizeZ,
+                        GridInstructionSet instructionSet = GetSupportedGridInstructionSet( ) ) const;
+
     inline constexpr auto& GetSeed( ) const { return m_Seed; }
     inline constexpr auto  CopySeed( ) const { return m_Seed.seed; }
     inline constexpr void  SetSeed( std::pair<uint64_t, uint64_t>&& seed ) { m_Seed.seed = seed; }
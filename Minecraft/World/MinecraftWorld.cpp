@@ -6,6 +6,7 @@
 
 #include <Minecraft/Internet/MinecraftServer/MinecraftServer.hpp>
 #include <Minecraft/World/Chunk/ChunkPool.hpp>
+#include <Utility/Thread/EpochReclamation.hpp>
 
 #include <Include/GlobalConfig.hpp>
 #include <random>
@@ -13,30 +14,40 @@
 MinecraftWorld::~MinecraftWorld( ) = default;
 MinecraftWorld::MinecraftWorld( )
 {
-    Logger ::getInstance( ).LogLine( "Using \"random\" seed" );
-    std::random_device                      rd;
-    std::mt19937_64                         gen( rd( ) );
-    std::uniform_int_distribution<uint64_t> dis;
-
-    m_WorldTerrainNoise = std::make_unique<MinecraftNoise>( std::pair<uint64_t, uint64_t> { dis( gen ), dis( gen ) } );
-    m_WorldTerrainNoise->SetNoiseType( Noise::FastNoiseLite::NoiseType_Perlin );
-    m_WorldTerrainNoise->SetFractalType( Noise::FastNoiseLite::FractalType_FBm );
-    m_WorldTerrainNoise->SetFractalLacunarity( 2.5f );
-    m_WorldTerrainNoise->SetFractalGain( 0.32f );
-
-    m_WorldTerrainNoise->SetFractalOctaves( 8 );
+    uint64_t    seed;
+    const auto& seedConfig = GlobalConfig::getMinecraftConfigData( )[ "seed" ];
+    if ( seedConfig.is_number_integer( ) )
+    {
+        seed = seedConfig.get<uint64_t>( );
+        Logger ::getInstance( ).LogLine( "Using seed", seed );
+    } else
+    {
+        std::random_device rd;
+        seed = ( static_cast<uint64_t>( rd( ) ) << 32 ) | rd( );
+        Logger ::getInstance( ).LogLine( "Using \"random\" seed", seed );
+    }
 
-    m_BedRockNoise = std::make_unique<MinecraftNoise>( std::pair<uint64_t, uint64_t> { dis( gen ), dis( gen ) } );
-    m_BedRockNoise->SetFrequency( 16 );
-    m_BedRockNoise->SetFractalOctaves( 1 );
+    SetSeed( seed );
 
     m_TerrainNoiseOffsetPerLevel = std::make_unique<float[]>( ChunkMaxHeight );
     for ( int i = 0; i < ChunkMaxHeight; ++i )
         m_TerrainNoiseOffsetPerLevel[ i ] = 0;
 
-    m_ChunkPool         = std::make_unique<ChunkPool>( this, GlobalConfig::getMinecraftConfigData( )[ "chunk" ][ "loading_thread" ].get<int>( ) );
+    auto& chunkConfig = GlobalConfig::getMinecraftConfigData( )[ "chunk" ];
+
+    uint32_t remeshThread      = DefaultChunkRemeshThread;
+    uint32_t remeshFrameBudget = DefaultChunkRemeshFrameBudget;
+    uint32_t meshCacheSections = DefaultChunkMeshCacheSections;
+    if ( chunkConfig[ "remesh_thread" ].is_number_unsigned( ) ) remeshThread = chunkConfig[ "remesh_thread" ].get<uint32_t>( );
+    if ( chunkConfig[ "remesh_per_frame" ].is_number_unsigned( ) ) remeshFrameBudget = chunkConfig[ "remesh_per_frame" ].get<uint32_t>( );
+    if ( chunkConfig[ "mesh_cache_sections" ].is_number_unsigned( ) ) meshCacheSections = chunkConfig[ "mesh_cache_sections" ].get<uint32_t>( );
+
+    m_ChunkPool         = std::make_unique<ChunkPool>( this, chunkConfig[ "loading_thread" ].get<int>( ), remeshThread, remeshFrameBudget, meshCacheSections );
     m_ChunkLoadingRange = GlobalConfig::getMinecraftConfigData( )[ "chunk" ][ "chunk_loading_range" ].get<CoordinateType>( );
 
+    const auto& samplingConfig = GlobalConfig::getMinecraftConfigData( )[ "chunk" ][ "terrain_sampling" ];
+    if ( samplingConfig.is_string( ) && samplingConfig.get<std::string>( ) == "sparse" ) m_TerrainSampling = eSparseTerrainSampling;
+
     std::array<int32_t, ChunkStatusSize> statusValidRange;
     statusValidRange[ eEmpty ]   = -1;
     statusValidRange[ eFeature ] = m_ChunkLoadingRange;
@@ -50,6 +61,28 @@ MinecraftWorld::MinecraftWorld( )
     m_ChunkPool->StartThread( );
 }
 
+void
+MinecraftWorld::SetSeed( uint64_t seed )
+{
+    // mt19937_64 output is fully specified by the standard, same seed give same noise on every platform
+    std::mt19937_64 gen( seed );
+
+    const auto terrainSeed = std::pair<uint64_t, uint64_t> { gen( ), gen( ) };
+    const auto bedRockSeed = std::pair<uint64_t, uint64_t> { gen( ), gen( ) };
+
+    m_WorldTerrainNoise = std::make_unique<MinecraftNoise>( terrainSeed );
+    m_WorldTerrainNoise->SetNoiseType( Noise::FastNoiseLite::NoiseType_Perlin );
+    m_WorldTerrainNoise->SetFractalType( Noise::FastNoiseLite::FractalType_FBm );
+    m_WorldTerrainNoise->SetFractalLacunarity( 2.5f );
+    m_WorldTerrainNoise->SetFractalGain( 0.32f );
+
+    m_WorldTerrainNoise->SetFractalOctaves( 8 );
+
+    m_BedRockNoise = std::make_unique<MinecraftNoise>( bedRockSeed );
+    m_BedRockNoise->SetFrequency( 16 );
+    m_BedRockNoise->SetFractalOctaves( 1 );
+}
+
 void
 MinecraftWorld::IntroduceChunkInRange( const ChunkCoordinate& centre, int32_t radius )
 {
@@ -64,6 +97,9 @@ MinecraftWorld::Tick( float deltaTime )
 {
     Tickable::Tick( deltaTime );
 
+    // meshes requested since the last tick
+    m_ChunkPool->GetRemeshQueue( ).Dispatch( );
+
     m_TimeSinceChunkLoad += deltaTime;
     if ( m_TimeSinceChunkLoad > 0.2f )
     {
@@ -92,24 +128,25 @@ MinecraftWorld::CleanChunk( )
     m_ChunkPool->Clean( );
 }
 
-Block*
+std::optional<Block>
 MinecraftWorld::GetBlock( const BlockCoordinate& blockCoordinate )
 {
-    if ( GetMinecraftY( blockCoordinate ) < 0 ) return nullptr;
+    if ( GetMinecraftY( blockCoordinate ) < 0 ) return std::nullopt;
 
-    if ( auto chunkCache = GetCompleteChunkCache( BlockToChunkWorldCoordinate( blockCoordinate ) );
+    EpochGuard epochGuard;
+    if ( auto* chunkCache = GetCompleteChunkCache( BlockToChunkWorldCoordinate( blockCoordinate ) );
          chunkCache != nullptr )
     {
         return chunkCache->GetBlock( BlockToChunkRelativeCoordinate( blockCoordinate ) );
     }
 
-    return nullptr;
+    return std::nullopt;
 }
 
-std::shared_ptr<ChunkTy>
+ChunkTy*
 MinecraftWorld::GetCompleteChunkCache( const ChunkCoordinate& chunkCoordinate )
 {
-    if ( auto chunkCache = GetChunkCacheUnsafe( chunkCoordinate ); chunkCache != nullptr )
+    if ( auto* chunkCache = GetChunkCacheSafe( chunkCoordinate ); chunkCache != nullptr )
     {
         if ( chunkCache->initialized && chunkCache->IsChunkStatusAtLeast( ChunkStatus::eFull ) )
         {
@@ -117,16 +154,16 @@ MinecraftWorld::GetCompleteChunkCache( const ChunkCoordinate& chunkCoordinate )
         }
     }
 
-    return { };
+    return nullptr;
 }
 
-std::shared_ptr<ChunkTy>
+ChunkTy*
 MinecraftWorld::GetChunkCacheSafe( const ChunkCoordinate& chunkCoordinate )
 {
     return m_ChunkPool->GetChunkCacheSafe( chunkCoordinate );
 }
 
-std::shared_ptr<ChunkTy>
+ChunkTy*
 MinecraftWorld::GetChunkCacheUnsafe( const ChunkCoordinate& chunkCoordinate )
 {
     return m_ChunkPool->GetChunkCacheUnsafe( chunkCoordinate );
@@ -137,15 +174,13 @@ MinecraftWorld::SetBlock( const BlockCoordinate& blockCoordinate, const Block& b
 {
     if ( GetMinecraftY( blockCoordinate ) < 0 ) return false;
 
-    if ( auto chunkCache = GetChunkCacheUnsafe( MakeMinecraftChunkCoordinate( ScaleToSecond<SectionUnitLength, 1>( GetMinecraftX( blockCoordinate ) ),
-                                                                              ScaleToSecond<SectionUnitLength, 1>( GetMinecraftZ( blockCoordinate ) ) ) );
+    EpochGuard epochGuard;
+    if ( auto* chunkCache = GetChunkCacheSafe( MakeMinecraftChunkCoordinate( ScaleToSecond<SectionUnitLength, 1>( GetMinecraftX( blockCoordinate ) ),
+                                                                             ScaleToSecond<SectionUnitLength, 1>( GetMinecraftZ( blockCoordinate ) ) ) );
          chunkCache != nullptr )
     {
-        if ( chunkCache->initialized && chunkCache->SetBlock( BlockToChunkRelativeCoordinate( blockCoordinate ), block ) )
-        {
-            chunkCache->GenerateRenderBuffer( );
-            return true;
-        }
+        // remeshed by the remesh queue
+        if ( chunkCache->initialized && chunkCache->SetBlock( BlockToChunkRelativeCoordinate( blockCoordinate ), block ) ) return true;
     }
 
     return false;
@@ -14,10 +14,24 @@
 #include <Minecraft/util/Tickable.hpp>
 
 #include <memory>
+#include <optional>
 
 class ChunkPool;
 class MinecraftWorld : public Tickable
 {
+public:
+    /*
+     *
+     * Full evaluate terrain noise for every block
+     * Sparse evaluate on a 4x8x4 block lattice and interpolate trilinearly, see WorldChunk::FillTerrain
+     *
+     * */
+    enum TerrainSampling : uint8_t {
+        eFullTerrainSampling,
+        eSparseTerrainSampling
+    };
+
+private:
     std::unique_ptr<float[]>        m_TerrainNoiseOffsetPerLevel;
     std::unique_ptr<MinecraftNoise> m_WorldTerrainNoise;
     std::unique_ptr<MinecraftNoise> m_BedRockNoise;
@@ -29,7 +43,8 @@ class MinecraftWorld : public Tickable
      * Config
      *
      * */
-    CoordinateType m_ChunkLoadingRange { };
+    CoordinateType  m_ChunkLoadingRange { };
+    TerrainSampling m_TerrainSampling = eFullTerrainSampling;
 
     float m_TimeSinceChunkLoad { };
 
@@ -37,6 +52,13 @@ public:
     MinecraftWorld( );
     ~MinecraftWorld( );
 
+    /*
+     *
+     * Recreate terrain and bedrock noise, only affects chunks generated afterward
+     *
+     * */
+    void SetSeed( uint64_t seed );
+
     void IntroduceChunkInRange( const ChunkCoordinate& centre, int32_t radius );
     void IntroduceChunk( const ChunkCoordinate& position, ChunkStatus minimumStatus );
 
@@ -51,6 +73,9 @@ public:
 
     void SetTerrainNoiseOffset( std::unique_ptr<float[]>&& data ) { m_TerrainNoiseOffsetPerLevel = std::move( data ); }
 
+    // Only affects chunks generated afterward
+    void SetTerrainSampling( TerrainSampling sampling ) { m_TerrainSampling = sampling; }
+
     auto& GetModifiableTerrainNoise( ) { return *m_WorldTerrainNoise; }
 
     /*
@@ -67,15 +92,17 @@ public:
      * */
     static inline ChunkCoordinate BlockToChunkWorldCoordinate( const BlockCoordinate& blockCoordinate ) { return MakeMinecraftChunkCoordinate( ScaleToSecond<SectionUnitLength, 1>( GetMinecraftX( blockCoordinate ) ), ScaleToSecond<SectionUnitLength, 1>( GetMinecraftZ( blockCoordinate ) ) ); }
     static inline BlockCoordinate BlockToChunkRelativeCoordinate( const BlockCoordinate& blockCoordinate ) { return MakeMinecraftCoordinate( GetMinecraftX( blockCoordinate ) & ( SectionUnitLength - 1 ), GetMinecraftY( blockCoordinate ), GetMinecraftZ( blockCoordinate ) & ( SectionUnitLength - 1 ) ); }
-    std::shared_ptr<ChunkTy>      GetCompleteChunkCache( const ChunkCoordinate& chunkCoordinate );
-    std::shared_ptr<ChunkTy>      GetChunkCacheSafe( const ChunkCoordinate& chunkCoordinate );
-    std::shared_ptr<ChunkTy>      GetChunkCacheUnsafe( const ChunkCoordinate& chunkCoordinate );
-    Block*                        GetBlock( const BlockCoordinate& blockCoordinate );
+    // Chunks returned are only valid inside an EpochGuard, see ChunkPool
+    ChunkTy*                      GetCompleteChunkCache( const ChunkCoordinate& chunkCoordinate );
+    ChunkTy*                      GetChunkCacheSafe( const ChunkCoordinate& chunkCoordinate );
+    ChunkTy*                      GetChunkCacheUnsafe( const ChunkCoordinate& chunkCoordinate );
+    std::optional<Block>          GetBlock( const BlockCoordinate& blockCoordinate );
     bool                          SetBlock( const BlockCoordinate& blockCoordinate, const Block& block );
 
     [[nodiscard]] const auto& GetBedRockNoise( ) const { return m_BedRockNoise; }
     [[nodiscard]] const auto& GetTerrainNoise( ) const { return m_WorldTerrainNoise; }
     [[nodiscard]] const auto* GetTerrainNoiseOffset( ) const { return m_TerrainNoiseOffsetPerLevel.get( ); }
+    [[nodiscard]] auto        GetTerrainSampling( ) const { return m_TerrainSampling; }
     ChunkPool&                GetChunkPool( ) { return *m_ChunkPool; }
 };
 
@@ -7,6 +7,7 @@
 
 #include <Minecraft/World/Chunk/WorldChunk.hpp>
 #include <Minecraft/World/MinecraftWorld.hpp>
+#include <Utility/Thread/EpochReclamation.hpp>
 #include <Utility/Timer.hpp>
 
 #include "RaycastType.hpp"
@@ -113,8 +114,11 @@ public:
         auto chunkCoordinate = MinecraftWorld::BlockToChunkWorldCoordinate( currentCoordinate );
         chunkCoordinate      = chunkCoordinate + ChunkCoordinate { 1, 0 };   // so that the first loop will always initialize "currentChunk" bellow
 
-        std::shared_ptr<ChunkTy> currentChunk;
-        Block*                   blockPtr;
+        // one guard for the whole ray, chunks crossed are not reference counted
+        EpochGuard epochGuard;
+
+        ChunkTy*             currentChunk = nullptr;
+        std::optional<Block> block;
         while ( true )
         {
             if constexpr ( LogPath ) pathLog.AddCoordinate( currentCoordinate );
@@ -133,8 +137,8 @@ public:
             {
                 if ( GetMinecraftY( currentCoordinate ) >= 0 && GetMinecraftY( currentCoordinate ) < ChunkMaxHeight )
                 {
-                    blockPtr = currentChunk->GetBlock( MinecraftWorld::BlockToChunkRelativeCoordinate( currentCoordinate ) );
-                    if ( !blockPtr->Transparent( ) )   // Hit
+                    block = currentChunk->GetBlock( MinecraftWorld::BlockToChunkRelativeCoordinate( currentCoordinate ) );
+                    if ( !block->Transparent( ) )   // Hit
                         break;
                 }
             }
@@ -111,6 +111,13 @@ static constexpr CoordinateType WorldChunkEffectiveRange      = StructureReferen
 static constexpr uint32_t ChunkThreadDelayPeriod = 100;
 static constexpr uint32_t ChunkAccessCacheSize   = 8;
 
+// Remesh workers and chunks handed to them per frame, unless set in config
+static constexpr uint32_t DefaultChunkRemeshThread      = 2;
+static constexpr uint32_t DefaultChunkRemeshFrameBudget = 32;
+
+// Sections of recently edited chunks with their mesh data kept, about 88 KiB each, unless set in config
+static constexpr uint32_t DefaultChunkMeshCacheSections = 64;
+
 /*
  *
  * Memory
@@ -121,10 +128,20 @@ static constexpr auto FaceIndicesCount  = 6;
 
 using IndexBufferType = uint32_t;
 
+// Every visible face sits on its own solid / transparent block boundary, at most 3 per block plus the chunk border
+static constexpr uint32_t MaxQuadPerDraw = ChunkVolume * 4;
+
 static constexpr uint32_t MaxMemoryAllocation = 128 * 1024 * 1024;
-static constexpr uint32_t OptimalBufferGap    = 1024 * 1024;
 
-static constexpr uint32_t IndirectDrawBufferSizeStep = 20 * 1024;
+// Per frame uniforms and changed draw commands, reused once the frame's fence signaled
+static constexpr uint32_t FrameStagingRingSize = 8 * 1024 * 1024;
+
+// Mesh uploads larger than what is left in the ring get their own staging buffer
+static constexpr uint32_t UploadStagingRingSize = 32 * 1024 * 1024;
+
+// Mesh bytes moved by compaction each frame, and free space the other buffers keep after a buffer is evacuated
+static constexpr uint32_t ChunkCompactionBytesPerFrame = 4 * 1024 * 1024;
+static constexpr uint32_t ChunkCompactionHeadroom      = MaxMemoryAllocation / 4;
 
 /*
  *
@@ -11,7 +11,10 @@ layout(location = 0) out vec4 outColor;
 
 layout(binding = 1) uniform sampler2D texSampler;
 
-const float textureResolution = 16;
+// VulkanPipeline::PushConstants, resolution of the loaded texture pack
+layout(push_constant) uniform PushConstants {
+    float textureResolution;
+} pushConstants;
 
 void main() {
 
@@ -22,6 +25,6 @@ void main() {
         colorModifier *= sin(time * 3) * 0.3 + 0.7;
     }
 
-    outColor = textureLod(texSampler, mod(accumulatedfragTexCoord, textureResolution) + fragTexCoordBegin, 0) * colorModifier;
+    outColor = textureLod(texSampler, mod(accumulatedfragTexCoord, pushConstants.textureResolution) + fragTexCoordBegin, 0) * colorModifier;
     outColor = mix(vec4(13.0 / 256, 129.0 / 256, 168.0 / 256, 0.5), outColor, visibility);
 }
\ No newline at end of file
@@ -7,9 +7,13 @@ layout(location = 3) out float visibility;
 layout(location = 4) out float colorIntensity;
 layout(location = 5) out float time;
 
-layout(location = 0) in ivec3 inPosition;
-layout(location = 1) in vec3 inCoor_ColorIntensity;
-layout(location = 2) in vec2 accumulatedTextureCoordinate;
+// DataType::PackedChunkVertex
+// x: position x:5 y:9 z:5, face:3, ambient occlusion:2, atlas x:8
+// y: atlas y:8, accumulated u:9 v:9
+layout(location = 0) in uvec2 inPackedVertex;
+
+// per draw, one for each chunk
+layout(location = 1) in ivec3 inChunkOrigin;
 
 layout(binding  = 0) uniform UniformBufferObject {
     mat4 view;
@@ -22,15 +26,30 @@ const float fogDistance = 150;
 const float density = 0.05;
 const float gradient = 1.5;
 
+// VulkanPipeline::PushConstants, resolution of the loaded texture pack
+layout(push_constant) uniform PushConstants {
+    float textureResolution;
+} pushConstants;
+
+// same order as CubeDirection
+const vec3 sunDirection = vec3(1, 1, 2);
+const vec3 faceNormals[6] = vec3[](vec3(1, 0, 0), vec3(-1, 0, 0), vec3(0, 0, 1), vec3(0, 0, -1), vec3(0, 1, 0), vec3(0, -1, 0));
+
 void main() {
 
+    const ivec3 inPosition = inChunkOrigin + ivec3(bitfieldExtract(inPackedVertex.x, 0, 5), bitfieldExtract(inPackedVertex.x, 5, 9), bitfieldExtract(inPackedVertex.x, 14, 5));
+    const uint face = bitfieldExtract(inPackedVertex.x, 19, 3);
+    const uint ambientOcclusion = bitfieldExtract(inPackedVertex.x, 22, 2);
+    const uvec2 atlasCell = uvec2(bitfieldExtract(inPackedVertex.x, 24, 8), bitfieldExtract(inPackedVertex.y, 0, 8));
+    const uvec2 accumulatedCoordinate = uvec2(bitfieldExtract(inPackedVertex.y, 8, 9), bitfieldExtract(inPackedVertex.y, 17, 9));
+
     const vec4 positionRelativeToCamera = ubo.view * vec4(inPosition, 1.0);
     gl_Position = ubo.proj * positionRelativeToCamera;
 
-    fragTexCoordBegin = inCoor_ColorIntensity.xy;
-    accumulatedfragTexCoord = accumulatedTextureCoordinate;
+    fragTexCoordBegin = vec2(atlasCell) * pushConstants.textureResolution;
+    accumulatedfragTexCoord = vec2(accumulatedCoordinate) * pushConstants.textureResolution;
     selectionDiff = inPosition - ubo.highlightCoordinate;// highlight selected block
-    colorIntensity = inCoor_ColorIntensity.z;
+    colorIntensity = sqrt(clamp(dot(normalize(sunDirection), faceNormals[face]), 0.1, 1)) * (0.2 + ambientOcclusion / 3.0);
     time = ubo.time;
 
     // not selecting
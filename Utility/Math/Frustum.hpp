@@ -0,0 +1,55 @@
+#ifndef MINECRAFT_VK_UTILITY_MATH_FRUSTUM_HPP
+#define MINECRAFT_VK_UTILITY_MATH_FRUSTUM_HPP
+
+#include <Include/GLM.hpp>
+
+#include <array>
+
+/*
+ *
+ * View frustum as six planes, taken from the rows of projection * view (Gribb-Hartmann)
+ *
+ * Normals point inside and are not normalized, only the sign of the distance is used
+ * Clip space depth is zero to one, same as GLM_FORCE_DEPTH_ZERO_TO_ONE
+ * chunk_cull.comp builds the same planes, keep them in sync
+ *
+ * */
+struct Frustum {
+    enum Plane { eLeft,
+                 eRight,
+                 eBottom,
+                 eTop,
+                 eNear,
+                 eFar,
+                 ePlaneCount };
+
+    std::array<glm::vec4, ePlaneCount> planes { };
+
+    Frustum( ) = default;
+    explicit Frustum( const glm::mat4& viewProjection )
+    {
+        const auto row = [ &viewProjection ]( int i ) { return glm::vec4 { viewProjection[ 0 ][ i ], viewProjection[ 1 ][ i ], viewProjection[ 2 ][ i ], viewProjection[ 3 ][ i ] }; };
+
+        planes[ eLeft ]   = row( 3 ) + row( 0 );
+        planes[ eRight ]  = row( 3 ) - row( 0 );
+        planes[ eBottom ] = row( 3 ) + row( 1 );
+        planes[ eTop ]    = row( 3 ) - row( 1 );
+        planes[ eNear ]   = row( 2 );
+        planes[ eFar ]    = row( 3 ) - row( 2 );
+    }
+
+    // Conservative, boxes near a frustum corner may pass without being visible
+    [[nodiscard]] bool Intersects( const glm::vec3& boxMin, const glm::vec3& boxMax ) const
+    {
+        for ( const auto& plane : planes )
+        {
+            // corner furthest along the normal
+            const glm::vec3 positive { plane.x >= 0 ? boxMax.x : boxMin.x, plane.y >= 0 ? boxMax.y : boxMin.y, plane.z >= 0 ? boxMax.z : boxMin.z };
+            if ( glm::dot( glm::vec3( plane ), positive ) + plane.w < 0 ) return false;
+        }
+
+        return true;
+    }
+};
+
+#endif   // MINECRAFT_VK_UTILITY_MATH_FRUSTUM_HPP
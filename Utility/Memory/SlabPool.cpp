@@ -0,0 +1,94 @@
+#include "SlabPool.hpp"
+
+#include <algorithm>
+#include <new>
+
+namespace
+{
+std::mutex&
+GetRegistryLock( )
+{
+    static std::mutex registryLock;
+    return registryLock;
+}
+
+std::vector<SlabPool*>&
+GetRegistry( )
+{
+    static std::vector<SlabPool*> registry;
+    return registry;
+}
+}   // namespace
+
+SlabPool::SlabPool( std::string name, size_t blockSize, size_t blockAlignment, size_t slabSize )
+    : m_Name( std::move( name ) )
+    , m_BlockAlignment( std::max( blockAlignment, alignof( FreeBlock ) ) )
+{
+    // every block keeps the alignment, and can hold the free list link
+    m_BlockSize     = ( std::max( blockSize, sizeof( FreeBlock ) ) + m_BlockAlignment - 1 ) / m_BlockAlignment * m_BlockAlignment;
+    m_BlocksPerSlab = static_cast<uint32_t>( std::max<size_t>( slabSize / m_BlockSize, 1 ) );
+
+    std::lock_guard lock( GetRegistryLock( ) );
+    GetRegistry( ).push_back( this );
+}
+
+SlabPool::~SlabPool( )
+{
+    {
+        std::lock_guard lock( GetRegistryLock( ) );
+        std::erase( GetRegistry( ), this );
+    }
+
+    assert( m_Statistics.blocksInUse == 0 );
+    for ( auto* slab : m_Slabs )
+        ::operator delete( slab, std::align_val_t( m_BlockAlignment ) );
+}
+
+void
+SlabPool::AllocateSlab( )
+{
+    auto* slab = static_cast<std::byte*>( ::operator new( m_BlockSize * m_BlocksPerSlab, std::align_val_t( m_BlockAlignment ) ) );
+    m_Slabs.push_back( slab );
+
+    // first block of the slab is handed out first
+    for ( uint32_t i = m_BlocksPerSlab; i-- > 0; )
+        m_FreeList = new ( slab + i * m_BlockSize ) FreeBlock { m_FreeList };
+
+    ++m_Statistics.slabAllocations;
+    m_Statistics.blockCapacity += m_BlocksPerSlab;
+}
+
+void*
+SlabPool::Allocate( )
+{
+    std::lock_guard lock( m_PoolLock );
+    if ( m_FreeList == nullptr ) AllocateSlab( );
+
+    auto* block = m_FreeList;
+    m_FreeList  = block->next;
+
+    ++m_Statistics.allocations;
+    m_Statistics.peakBlocksInUse = std::max( m_Statistics.peakBlocksInUse, ++m_Statistics.blocksInUse );
+    return block;
+}
+
+void
+SlabPool::Free( void* block )
+{
+    if ( block == nullptr ) return;
+
+    std::lock_guard lock( m_PoolLock );
+    assert( m_Statistics.blocksInUse > 0 );
+
+    m_FreeList = new ( block ) FreeBlock { m_FreeList };
+
+    ++m_Statistics.frees;
+    --m_Statistics.blocksInUse;
+}
+
+std::vector<SlabPool*>
+SlabPool::GetPools( )
+{
+    std::lock_guard lock( GetRegistryLock( ) );
+    return GetRegistry( );
+}
@@ -0,0 +1,107 @@
+#ifndef MINECRAFT_VK_UTILITY_MEMORY_SLABPOOL_HPP
+#define MINECRAFT_VK_UTILITY_MEMORY_SLABPOOL_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*
+ *
+ * Pool of fixed size blocks, carved from slabs allocated from the system
+ *
+ * Freed blocks go to a free list and are handed out again before any new slab is allocated,
+ * slabs are only released when the pool is destroyed
+ * Thread safe
+ *
+ * */
+class SlabPool
+{
+public:
+    static constexpr size_t DefaultSlabSize = 64 * 1024;
+
+    struct Statistics {
+        uint64_t allocations     = 0;
+        uint64_t frees           = 0;
+        uint64_t slabAllocations = 0;   // the only allocations from the system
+        uint32_t blocksInUse     = 0;
+        uint32_t peakBlocksInUse = 0;
+        uint32_t blockCapacity   = 0;
+    };
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    std::string m_Name;
+    size_t      m_BlockSize;
+    size_t      m_BlockAlignment;
+    uint32_t    m_BlocksPerSlab;
+
+    std::mutex         m_PoolLock;
+    std::vector<void*> m_Slabs;
+    FreeBlock*         m_FreeList = nullptr;
+    Statistics         m_Statistics;
+
+    void AllocateSlab( );
+
+public:
+    SlabPool( std::string name, size_t blockSize, size_t blockAlignment = alignof( std::max_align_t ), size_t slabSize = DefaultSlabSize );
+    ~SlabPool( );
+
+    SlabPool( const SlabPool& )            = delete;
+    SlabPool& operator=( const SlabPool& ) = delete;
+
+    [[nodiscard]] void* Allocate( );
+    void                Free( void* block );
+
+    [[nodiscard]] inline const std::string& GetName( ) const { return m_Name; }
+    [[nodiscard]] inline size_t             GetBlockSize( ) const { return m_BlockSize; }
+    [[nodiscard]] inline size_t             GetBlockAlignment( ) const { return m_BlockAlignment; }
+
+    Statistics GetStatistics( )
+    {
+        std::lock_guard lock( m_PoolLock );
+        return m_Statistics;
+    }
+
+    // Every pool alive, in construction order
+    static std::vector<SlabPool*> GetPools( );
+};
+
+/*
+ *
+ * Array of count objects in a single block of pool
+ *
+ * */
+template <typename T>
+struct SlabPoolDeleter {
+    SlabPool* pool  = nullptr;
+    uint32_t  count = 0;
+
+    void operator( )( T* objects ) const
+    {
+        std::destroy_n( objects, count );
+        pool->Free( objects );
+    }
+};
+
+template <typename T>
+using SlabPoolArray = std::unique_ptr<T[], SlabPoolDeleter<T>>;
+
+template <typename T>
+SlabPoolArray<T>
+MakeSlabPoolArray( SlabPool& pool, uint32_t count )
+{
+    assert( sizeof( T ) * count <= pool.GetBlockSize( ) && alignof( T ) <= pool.GetBlockAlignment( ) );
+
+    auto* objects = static_cast<T*>( pool.Allocate( ) );
+    std::uninitialized_value_construct_n( objects, count );
+    return SlabPoolArray<T>( objects, { &pool, count } );
+}
+
+#endif   // MINECRAFT_VK_UTILITY_MEMORY_SLABPOOL_HPP
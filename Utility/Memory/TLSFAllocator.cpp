@@ -0,0 +1,294 @@
+#include "TLSFAllocator.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+TLSFAllocator::Statistics&
+TLSFAllocator::Statistics::operator+=( const Statistics& other )
+{
+    capacity += other.capacity;
+    usedSize += other.usedSize;
+    freeSize += other.freeSize;
+    largestFreeBlock = std::max( largestFreeBlock, other.largestFreeBlock );
+    allocationCount += other.allocationCount;
+    freeBlockCount += other.freeBlockCount;
+
+    return *this;
+}
+
+TLSFAllocator::TLSFAllocator( uint32_t capacity, uint32_t granularity )
+    : m_Capacity( capacity / granularity * granularity )
+    , m_Granularity( granularity )
+{
+    assert( granularity > 0 && m_Capacity > 0 );
+
+    for ( auto& freeLists : m_FreeLists )
+        freeLists.fill( NullBlock );
+
+    const auto index       = NewBlock( );
+    m_Blocks[ index ].size = m_Capacity;
+    InsertFree( index );
+}
+
+void
+TLSFAllocator::Mapping( uint32_t size, uint32_t& firstLevel, uint32_t& secondLevel )
+{
+    if ( size < SecondLevelCount )
+    {
+        firstLevel  = 0;
+        secondLevel = size;
+        return;
+    }
+
+    const uint32_t log = std::bit_width( size ) - 1;
+    firstLevel         = log - SecondLevelBits + 1;
+    secondLevel        = ( size >> ( log - SecondLevelBits ) ) - SecondLevelCount;
+}
+
+uint32_t
+TLSFAllocator::NewBlock( )
+{
+    if ( m_UnusedBlock == NullBlock )
+    {
+        m_Blocks.emplace_back( );
+        return (uint32_t) m_Blocks.size( ) - 1;
+    }
+
+    const auto index  = m_UnusedBlock;
+    m_UnusedBlock     = m_Blocks[ index ].nextFree;
+    m_Blocks[ index ] = { };
+
+    return index;
+}
+
+void
+TLSFAllocator::DeleteBlock( uint32_t index )
+{
+    m_Blocks[ index ]          = { };
+    m_Blocks[ index ].nextFree = m_UnusedBlock;
+    m_UnusedBlock              = index;
+}
+
+void
+TLSFAllocator::InsertFree( uint32_t index )
+{
+    auto& block = m_Blocks[ index ];
+
+    uint32_t firstLevel, secondLevel;
+    Mapping( block.size, firstLevel, secondLevel );
+
+    auto& head     = m_FreeLists[ firstLevel ][ secondLevel ];
+    block.isFree   = true;
+    block.prevFree = NullBlock;
+    block.nextFree = head;
+    if ( head != NullBlock ) m_Blocks[ head ].prevFree = index;
+    head = index;
+
+    m_FirstLevelBitmap |= 1U << firstLevel;
+    m_SecondLevelBitmaps[ firstLevel ] |= 1U << secondLevel;
+}
+
+void
+TLSFAllocator::RemoveFree( uint32_t index )
+{
+    auto& block = m_Blocks[ index ];
+    assert( block.isFree );
+
+    uint32_t firstLevel, secondLevel;
+    Mapping( block.size, firstLevel, secondLevel );
+
+    if ( block.prevFree != NullBlock ) m_Blocks[ block.prevFree ].nextFree = block.nextFree;
+    if ( block.nextFree != NullBlock ) m_Blocks[ block.nextFree ].prevFree = block.prevFree;
+
+    auto& head = m_FreeLists[ firstLevel ][ secondLevel ];
+    if ( head == index )
+    {
+        head = block.nextFree;
+        if ( head == NullBlock )
+        {
+            m_SecondLevelBitmaps[ firstLevel ] &= ~( 1U << secondLevel );
+            if ( m_SecondLevelBitmaps[ firstLevel ] == 0 ) m_FirstLevelBitmap &= ~( 1U << firstLevel );
+        }
+    }
+
+    block.isFree   = false;
+    block.prevFree = block.nextFree = NullBlock;
+}
+
+void
+TLSFAllocator::Split( uint32_t index, uint32_t size )
+{
+    assert( !m_Blocks[ index ].isFree && m_Blocks[ index ].size >= size );
+    if ( m_Blocks[ index ].size == size ) return;
+
+    // may reallocate m_Blocks, no reference before this
+    const auto restIndex = NewBlock( );
+    auto&      block     = m_Blocks[ index ];
+    auto&      rest      = m_Blocks[ restIndex ];
+
+    rest.offset       = block.offset + size;
+    rest.size         = block.size - size;
+    rest.prevPhysical = index;
+    rest.nextPhysical = block.nextPhysical;
+    if ( rest.nextPhysical != NullBlock ) m_Blocks[ rest.nextPhysical ].prevPhysical = restIndex;
+
+    block.size         = size;
+    block.nextPhysical = restIndex;
+
+    InsertFree( Merge( restIndex ) );
+}
+
+uint32_t
+TLSFAllocator::Merge( uint32_t index )
+{
+    if ( const auto prev = m_Blocks[ index ].prevPhysical; prev != NullBlock && m_Blocks[ prev ].isFree )
+    {
+        RemoveFree( prev );
+
+        m_Blocks[ prev ].size += m_Blocks[ index ].size;
+        m_Blocks[ prev ].nextPhysical = m_Blocks[ index ].nextPhysical;
+        if ( m_Blocks[ prev ].nextPhysical != NullBlock ) m_Blocks[ m_Blocks[ prev ].nextPhysical ].prevPhysical = prev;
+
+        DeleteBlock( index );
+        index = prev;
+    }
+
+    if ( const auto next = m_Blocks[ index ].nextPhysical; next != NullBlock && m_Blocks[ next ].isFree )
+    {
+        RemoveFree( next );
+
+        m_Blocks[ index ].size += m_Blocks[ next ].size;
+        m_Blocks[ index ].nextPhysical = m_Blocks[ next ].nextPhysical;
+        if ( m_Blocks[ index ].nextPhysical != NullBlock ) m_Blocks[ m_Blocks[ index ].nextPhysical ].prevPhysical = index;
+
+        DeleteBlock( next );
+    }
+
+    return index;
+}
+
+uint32_t
+TLSFAllocator::FindFree( uint32_t size ) const
+{
+    if ( size > m_Capacity ) return NullBlock;
+
+    uint32_t firstLevel, secondLevel;
+
+    // round up to the next size class, every block in the found list fits
+    uint64_t searchSize = size;
+    if ( size >= SecondLevelCount ) searchSize += ( 1ULL << ( std::bit_width( size ) - 1 - SecondLevelBits ) ) - 1;
+    if ( searchSize <= m_Capacity )
+    {
+        Mapping( (uint32_t) searchSize, firstLevel, secondLevel );
+
+        uint32_t secondLevelMap = m_SecondLevelBitmaps[ firstLevel ] & ( ~0U << secondLevel );
+        if ( secondLevelMap == 0 )
+        {
+            const uint32_t firstLevelMap = firstLevel + 1 < 32 ? m_FirstLevelBitmap & ( ~0U << ( firstLevel + 1 ) ) : 0;
+            if ( firstLevelMap != 0 )
+            {
+                firstLevel     = std::countr_zero( firstLevelMap );
+                secondLevelMap = m_SecondLevelBitmaps[ firstLevel ];
+            }
+        }
+
+        if ( secondLevelMap != 0 ) return m_FreeLists[ firstLevel ][ std::countr_zero( secondLevelMap ) ];
+    }
+
+    // Larger classes are empty, the head of the exact class may still fit, e.g. a request close to the capacity
+    Mapping( size, firstLevel, secondLevel );
+
+    const auto head = m_FreeLists[ firstLevel ][ secondLevel ];
+    return head != NullBlock && m_Blocks[ head ].size >= size ? head : NullBlock;
+}
+
+uint32_t
+TLSFAllocator::Allocate( uint32_t size )
+{
+    assert( size > 0 );
+    size = AlignSize( size );
+
+    const auto index = FindFree( size );
+    if ( index == NullBlock ) return InvalidOffset;
+
+    RemoveFree( index );
+    Split( index, size );
+
+    m_Allocations.emplace( m_Blocks[ index ].offset, index );
+    m_UsedSize += size;
+
+    return m_Blocks[ index ].offset;
+}
+
+void
+TLSFAllocator::Free( uint32_t offset )
+{
+    const auto allocationIter = m_Allocations.find( offset );
+    assert( allocationIter != m_Allocations.end( ) );
+
+    const auto index = allocationIter->second;
+    m_Allocations.erase( allocationIter );
+    m_UsedSize -= m_Blocks[ index ].size;
+
+    InsertFree( Merge( index ) );
+}
+
+bool
+TLSFAllocator::TryResize( uint32_t offset, uint32_t newSize )
+{
+    const auto allocationIter = m_Allocations.find( offset );
+    assert( allocationIter != m_Allocations.end( ) && newSize > 0 );
+
+    const auto index   = allocationIter->second;
+    const auto oldSize = m_Blocks[ index ].size;
+    newSize            = AlignSize( newSize );
+
+    if ( newSize > oldSize )
+    {
+        const auto next = m_Blocks[ index ].nextPhysical;
+        if ( next == NullBlock || !m_Blocks[ next ].isFree || oldSize + m_Blocks[ next ].size < newSize ) return false;
+
+        RemoveFree( next );
+
+        m_Blocks[ index ].size += m_Blocks[ next ].size;
+        m_Blocks[ index ].nextPhysical = m_Blocks[ next ].nextPhysical;
+        if ( m_Blocks[ index ].nextPhysical != NullBlock ) m_Blocks[ m_Blocks[ index ].nextPhysical ].prevPhysical = index;
+
+        DeleteBlock( next );
+    }
+
+    Split( index, newSize );
+    m_UsedSize = m_UsedSize - oldSize + newSize;
+
+    return true;
+}
+
+uint32_t
+TLSFAllocator::GetAllocationSize( uint32_t offset ) const
+{
+    const auto allocationIter = m_Allocations.find( offset );
+    assert( allocationIter != m_Allocations.end( ) );
+
+    return m_Blocks[ allocationIter->second ].size;
+}
+
+TLSFAllocator::Statistics
+TLSFAllocator::GetStatistics( ) const
+{
+    Statistics statistics;
+    statistics.capacity        = m_Capacity;
+    statistics.usedSize        = m_UsedSize;
+    statistics.allocationCount = (uint32_t) m_Allocations.size( );
+
+    for ( const auto& freeLists : m_FreeLists )
+        for ( auto index : freeLists )
+            for ( ; index != NullBlock; index = m_Blocks[ index ].nextFree )
+            {
+                statistics.freeSize += m_Blocks[ index ].size;
+                statistics.largestFreeBlock = std::max<uint64_t>( statistics.largestFreeBlock, m_Blocks[ index ].size );
+                ++statistics.freeBlockCount;
+            }
+
+    return statistics;
+}
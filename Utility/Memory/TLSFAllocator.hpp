@@ -0,0 +1,104 @@
+#ifndef MINECRAFT_VK_UTILITY_MEMORY_TLSFALLOCATOR_HPP
+#define MINECRAFT_VK_UTILITY_MEMORY_TLSFALLOCATOR_HPP
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/*
+ *
+ * Two level segregated fit allocator over an offset range, no memory is touched
+ *
+ * Free blocks are kept in lists by size class, first level by power of two, second level splits it linearly
+ * Allocate and Free are O(1) apart from the offset lookup, neighbouring free blocks are always merged
+ * Not thread safe
+ *
+ * */
+class TLSFAllocator
+{
+public:
+    static constexpr uint32_t InvalidOffset = ~0U;
+
+    struct Statistics {
+        uint64_t capacity         = 0;
+        uint64_t usedSize         = 0;
+        uint64_t freeSize         = 0;
+        uint64_t largestFreeBlock = 0;
+        uint32_t allocationCount  = 0;
+        uint32_t freeBlockCount   = 0;
+
+        // 0 when all free space is one block, towards 1 the more it is split
+        [[nodiscard]] inline float GetFragmentation( ) const { return freeSize == 0 ? 0 : 1 - (float) largestFreeBlock / freeSize; }
+
+        Statistics& operator+=( const Statistics& other );
+    };
+
+private:
+    static constexpr uint32_t SecondLevelBits  = 4;
+    static constexpr uint32_t SecondLevelCount = 1 << SecondLevelBits;
+    static constexpr uint32_t FirstLevelCount  = 32 - SecondLevelBits + 1;
+
+    static constexpr uint32_t NullBlock = ~0U;
+
+    struct Block {
+        uint32_t offset = 0, size = 0;
+        uint32_t prevPhysical = NullBlock, nextPhysical = NullBlock;
+        uint32_t prevFree = NullBlock, nextFree = NullBlock;   // or next unused block slot
+        bool     isFree = false;
+    };
+
+    uint32_t m_Capacity, m_Granularity;
+
+    std::vector<Block> m_Blocks;
+    uint32_t           m_UnusedBlock = NullBlock;
+
+    uint32_t                                                            m_FirstLevelBitmap = 0;
+    std::array<uint32_t, FirstLevelCount>                               m_SecondLevelBitmaps { };
+    std::array<std::array<uint32_t, SecondLevelCount>, FirstLevelCount> m_FreeLists { };
+
+    // offset to block
+    std::unordered_map<uint32_t, uint32_t> m_Allocations;
+    uint64_t                               m_UsedSize = 0;
+
+    static void Mapping( uint32_t size, uint32_t& firstLevel, uint32_t& secondLevel );
+
+    uint32_t NewBlock( );
+    void     DeleteBlock( uint32_t index );
+
+    void InsertFree( uint32_t index );
+    void RemoveFree( uint32_t index );
+
+    // Cut block to size, the rest becomes a free block
+    void Split( uint32_t index, uint32_t size );
+
+    // Merge with free physical neighbours, returns the merged block
+    uint32_t Merge( uint32_t index );
+
+    [[nodiscard]] uint32_t FindFree( uint32_t size ) const;
+    [[nodiscard]] uint32_t AlignSize( uint32_t size ) const { return ( size + m_Granularity - 1 ) / m_Granularity * m_Granularity; }
+
+public:
+    // Offsets and sizes are multiples of granularity
+    explicit TLSFAllocator( uint32_t capacity, uint32_t granularity = 1 );
+
+    // InvalidOffset if no free block is large enough
+    [[nodiscard]] uint32_t Allocate( uint32_t size );
+    void                   Free( uint32_t offset );
+
+    // Shrink, or grow into the free space right after, the offset never changes
+    [[nodiscard]] bool TryResize( uint32_t offset, uint32_t newSize );
+
+    [[nodiscard]] uint32_t GetAllocationSize( uint32_t offset ) const;
+
+    [[nodiscard]] inline uint32_t GetCapacity( ) const { return m_Capacity; }
+    [[nodiscard]] inline uint64_t GetUsedSize( ) const { return m_UsedSize; }
+    [[nodiscard]] inline uint32_t GetAllocationCount( ) const { return (uint32_t) m_Allocations.size( ); }
+    [[nodiscard]] inline bool     Empty( ) const { return m_Allocations.empty( ); }
+
+    // Walks the free lists, not for every frame
+    [[nodiscard]] Statistics GetStatistics( ) const;
+};
+
+
+#endif   // MINECRAFT_VK_UTILITY_MEMORY_TLSFALLOCATOR_HPP
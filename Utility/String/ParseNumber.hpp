@@ -0,0 +1,27 @@
+#ifndef MINECRAFT_VK_UTILITY_STRING_PARSENUMBER_HPP
+#define MINECRAFT_VK_UTILITY_STRING_PARSENUMBER_HPP
+
+#include <charconv>
+#include <string_view>
+#include <system_error>
+
+/*
+ *
+ * Parse a whole string as a decimal number, for command line arguments
+ * False on an empty string, trailing characters, a value out of range, or a sign the type can not hold
+ * value is left untouched on failure
+ *
+ * */
+template <typename NumberTy>
+inline bool
+ParseNumber( std::string_view argument, NumberTy& value )
+{
+    NumberTy   parsed { };
+    const auto result = std::from_chars( argument.data( ), argument.data( ) + argument.size( ), parsed );
+    if ( result.ec != std::errc( ) || result.ptr != argument.data( ) + argument.size( ) ) return false;
+
+    value = parsed;
+    return true;
+}
+
+#endif   // MINECRAFT_VK_UTILITY_STRING_PARSENUMBER_HPP
@@ -0,0 +1,100 @@
+#include "EpochReclamation.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+struct ThreadRecord {
+    std::atomic<uint64_t> epoch { 0 };   // 0 outside any guard
+    uint32_t              depth = 0;
+};
+
+std::atomic<uint64_t> GlobalEpoch { 1 };
+
+std::mutex&
+GetRegistryLock( )
+{
+    static std::mutex registryLock;
+    return registryLock;
+}
+
+std::vector<ThreadRecord*>&
+GetRegistry( )
+{
+    static std::vector<ThreadRecord*> registry;
+    return registry;
+}
+
+// Registered on the first guard of each thread, removed when the thread exits
+struct RegisteredThreadRecord {
+    ThreadRecord record;
+
+    RegisteredThreadRecord( )
+    {
+        std::lock_guard lock( GetRegistryLock( ) );
+        GetRegistry( ).push_back( &record );
+    }
+
+    ~RegisteredThreadRecord( )
+    {
+        std::lock_guard lock( GetRegistryLock( ) );
+        std::erase( GetRegistry( ), &record );
+    }
+};
+
+ThreadRecord&
+GetThreadRecord( )
+{
+    thread_local RegisteredThreadRecord threadRecord;
+    return threadRecord.record;
+}
+}   // namespace
+
+uint64_t
+EpochReclamation::GetCurrentEpoch( )
+{
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+    return GlobalEpoch.load( std::memory_order_seq_cst );
+}
+
+uint64_t
+EpochReclamation::Advance( )
+{
+    return GlobalEpoch.fetch_add( 1, std::memory_order_seq_cst ) + 1;
+}
+
+uint64_t
+EpochReclamation::GetOldestActiveEpoch( )
+{
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+    uint64_t oldestEpoch = GlobalEpoch.load( std::memory_order_seq_cst );
+
+    std::lock_guard lock( GetRegistryLock( ) );
+    for ( const auto* record : GetRegistry( ) )
+        if ( const auto epoch = record->epoch.load( std::memory_order_seq_cst ); epoch != 0 )
+            oldestEpoch = std::min( oldestEpoch, epoch );
+
+    return oldestEpoch;
+}
+
+EpochGuard::EpochGuard( )
+{
+    auto& record = GetThreadRecord( );
+    if ( record.depth++ != 0 ) return;
+
+    record.epoch.store( GlobalEpoch.load( std::memory_order_seq_cst ), std::memory_order_seq_cst );
+
+    // published before any lookup inside the guard
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+}
+
+EpochGuard::~EpochGuard( )
+{
+    auto& record = GetThreadRecord( );
+    if ( --record.depth != 0 ) return;
+
+    record.epoch.store( 0, std::memory_order_release );
+}
@@ -0,0 +1,40 @@
+#ifndef MINECRAFT_VK_UTILITY_THREAD_EPOCHRECLAMATION_HPP
+#define MINECRAFT_VK_UTILITY_THREAD_EPOCHRECLAMATION_HPP
+
+#include <cstdint>
+
+/*
+ *
+ * Epoch based reclamation
+ *
+ * Readers enter an EpochGuard before looking up objects another thread may unlink, and can use them until the guard ends
+ * The owner unlinks an object, retires it at GetCurrentEpoch( ), and only destroys it once CanReclaim( ) holds
+ * Entering and leaving a guard only touch the thread's own record, nested guards are counted
+ *
+ * */
+class EpochReclamation
+{
+public:
+    // Epoch to retire an object at, must be read after the object is unlinked
+    static uint64_t GetCurrentEpoch( );
+
+    // Called by the reclaiming thread, so guards entered afterward can not see anything retired before
+    static uint64_t Advance( );
+
+    // Smallest epoch a running guard entered at, the current epoch if no guard is running
+    static uint64_t GetOldestActiveEpoch( );
+
+    static inline bool CanReclaim( uint64_t retiredEpoch, uint64_t oldestActiveEpoch ) { return retiredEpoch < oldestActiveEpoch; }
+};
+
+class EpochGuard
+{
+public:
+    EpochGuard( );
+    ~EpochGuard( );
+
+    EpochGuard( const EpochGuard& )            = delete;
+    EpochGuard& operator=( const EpochGuard& ) = delete;
+};
+
+#endif   // MINECRAFT_VK_UTILITY_THREAD_EPOCHRECLAMATION_HPP
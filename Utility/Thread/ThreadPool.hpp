@@ -11,6 +11,13 @@
 
 #include <boost/sort/sort.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <vector>
 
@@ -25,105 +32,216 @@ private:
     ThreadPool& operator=( ThreadPool&& )      = delete;
 
 public:
-    struct ThreadInstance {
-        Context*      context { };
-        std::jthread* thread { };
+    using JobFunction = std::function<void( Context* )>;
 
-        operator Context*( ) const
+private:
+    struct WorkerJob {
+        Context*                           context { };
+        std::shared_ptr<const JobFunction> job { };
+    };
+
+    /*
+     *
+     * Owner pop from the back, other workers steal from the front
+     *
+     * */
+    struct WorkerQueue {
+        std::mutex            lock;
+        std::deque<WorkerJob> jobs;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_WorkerQueues;
+
+    std::mutex                  m_IdleLock;
+    std::condition_variable_any m_IdleCondition;
+
+    // Jobs sitting in worker queues, used to wake up idle workers
+    std::atomic<uint32_t> m_QueuedJobCount = 0;
+
+    // Jobs handed to workers but not yet finished (queued + executing)
+    std::atomic<uint32_t> m_RunningJobCount = 0;
+    uint32_t              m_NextWorkerQueue = 0;
+
+    std::mutex              m_FinishedJobsLock;
+    std::condition_variable m_FinishedJobsCondition;
+    std::vector<Context*>   m_FinishedJobs;
+
+    // Must be the last member, workers have to stop before everything above is destroyed
+    std::vector<std::jthread> m_Workers;
+
+    bool TryPopJob( uint32_t workerIndex, WorkerJob& result )
+    {
         {
-            return context;
+            auto&           ownQueue = *m_WorkerQueues[ workerIndex ];
+            std::lock_guard guard( ownQueue.lock );
+            if ( !ownQueue.jobs.empty( ) )
+            {
+                result = std::move( ownQueue.jobs.back( ) );
+                ownQueue.jobs.pop_back( );
+                --m_QueuedJobCount;
+                return true;
+            }
         }
 
-        ThreadInstance( ) = default;
-        ~ThreadInstance( )
+        for ( uint32_t offset = 1; offset < m_maxThread; ++offset )
         {
-            delete thread;
+            auto&           victimQueue = *m_WorkerQueues[ ( workerIndex + offset ) % m_maxThread ];
+            std::lock_guard guard( victimQueue.lock );
+            if ( !victimQueue.jobs.empty( ) )
+            {
+                result = std::move( victimQueue.jobs.front( ) );
+                victimQueue.jobs.pop_front( );
+                --m_QueuedJobCount;
+                return true;
+            }
         }
 
-        ThreadInstance( const ThreadInstance& )     = delete;
-        ThreadInstance( ThreadInstance&& ) noexcept = default;
+        return false;
+    }
 
-        ThreadInstance& operator=( const ThreadInstance& )     = delete;
-        ThreadInstance& operator=( ThreadInstance&& ) noexcept = default;
-    };
+    template <typename Iter>
+    void DispatchJobs( const JobFunction& Job, Iter begin, Iter end, const JobFunction& OnDispatch )
+    {
+        const auto dispatchCount = static_cast<uint32_t>( std::distance( begin, end ) );
+        if ( dispatchCount == 0 ) return;
 
-    struct ThreadInstanceWrapper {
+        const auto sharedJob = std::make_shared<const JobFunction>( Job );
 
-        std::unique_ptr<ThreadInstance> threadInstance { };
-        bool                            occupied = false;
+        m_RunningJobCount += dispatchCount;
 
-        ThreadInstanceWrapper( ThreadInstance* threadInstancePtr = nullptr )
-            : threadInstance( threadInstancePtr )
-        { }
+        // Counted before the jobs are visible, a worker popping one right away must not wrap the count below 0
+        {
+            std::lock_guard idleGuard( m_IdleLock );
+            m_QueuedJobCount += dispatchCount;
+        }
 
-        operator Context*( ) const
+        for ( ; begin != end; ++begin )
         {
-            return threadInstance->context;
+            if ( OnDispatch ) OnDispatch( *begin );
+
+            auto&           targetQueue = *m_WorkerQueues[ m_NextWorkerQueue ];
+            std::lock_guard queueGuard( targetQueue.lock );
+            targetQueue.jobs.push_back( { *begin, sharedJob } );
+
+            m_NextWorkerQueue = ( m_NextWorkerQueue + 1 ) % m_maxThread;
         }
-    };
+
+        m_IdleCondition.notify_all( );
+    }
+
+    void WorkerLoop( const std::stop_token& st, uint32_t workerIndex )
+    {
+        WorkerJob job;
+        while ( !st.stop_requested( ) )
+        {
+            if ( !TryPopJob( workerIndex, job ) )
+            {
+                std::unique_lock lock( m_IdleLock );
+                m_IdleCondition.wait( lock, st, [ this ] { return m_QueuedJobCount.load( ) != 0; } );
+                continue;
+            }
+
+            ( *job.job )( job.context );
+            job.job.reset( );
+
+            {
+                std::lock_guard guard( m_FinishedJobsLock );
+                m_FinishedJobs.push_back( job.context );
+
+                // Finished list has to be updated before the job count, HasThreadRunning rely on it
+                --m_RunningJobCount;
+            }
+            m_FinishedJobsCondition.notify_all( );
+        }
+    }
 
 protected:
-    std::recursive_mutex               m_PendingThreadsMutex;
-    std::vector<Context*>              m_PendingThreads;
-    std::vector<ThreadInstanceWrapper> m_RunningThreads;
+    std::recursive_mutex  m_PendingThreadsMutex;
+    std::vector<Context*> m_PendingThreads;
 
     uint32_t m_maxThread;
 
     explicit ThreadPool( uint32_t maxThread )
-        : m_maxThread( maxThread )
+        : m_maxThread( std::max( maxThread, 1U ) )
     {
-        m_RunningThreads.resize( m_maxThread );
+        m_WorkerQueues.reserve( m_maxThread );
+        for ( uint32_t i = 0; i < m_maxThread; ++i )
+            m_WorkerQueues.emplace_back( std::make_unique<WorkerQueue>( ) );
+
+        m_Workers.reserve( m_maxThread );
+        for ( uint32_t i = 0; i < m_maxThread; ++i )
+            m_Workers.emplace_back( std::bind_front( &ThreadPool::WorkerLoop, this ), i );
     }
 
-    static void RunJob( ThreadInstanceWrapper& wrapper, const std::function<void( Context* )>& Job )
+    ~ThreadPool( )
     {
-        Job( wrapper.threadInstance->context );
-        wrapper.occupied = false;
+        StopWorkers( );
+    }
+
+    /*
+     *
+     * Jobs already dispatched will not be executed after this
+     *
+     * */
+    void StopWorkers( )
+    {
+        for ( auto& worker : m_Workers )
+            worker.request_stop( );
+        m_IdleCondition.notify_all( );
+        m_Workers.clear( );
     }
 
     [[nodiscard]] inline uint32_t GetRunningThreadCount( ) const
     {
-        uint32_t runningThreadCount = 0;
-        for ( uint32_t i = 0; i < m_maxThread; ++i )
-            if ( m_RunningThreads[ i ].occupied ) runningThreadCount++;
-        return runningThreadCount;
+        return m_RunningJobCount.load( );
     }
 
-    [[nodiscard]] inline bool IsAllThreadCompleted( ) const
+    [[nodiscard]] inline bool IsAllThreadCompleted( )
     {
-        for ( uint32_t i = 0; i < m_maxThread; ++i )
-            if ( m_RunningThreads[ i ].threadInstance != nullptr ) return false;
-        return true;
+        std::lock_guard guard( m_FinishedJobsLock );
+        return m_RunningJobCount.load( ) == 0 && m_FinishedJobs.empty( );
     }
 
     void CleanRunningThread( std::vector<Context*>* finished = nullptr )
     {
-        for ( int i = 0; i < m_RunningThreads.size( ); ++i )
-        {
-            //                Finished
-            if ( m_RunningThreads[ i ].threadInstance != nullptr && !m_RunningThreads[ i ].occupied )
-            {
-                if ( finished ) finished->push_back( m_RunningThreads[ i ].threadInstance->context );
-                m_RunningThreads[ i ].threadInstance.reset( );
-            }
-        }
+        std::lock_guard guard( m_FinishedJobsLock );
+        if ( finished ) finished->insert( finished->end( ), m_FinishedJobs.begin( ), m_FinishedJobs.end( ) );
+        m_FinishedJobs.clear( );
     }
 
-    inline bool HasThreadRunning( )
+    inline bool HasThreadRunning( ) const
     {
-        return std::any_of( m_RunningThreads.begin( ), m_RunningThreads.end( ), []( const ThreadInstanceWrapper& wrapper ) { return wrapper.threadInstance != nullptr && wrapper.occupied; } );
+        return m_RunningJobCount.load( ) != 0;
     }
 
-    void UpdateSortedFull( const std::function<void( Context* )>& Job, const std::function<bool( const Context*, const Context* )>& Comp )
+    /*
+     *
+     * Block until any job finished or timeout, return immediately if there are finished jobs not yet cleaned
+     *
+     * */
+    template <typename Rep, typename Period>
+    bool WaitFinishedJob( const std::chrono::duration<Rep, Period>& timeout )
+    {
+        std::unique_lock lock( m_FinishedJobsLock );
+        return m_FinishedJobsCondition.wait_for( lock, timeout, [ this ] { return !m_FinishedJobs.empty( ); } );
+    }
+
+    void UpdateSortedFull( const JobFunction& Job, const std::function<bool( const Context*, const Context* )>& Comp, const JobFunction& OnDispatch = { } )
     {
         // only run when all ready
         if ( !HasThreadRunning( ) )
         {
-            UpdateSorted( Job, Comp );
+            UpdateSorted( Job, Comp, OnDispatch );
         }
     }
 
-    void UpdateSorted( const std::function<void( Context* )>& Job, const std::function<bool( const Context*, const Context* )>& Comp )
+    /*
+     *
+     * Hand at most one job per idle worker to the pool, keeping the rest pending so later priority changes still apply
+     * OnDispatch is called on the calling thread for every context handed out
+     *
+     * */
+    void UpdateSorted( const JobFunction& Job, const std::function<bool( const Context*, const Context* )>& Comp, const JobFunction& OnDispatch = { } )
     {
         // Let child class clean themselves for more control
         // if ( finishedJob ) finishedJob->clear( );
@@ -131,31 +249,39 @@ protected:
 
         if ( m_PendingThreads.empty( ) ) return;
 
-        uint32_t emptySlot = 0;
-        for ( ; emptySlot < m_maxThread; ++emptySlot )
-            if ( m_RunningThreads[ emptySlot ].threadInstance == nullptr ) break;
+        const auto runningJobs = m_RunningJobCount.load( );
+        if ( runningJobs >= m_maxThread ) return;
 
-        if ( emptySlot != m_maxThread )
-        {
-            std::lock_guard<std::recursive_mutex> guard( m_PendingThreadsMutex );
-            boost::sort::flat_stable_sort( m_PendingThreads.begin( ), m_PendingThreads.end( ), Comp );
+        std::lock_guard<std::recursive_mutex> guard( m_PendingThreadsMutex );
+        boost::sort::flat_stable_sort( m_PendingThreads.begin( ), m_PendingThreads.end( ), Comp );
 
-            int newThreadIndex = 0;
-            for ( ; emptySlot < m_maxThread; ++emptySlot )
-            {
-                if ( m_RunningThreads[ emptySlot ].threadInstance != nullptr ) continue;
-                if ( newThreadIndex == m_PendingThreads.size( ) ) break;
+        const auto dispatchCount = std::min<size_t>( m_maxThread - runningJobs, m_PendingThreads.size( ) );
+        DispatchJobs( Job, m_PendingThreads.begin( ), std::next( m_PendingThreads.begin( ), dispatchCount ), OnDispatch );
 
-                auto* newThread                              = new ThreadInstance;
-                m_RunningThreads[ emptySlot ].threadInstance = std::unique_ptr<ThreadInstance>( newThread );
-                m_RunningThreads[ emptySlot ].occupied       = true;
+        m_PendingThreads.erase( m_PendingThreads.begin( ), std::next( m_PendingThreads.begin( ), dispatchCount ) );
+    }
 
-                newThread->context = m_PendingThreads[ newThreadIndex++ ];
-                newThread->thread  = new std::jthread( &ThreadPool::RunJob, std::ref( m_RunningThreads[ emptySlot ] ), Job );
-            }
+    /*
+     *
+     * Same as UpdateSorted, but the child class own the pending jobs
+     * NextJob return the most prioritized job, or nullptr if there is none
+     *
+     * */
+    void UpdatePrioritized( const JobFunction& Job, const std::function<Context*( )>& NextJob, const JobFunction& OnDispatch = { } )
+    {
+        const auto runningJobs = m_RunningJobCount.load( );
+        if ( runningJobs >= m_maxThread ) return;
 
-            m_PendingThreads.erase( m_PendingThreads.begin( ), std::next( m_PendingThreads.begin( ), newThreadIndex ) );
+        std::vector<Context*> contexts;
+        contexts.reserve( m_maxThread - runningJobs );
+        for ( auto i = runningJobs; i < m_maxThread; ++i )
+        {
+            auto* context = NextJob( );
+            if ( context == nullptr ) break;
+            contexts.push_back( context );
         }
+
+        DispatchJobs( Job, contexts.begin( ), contexts.end( ), OnDispatch );
     }
 
     void AddJobContext( Context* context )
@@ -168,7 +294,7 @@ public:
     inline size_t PoolSize( )
     {
 
-        return m_RunningThreads.size( ) + m_PendingThreads.size( );
+        return m_RunningJobCount.load( ) + m_PendingThreads.size( );
     }
 
     inline size_t GetMaxThread( )
@@ -1,16 +1,49 @@
 #include <Include/GlobalConfig.hpp>
 #include <Minecraft/Application/MainApplication.hpp>
 #include <Utility/Math/Math.hpp>
+#include <Utility/String/ParseNumber.hpp>
 
 #include <iostream>
+#include <string>
+
+namespace
+{
+// command line overrides
+bool
+ParseOption( int argc, char** argv )
+{
+    for ( int i = 1; i < argc; ++i )
+    {
+        const std::string argument = argv[ i ];
+        if ( i + 1 >= argc ) return false;
+
+        if ( argument == "--seed" )
+        {
+            uint64_t seed;
+            if ( !ParseNumber( argv[ ++i ], seed ) ) return false;
+
+            GlobalConfig::getMinecraftConfigData( )[ "seed" ] = seed;
+        } else
+            return false;
+    }
+
+    return true;
+}
+}   // namespace
 
 int
-main( )
+main( int argc, char** argv )
 {
     bool result = GlobalConfig::LoadFromFile( "config.ini" );
     (void) result;
     assert( result );
 
+    if ( !ParseOption( argc, argv ) )
+    {
+        std::cerr << "Usage: " << argv[ 0 ] << " [--seed S]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
     bool success = true;
 
     try